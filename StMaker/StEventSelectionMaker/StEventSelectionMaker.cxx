@@ -0,0 +1,82 @@
+#include "StEventSelectionMaker.h"
+#include "ConfigManager.h"
+#include "cuts/EventCutConfig.h"
+#include "StPicoDstMaker/StPicoDstMaker.h"
+#include "StPicoEvent/StPicoDst.h"
+#include "StPicoEvent/StPicoEvent.h"
+
+#include "TMath.h"
+#include "TVector3.h"
+
+#include <iostream>
+
+//-----------------------------------------------------------------------------
+StEventSelectionMaker::StEventSelectionMaker(const char* name, StPicoDstMaker* picoMaker)
+  : StMaker(name),
+    mPicoDstMaker(picoMaker),
+    mConfig(&ConfigManager::GetInstance().GetContext()),
+    mAccepted(kFALSE),
+    mNEvents(0),
+    mNAccepted(0) {}
+
+//-----------------------------------------------------------------------------
+StEventSelectionMaker::~StEventSelectionMaker() {}
+
+//-----------------------------------------------------------------------------
+StEventSelectionMaker* createStEventSelectionMaker(const char* name, StPicoDstMaker* picoMaker) {
+  return new StEventSelectionMaker(name, picoMaker);
+}
+
+extern "C" void* createStEventSelectionMakerC(const char* name, void* picoMaker) {
+  return (void*)createStEventSelectionMaker(name, (StPicoDstMaker*)picoMaker);
+}
+
+//-----------------------------------------------------------------------------
+Int_t StEventSelectionMaker::Init() {
+  if (!mPicoDstMaker) {
+    std::cerr << "[StEventSelectionMaker] No StPicoDstMaker given." << std::endl;
+    return kStErr;
+  }
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+void StEventSelectionMaker::Clear(Option_t* opt) {
+  mAccepted = kFALSE;
+}
+
+//-----------------------------------------------------------------------------
+Int_t StEventSelectionMaker::Make() {
+  mAccepted = kFALSE;
+  if (!mPicoDstMaker) return kStWarn;
+  StPicoDst* pico = mPicoDstMaker->picoDst();
+  if (!pico) return kStWarn;
+  StPicoEvent* event = pico->event();
+  if (!event) return kStWarn;
+
+  mNEvents++;
+  const EventCutConfig& ev = mConfig->GetEventCuts();
+  if (!mRuns.Pass(mConfig->GetRunQuality(), event->runId(), event->eventId())) return kStOK;
+  if (!mTriggers.Pass(ev.triggers, *event)) return kStOK;
+  TVector3 pVtx = event->primaryVertex();
+  Float_t vz = pVtx.Z();
+  Float_t vr = TMath::Sqrt(pVtx.X() * pVtx.X() + pVtx.Y() * pVtx.Y());
+  Float_t vzVpd = event->vzVpd();
+  Int_t refMult = event->refMult();
+  Int_t nTracks = pico->numberOfTracks();
+
+  if (!ev.Pass(vz, vr, refMult, vzVpd)) return kStOK;
+  if (ev.maxNTr > 0 && nTracks > ev.maxNTr) return kStOK;
+
+  mAccepted = kTRUE;
+  mNAccepted++;
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+Int_t StEventSelectionMaker::Finish() {
+  std::cout << "StEventSelectionMaker::Finish() accepted " << mNAccepted << " / " << mNEvents << " events" << std::endl;
+  mRuns.Print("StEventSelectionMaker::Finish() ");
+  mTriggers.Print(mConfig->GetEventCuts().triggers, "StEventSelectionMaker::Finish() ");
+  return kStOK;
+}
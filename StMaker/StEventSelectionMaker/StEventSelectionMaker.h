@@ -0,0 +1,49 @@
+#ifndef StEventSelectionMaker_h
+#define StEventSelectionMaker_h
+
+#include "StMaker.h"
+#include "TriggerSelection.h"
+#include "RunQuality.h"
+
+class StPicoDstMaker;
+class ConfigContext;
+
+class StEventSelectionMaker;
+
+StEventSelectionMaker* createStEventSelectionMaker(const char* name, StPicoDstMaker* picoMaker);
+extern "C" void* createStEventSelectionMakerC(const char* name, void* picoMaker);
+
+// Shared event selection for a multi-analysis chain: applies the "event" cuts
+// (run quality and trigger selection first, then EventCutConfig) once per event. Analysis makers given this maker via
+// SetEventSelectionMaker() skip the event when IsAccepted() is false instead
+// of applying their own event cuts.
+class StEventSelectionMaker : public StMaker {
+public:
+  StEventSelectionMaker(const char* name, StPicoDstMaker* picoMaker);
+  virtual ~StEventSelectionMaker();
+
+  virtual Int_t Init();
+  virtual Int_t Make();
+  virtual void Clear(Option_t* opt = "");
+  virtual Int_t Finish();
+
+  // Decision for the current event (valid after this maker's Make())
+  Bool_t IsAccepted() const { return mAccepted; }
+
+  Long64_t GetNEvents() const { return mNEvents; }
+  Long64_t GetNAccepted() const { return mNAccepted; }
+
+  // Cuts and main.yaml keys from config instead of ConfigManager's default context
+  void SetConfigContext(const ConfigContext& config) { mConfig = &config; }
+
+private:
+  StPicoDstMaker* mPicoDstMaker;
+  const ConfigContext* mConfig;
+  RunCounts mRuns;
+  TriggerCounts mTriggers;
+  Bool_t mAccepted;
+  Long64_t mNEvents;
+  Long64_t mNAccepted;
+};
+
+#endif
@@ -0,0 +1,283 @@
+#include "StLambda1520Maker.h"
+#include "../StEventSelectionMaker/StEventSelectionMaker.h"
+#include "ConfigManager.h"
+#include "HistManager.h"
+#include "cuts/EventCutConfig.h"
+#include "cuts/TrackCutConfig.h"
+#include "cuts/Lambda1520CutConfig.h"
+#include "StPicoDstMaker/StPicoDstMaker.h"
+#include "StPicoEvent/StPicoDst.h"
+#include "StPicoEvent/StPicoEvent.h"
+
+#include "TFile.h"
+#include "TMath.h"
+#include "TVector3.h"
+
+#include <iostream>
+
+namespace {
+  const Double_t kProtonMass = 0.938272;
+  const Double_t kKaonMass   = 0.493677;
+}
+
+//-----------------------------------------------------------------------------
+// Lambda(1520) -> p K: proton list x kaon list
+struct StLambda1520Maker::ProtonKaonTraits {
+  static Double_t Mass1() { return kProtonMass; }
+  static Double_t Mass2() { return kKaonMass; }
+  static const Bool_t kIdentical = kFALSE;
+};
+
+struct StLambda1520Maker::Hists {
+  typedef HistManager::Handle H;
+  H n, nProton, nKaon;
+  H lambdaMass, lambdaMassVsPt, lambdaRapidity;
+  H antiLambdaMass, antiLambdaMassVsPt, antiLambdaRapidity;
+  H likeSignPPMass, likeSignPPMassVsPt;
+  H likeSignMMMass, likeSignMMMassVsPt;
+
+  Hists() { Resolve(0); }
+
+  void Resolve(HistManager* hm) {
+    n = Get(hm, "hN");
+    nProton = Get(hm, "hNProton");
+    nKaon = Get(hm, "hNKaon");
+    lambdaMass = Get(hm, "hLambda1520_InvMass");
+    lambdaMassVsPt = Get(hm, "hLambda1520_InvMass_vs_Pt");
+    lambdaRapidity = Get(hm, "hLambda1520_Rapidity");
+    antiLambdaMass = Get(hm, "hAntiLambda1520_InvMass");
+    antiLambdaMassVsPt = Get(hm, "hAntiLambda1520_InvMass_vs_Pt");
+    antiLambdaRapidity = Get(hm, "hAntiLambda1520_Rapidity");
+    likeSignPPMass = Get(hm, "hLikeSignPP_InvMass");
+    likeSignPPMassVsPt = Get(hm, "hLikeSignPP_InvMass_vs_Pt");
+    likeSignMMMass = Get(hm, "hLikeSignMM_InvMass");
+    likeSignMMMassVsPt = Get(hm, "hLikeSignMM_InvMass_vs_Pt");
+  }
+
+  static H Get(HistManager* hm, const char* name) { return hm ? hm->GetHandle(name) : 0; }
+};
+
+struct StLambda1520Maker::PKPairPolicy {
+  HistManager* hm;
+  const Hists& h;
+  Double_t minMass, maxMass;
+
+  PKPairPolicy(HistManager* m, const Hists& hists, const Lambda1520CutConfig& cut)
+    : hm(m), h(hists), minMass(cut.minInvMass), maxMass(cut.maxInvMass) {}
+
+  Double_t MinMass() const { return minMass; }
+  Double_t MaxMass() const { return maxMass; }
+  Bool_t Raw(const Daughter_t&, const Daughter_t&, const TwoBody::Pair&) { return kTRUE; }
+  Bool_t Accept(const Daughter_t&, const Daughter_t&, TwoBody::Pair&) { return kTRUE; }
+
+  // Handles resolved in Init(); 0 for histograms not defined or disabled
+  void Fill(const Daughter_t& p, const Daughter_t&, const TwoBody::Pair& pair) {
+    if (!hm) return;
+    HistManager::Handle mass, massVsPt, rapidity = 0;
+    if (pair.sign == 0) {
+      const Bool_t baryon = p.charge > 0;
+      mass = baryon ? h.lambdaMass : h.antiLambdaMass;
+      massVsPt = baryon ? h.lambdaMassVsPt : h.antiLambdaMassVsPt;
+      rapidity = baryon ? h.lambdaRapidity : h.antiLambdaRapidity;
+    } else if (pair.sign > 0) {
+      mass = h.likeSignPPMass;
+      massVsPt = h.likeSignPPMassVsPt;
+    } else {
+      mass = h.likeSignMMMass;
+      massVsPt = h.likeSignMMMassVsPt;
+    }
+    if (mass) hm->Fill(mass, pair.mass);
+    if (massVsPt) hm->Fill(massVsPt, TwoBody::Pt(pair), pair.mass);
+    if (rapidity) hm->Fill(rapidity, TwoBody::Rapidity(pair));
+  }
+};
+
+//-----------------------------------------------------------------------------
+StLambda1520Maker::StLambda1520Maker(const char* name, StPicoDstMaker* picoMaker, const char* outName)
+  : StMaker(name),
+    mPicoDstMaker(picoMaker),
+    mConfig(&ConfigManager::GetInstance().GetContext()),
+    mPicoDst(0),
+    mOutName(outName),
+    mEventCounter(0),
+    m_histManager(0),
+    mTrackViewMaker(0),
+    mEventSelection(0),
+    mHists(new Hists()),
+    mProtons(ArenaAllocator<Daughter_t>(&mArena)),
+    mKaons(ArenaAllocator<Daughter_t>(&mArena)) {}
+
+//-----------------------------------------------------------------------------
+StLambda1520Maker::~StLambda1520Maker() {
+  if (m_histManager) {
+    delete m_histManager;
+    m_histManager = 0;
+  }
+  delete mHists;
+}
+
+//-----------------------------------------------------------------------------
+StLambda1520Maker* createStLambda1520Maker(const char* name, StPicoDstMaker* picoMaker, const char* outName) {
+  return new StLambda1520Maker(name, picoMaker, outName);
+}
+
+extern "C" void* createStLambda1520MakerC(const char* name, void* picoMaker, const char* outName) {
+  return (void*)createStLambda1520Maker(name, (StPicoDstMaker*)picoMaker, outName);
+}
+
+//-----------------------------------------------------------------------------
+Int_t StLambda1520Maker::Init() {
+  mPairTimer.Reset();  // TStopwatch starts on construction
+  const ConfigContext& cm = *mConfig;
+  // Track expression from the cut YAML, parsed once here and evaluated per event
+  const std::string& trackExpr = cm.GetTrackCuts().expression;
+  if (!mTrackExpr.Compile(trackExpr)) {
+    std::cerr << "[StLambda1520Maker] Bad track expression: " << mTrackExpr.GetError() << std::endl;
+    return kStFatal;
+  }
+  if (!mTrackExpr.IsEmpty()) {
+    std::cout << "[StLambda1520Maker] Track expression: " << trackExpr << std::endl;
+  }
+
+  // Per-maker key first, so several makers can share one main.yaml
+  std::string histPath = cm.HasMainConfigKey("hist_lambda1520") ? cm.GetHistConfigPath("hist_lambda1520") : cm.GetHistConfigPath();
+  if (histPath.empty()) {
+    std::cerr << "[StLambda1520Maker] GetHistConfigPath() returned empty; no histograms will be filled." << std::endl;
+    m_histManager = 0;
+    return kStOK;
+  }
+  m_histManager = new HistManager();
+  m_histManager->DisableTags(cm.GetMainConfigValue("hist_skip_tags"));  // e.g. "qa" in production
+  if (!m_histManager->LoadFromFile(histPath.c_str())) {
+    std::cerr << "[StLambda1520Maker] Failed to load hist config from " << histPath << std::endl;
+    delete m_histManager;
+    m_histManager = 0;
+    return kStOK;
+  }
+  mHists->Resolve(m_histManager);
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+void StLambda1520Maker::Clear(Option_t* opt) {
+  ArenaRelease(mProtons);
+  ArenaRelease(mKaons);
+  mArena.Reset();
+}
+
+//-----------------------------------------------------------------------------
+Bool_t StLambda1520Maker::AcceptEvent(const StPicoEvent* event) {
+  if (!event) return kFALSE;
+  if (!mRuns.Pass(mConfig->GetRunQuality(), event->runId(), event->eventId())) return kFALSE;
+  if (!mTriggers.Pass(mConfig->GetEventCuts().triggers, *event)) return kFALSE;
+  return PassEventCuts(event->primaryVertex(), event->refMult(), event->vzVpd());
+}
+
+//-----------------------------------------------------------------------------
+Bool_t StLambda1520Maker::PassEventCuts(const TVector3& pVtx, Int_t refMult, Float_t vzVpd) {
+  Float_t vr = TMath::Sqrt(pVtx.X() * pVtx.X() + pVtx.Y() * pVtx.Y());
+  return mConfig->GetEventCuts().Pass(pVtx.Z(), vr, refMult, vzVpd);
+}
+
+//-----------------------------------------------------------------------------
+Bool_t StLambda1520Maker::PassTrackCuts(const StTrackView& tv, Int_t i) {
+  const TrackCutConfig& tr = mConfig->GetTrackCuts();
+  if (!mTrackExpr.Pass(i)) return kFALSE;
+  if (tv.charge[i] == 0) return kFALSE;
+  if (tv.nHitsFit[i] < tr.minNHitsFit) return kFALSE;
+  if ((Float_t)tv.nHitsFit[i] / (Float_t)tv.nHitsMax[i] < tr.minNHitsRatio) return kFALSE;
+  if (tv.nHitsDedx[i] < tr.minNHitsDedx) return kFALSE;
+  if (tv.chi2[i] > tr.maxChi2) return kFALSE;
+  TVector3 pMom = tv.PMom(i);
+  if (pMom.Mag() < 1e-4) return kFALSE;
+  if (pMom.Perp() < tr.minPt || pMom.Perp() > tr.maxPt) return kFALSE;
+  if (TMath::Abs(pMom.PseudoRapidity()) > tr.maxEta) return kFALSE;
+  return kTRUE;
+}
+
+//-----------------------------------------------------------------------------
+Int_t StLambda1520Maker::Make() {
+  if (!mPicoDstMaker) return kStWarn;
+  mPicoDst = mPicoDstMaker->picoDst();
+  if (!mPicoDst) return kStWarn;
+
+  StPicoEvent* event = mPicoDst->event();
+  if (!event) return kStWarn;
+  if (!mRuns.Pass(mConfig->GetRunQuality(), event->runId(), event->eventId())) return kStOK;
+  if (!mTriggers.Pass(mConfig->GetEventCuts().triggers, *event)) return kStOK;
+
+  mEventCounter++;
+  TVector3 pVtx = event->primaryVertex();
+  if (mEventSelection ? !mEventSelection->IsAccepted() : !PassEventCuts(pVtx, event->refMult(), event->vzVpd())) return kStOK;
+  const Hists& h = *mHists;
+  if (h.n) m_histManager->Fill(h.n, 0);
+
+  const Lambda1520CutConfig& cut = mConfig->GetLambda1520Cuts();
+
+  const StTrackView* view = &mOwnView;
+  if (mTrackViewMaker) {
+    view = &mTrackViewMaker->GetTrackView();
+  } else {
+    mOwnView.Fill(mPicoDst, pVtx, event->bField());
+  }
+  const StTrackView& tv = *view;
+  mTrackExpr.Evaluate(tv);  // all tracks in one pass; PassTrackCuts reads the result
+
+  // Proton and kaon lists, selected once per event; a track may enter both
+  mProtons.reserve(tv.nTracks);
+  mKaons.reserve(tv.nTracks);
+  for (Int_t i = 0; i < tv.nTracks; i++) {
+    if (!PassTrackCuts(tv, i)) continue;
+    Double_t dca = tv.dca[i];
+    Daughter_t d;
+    d.index = i;
+    d.charge = tv.charge[i];
+    d.px = tv.pPx[i];
+    d.py = tv.pPy[i];
+    d.pz = tv.pPz[i];
+    if (TMath::Abs(tv.nSigmaProton[i]) < cut.nSigmaProton && dca < cut.maxDCAProton) mProtons.push_back(d);
+    if (TMath::Abs(tv.nSigmaKaon[i]) < cut.nSigmaKaon && dca < cut.maxDCAKaon) mKaons.push_back(d);
+  }
+  if (h.nProton) m_histManager->Fill(h.nProton, mProtons.size());
+  if (h.nKaon) m_histManager->Fill(h.nKaon, mKaons.size());
+
+  mPairTimer.Start(kFALSE);
+  PKPairPolicy policy(m_histManager, h, cut);
+  if (cut.fillLikeSign) {
+    mPairCounts.Add(TwoBodyCombiner<ProtonKaonTraits, TwoBody::kAllSign, PKPairPolicy>::Combine(mProtons, mKaons, policy));
+  } else {
+    mPairCounts.Add(TwoBodyCombiner<ProtonKaonTraits, TwoBody::kUnlikeSign, PKPairPolicy>::Combine(mProtons, mKaons, policy));
+  }
+  mPairTimer.Stop();
+
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+Int_t StLambda1520Maker::Finish() {
+  if (mOutName != "") {
+    TFile* fout = new TFile(mOutName.Data(), "RECREATE");
+    if (fout && !fout->IsZombie()) {
+      fout->cd();
+      WriteHistograms();
+      fout->Close();
+    }
+    if (fout) delete fout;
+  }
+  std::cout << "StLambda1520Maker::Finish() processed " << mEventCounter << " events" << std::endl;
+  mRuns.Print("StLambda1520Maker::Finish() ");
+  mTriggers.Print(mConfig->GetEventCuts().triggers, "StLambda1520Maker::Finish() ");
+  std::cout << "StLambda1520Maker::Finish() pK pairs: " << mPairCounts.nPairs
+            << ", in mass window: " << mPairCounts.nInWindow
+            << "; pair loop RealTime: " << mPairTimer.RealTime()
+            << " s CpuTime: " << mPairTimer.CpuTime() << " s" << std::endl;
+  std::cout << "StLambda1520Maker::Finish() arena: " << mArena.GetNBlockAllocs()
+            << " heap block allocation(s) in " << mEventCounter << " events, high-water "
+            << mArena.GetHighWater() / 1024.0 << " kB" << std::endl;
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+void StLambda1520Maker::WriteHistograms() {
+  if (m_histManager) m_histManager->Write();
+}
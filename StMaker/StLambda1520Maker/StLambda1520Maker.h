@@ -0,0 +1,96 @@
+#ifndef StLambda1520Maker_h
+#define StLambda1520Maker_h
+
+#include "StMaker.h"
+#include "TStopwatch.h"
+#include "TwoBodyCombiner.h"
+#include "EventArena.h"
+#include "TriggerSelection.h"
+#include "RunQuality.h"
+#include "../StTrackViewMaker/StTrackViewMaker.h"
+#include "../StTrackViewMaker/StTrackViewCut.h"
+#include <vector>
+
+class StPicoDst;
+class StPicoDstMaker;
+class StPicoEvent;
+class ConfigContext;
+class TString;
+class HistManager;
+class StEventSelectionMaker;
+class TVector3;
+
+class StLambda1520Maker;
+
+StLambda1520Maker* createStLambda1520Maker(const char* name, StPicoDstMaker* picoMaker, const char* outName);
+extern "C" void* createStLambda1520MakerC(const char* name, void* picoMaker, const char* outName);
+
+// Lambda(1520) -> p K-. Proton and kaon lists are paired with TwoBodyCombiner
+// (straight-line mass at the primary vertex; no secondary vertexing).
+class StLambda1520Maker : public StMaker {
+public:
+  StLambda1520Maker(const char* name, StPicoDstMaker* picoMaker, const char* outName);
+  virtual ~StLambda1520Maker();
+
+  virtual Int_t Init();
+  virtual Int_t Make();
+  virtual void Clear(Option_t* opt = "");
+  virtual Int_t Finish();
+
+  void WriteHistograms();
+
+  // Read tracks from a StTrackViewMaker earlier in the chain (else filled here)
+  void SetTrackViewMaker(StTrackViewMaker* viewMaker) { mTrackViewMaker = viewMaker; }
+
+  // Use a shared StEventSelectionMaker instead of this maker's own event cuts
+  void SetEventSelectionMaker(StEventSelectionMaker* selMaker) { mEventSelection = selMaker; }
+
+  // This maker's event cuts (run quality, triggers, vertex, refMult, VPD),
+  // which need only the Event branch, so a driver can read the tracks of
+  // accepted events only
+  Bool_t AcceptEvent(const StPicoEvent* event);
+
+  // Cuts and main.yaml keys from config instead of ConfigManager's default context
+  void SetConfigContext(const ConfigContext& config) { mConfig = &config; }
+
+private:
+  StPicoDstMaker* mPicoDstMaker;
+  const ConfigContext* mConfig;
+  StPicoDst* mPicoDst;
+  TString mOutName;
+  Int_t mEventCounter;
+  HistManager* m_histManager;
+  StTrackViewMaker* mTrackViewMaker;
+  StEventSelectionMaker* mEventSelection;
+  StTrackView mOwnView;          // used when no StTrackViewMaker is set
+  StTrackViewCut mTrackExpr;     // TrackCutConfig::expression, compiled in Init()
+  RunCounts mRuns;               // ConfigContext::GetRunQuality(), applied first in Make()
+  TriggerCounts mTriggers;       // EventCutConfig::triggers, applied next
+
+  // Daughter candidate (primary momentum)
+  struct Daughter_t {
+    Int_t index;
+    Short_t charge;
+    Float_t px, py, pz;
+  };
+
+  // HistManager handles, resolved in Init() (0 if disabled by hist_skip_tags)
+  struct Hists;
+  Hists* mHists;
+
+  // p K pair loop (TwoBodyCombiner traits / fill policy, defined in .cxx)
+  struct ProtonKaonTraits;
+  struct PKPairPolicy;
+
+  // Per-event daughter lists on the maker's arena, reset in Clear()
+  EventArena mArena;
+  ArenaVector<Daughter_t>::type mProtons;
+  ArenaVector<Daughter_t>::type mKaons;
+  TStopwatch mPairTimer;
+  TwoBody::Counts mPairCounts;
+
+  Bool_t PassEventCuts(const TVector3& pVtx, Int_t refMult, Float_t vzVpd);
+  Bool_t PassTrackCuts(const StTrackView& tv, Int_t i);
+};
+
+#endif
@@ -1,11 +1,11 @@
 #include "StLambdaMaker.h"
+#include "../StEventSelectionMaker/StEventSelectionMaker.h"
 #include "ConfigManager.h"
 #include "HistManager.h"
 #include "cuts/EventCutConfig.h"
 #include "cuts/LambdaCutConfig.h"
 #include "StPicoDstMaker/StPicoDstMaker.h"
 #include "StPicoEvent/StPicoDst.h"
-#include "StPicoEvent/StPicoTrack.h"
 #include "StPicoEvent/StPicoEvent.h"
 #include "StarClassLibrary/StPhysicalHelixD.hh"
 #include "StarClassLibrary/StThreeVectorF.hh"
@@ -16,6 +16,7 @@
 #include "TVector3.h"
 #include "TLorentzVector.h"
 
+#include <cstdlib>
 #include <iostream>
 #include <utility>
 
@@ -28,10 +29,23 @@ namespace {
 StLambdaMaker::StLambdaMaker(const char* name, StPicoDstMaker* picoMaker, const char* outName)
   : StMaker(name),
     mPicoDstMaker(picoMaker),
+    mConfig(&ConfigManager::GetInstance().GetContext()),
     mPicoDst(0),
     mOutName(outName),
     mEventCounter(0),
-    m_histManager(0) {}
+    mEntry(0),
+    mResumeEntry(0),
+    m_histManager(0),
+    mTrackViewMaker(0),
+    mEventSelection(0),
+    mAccepted(kFALSE),
+    mPosIdx(ArenaAllocator<Int_t>(&mArena)),
+    mNegIdx(ArenaAllocator<Int_t>(&mArena)),
+    mPosFlags(ArenaAllocator<UChar_t>(&mArena)),
+    mNegFlags(ArenaAllocator<UChar_t>(&mArena)),
+    mPosHelix(ArenaAllocator<StPhysicalHelixD>(&mArena)),
+    mNegHelix(ArenaAllocator<StPhysicalHelixD>(&mArena)),
+    mLambdas(ArenaAllocator<Lambda_t>(&mArena)) {}
 
 //-----------------------------------------------------------------------------
 StLambdaMaker::~StLambdaMaker() {
@@ -52,92 +66,132 @@ extern "C" void* createStLambdaMakerC(const char* name, void* picoMaker, const c
 
 //-----------------------------------------------------------------------------
 Int_t StLambdaMaker::Init() {
-  std::string histPath = ConfigManager::GetInstance().GetHistConfigPath();
+  // Per-maker key first, so several makers can share one main.yaml
+  const ConfigContext& cm = *mConfig;
+  std::string histPath = cm.HasMainConfigKey("hist_lambda") ? cm.GetHistConfigPath("hist_lambda") : cm.GetHistConfigPath();
   if (histPath.empty()) {
     std::cerr << "[StLambdaMaker] GetHistConfigPath() returned empty; no histograms will be filled." << std::endl;
     m_histManager = 0;
     return kStOK;
   }
   m_histManager = new HistManager();
+  m_histManager->DisableTags(cm.GetMainConfigValue("hist_skip_tags"));  // e.g. "qa" in production
   if (!m_histManager->LoadFromFile(histPath.c_str())) {
     std::cerr << "[StLambdaMaker] Failed to load hist config from " << histPath << std::endl;
     delete m_histManager;
     m_histManager = 0;
     return kStOK;
   }
+  // Checkpoints next to the output; one left by a killed job is resumed
+  const Double_t ckptEvents = std::atof(cm.GetMainConfigValue("checkpoint_events").c_str());
+  const Double_t ckptSeconds = std::atof(cm.GetMainConfigValue("checkpoint_seconds").c_str());
+  if (mOutName != "" && (ckptEvents > 0 || ckptSeconds > 0)) {
+    m_histManager->SetCheckpoint(std::string(mOutName.Data()) + ".ckpt", (Long64_t)ckptEvents, ckptSeconds);
+    // So the Finish() rejection summaries cover the whole job after a resume
+    m_histManager->AddCheckpointCounts("runCounts", mRuns);
+    m_histManager->AddCheckpointCounts("triggerCounts", mTriggers);
+    mResumeEntry = mEntry = m_histManager->RestoreCheckpoint();
+  }
   return kStOK;
 }
 
 //-----------------------------------------------------------------------------
-void StLambdaMaker::Clear(Option_t* opt) {}
+void StLambdaMaker::Clear(Option_t* opt) {
+  ArenaRelease(mPosIdx); ArenaRelease(mPosFlags); ArenaRelease(mPosHelix);
+  ArenaRelease(mNegIdx); ArenaRelease(mNegFlags); ArenaRelease(mNegHelix);
+  ArenaRelease(mLambdas);
+  mArena.Reset();
+  mAccepted = kFALSE;
+}
 
 //-----------------------------------------------------------------------------
 Bool_t StLambdaMaker::PassEventCuts(Int_t nTracks) {
-  EventCutConfig& ev = ConfigManager::GetInstance().GetEventCuts();
+  const EventCutConfig& ev = mConfig->GetEventCuts();
   if (ev.maxNTr > 0 && nTracks > ev.maxNTr) return kFALSE;
   return kTRUE;
 }
 
 //-----------------------------------------------------------------------------
-Bool_t StLambdaMaker::PassProtonCuts(StPicoTrack* trk, const TVector3& pVtx) {
-  if (!trk || trk->charge() <= 0) return kFALSE;
-  LambdaCutConfig& lam = ConfigManager::GetInstance().GetLambdaCuts();
-  if (TMath::Abs(trk->nSigmaProton()) > lam.nSigmaProton) return kFALSE;
-  Double_t dca = trk->gDCA(pVtx.X(), pVtx.Y(), pVtx.Z());
-  if (dca < lam.minDCAProton) return kFALSE;
-  return kTRUE;
-}
-
-//-----------------------------------------------------------------------------
-Bool_t StLambdaMaker::PassPionCuts(StPicoTrack* trk, const TVector3& pVtx) {
-  if (!trk || trk->charge() >= 0) return kFALSE;
-  LambdaCutConfig& lam = ConfigManager::GetInstance().GetLambdaCuts();
-  if (TMath::Abs(trk->nSigmaPion()) > lam.nSigmaPion) return kFALSE;
-  Double_t dca = trk->gDCA(pVtx.X(), pVtx.Y(), pVtx.Z());
-  if (dca < lam.minDCAPion) return kFALSE;
-  return kTRUE;
+UChar_t StLambdaMaker::DaughterFlags(const StTrackView& tv, Int_t i) {
+  if (tv.charge[i] == 0) return 0;
+  const LambdaCutConfig& lam = mConfig->GetLambdaCuts();
+  Double_t dca = tv.dca[i];
+  UChar_t flags = 0;
+  if ((lam.enableLambda || lam.enableAntiLambda) &&
+      TMath::Abs(tv.nSigmaProton[i]) <= lam.nSigmaProton && dca >= lam.minDCAProton)
+    flags |= kProtonCand;
+  if ((lam.enableLambda || lam.enableAntiLambda) &&
+      TMath::Abs(tv.nSigmaPion[i]) <= lam.nSigmaPion && dca >= lam.minDCAPion)
+    flags |= kPionCand;
+  if (lam.enableK0s &&
+      TMath::Abs(tv.nSigmaPion[i]) <= lam.nSigmaPionK0s && dca >= lam.minDCAPionK0s)
+    flags |= kPionK0sCand;
+  return flags;
 }
 
 //-----------------------------------------------------------------------------
-StPhysicalHelixD StLambdaMaker::MakeHelix(StPicoTrack* trk, Double_t bField) {
-  StThreeVectorF p(trk->gMom().X(), trk->gMom().Y(), trk->gMom().Z());
-  StThreeVectorF o(trk->origin().X(), trk->origin().Y(), trk->origin().Z());
-  return StPhysicalHelixD(p, o, bField * units::kilogauss, (Float_t)trk->charge());
+StPhysicalHelixD StLambdaMaker::MakeHelix(const StTrackView& tv, Int_t i) {
+  StThreeVectorF p(tv.gPx[i], tv.gPy[i], tv.gPz[i]);
+  StThreeVectorF o(tv.originX[i], tv.originY[i], tv.originZ[i]);
+  return StPhysicalHelixD(p, o, tv.bField * units::kilogauss, (Float_t)tv.charge[i]);
 }
 
 //-----------------------------------------------------------------------------
-Bool_t StLambdaMaker::MakeLambdaHelix(StPicoTrack* p, StPicoTrack* pi, Double_t bField,
-                                      TVector3& v0, TVector3& momP, TVector3& momPi, Double_t& dca12) {
-  LambdaCutConfig& lam = ConfigManager::GetInstance().GetLambdaCuts();
-  StPhysicalHelixD hp  = MakeHelix(p,  bField);
-  StPhysicalHelixD hpi = MakeHelix(pi, bField);
+Bool_t StLambdaMaker::SolvePair(const StPhysicalHelixD& hPos, const StPhysicalHelixD& hNeg, Double_t bField,
+                                TVector3& v0, TVector3& momPos, TVector3& momNeg, Double_t& dca12) {
+  const LambdaCutConfig& lam = mConfig->GetLambdaCuts();
 
-  std::pair<Double_t, Double_t> s = hp.pathLengths(hpi);
+  std::pair<Double_t, Double_t> s = hPos.pathLengths(hNeg);
   if (TMath::Abs(s.first) > lam.maxPathLength || TMath::Abs(s.second) > lam.maxPathLength)
     return kFALSE;
 
-  StThreeVectorD dcaA = hp.at(s.first);
-  StThreeVectorD dcaB = hpi.at(s.second);
+  StThreeVectorD dcaA = hPos.at(s.first);
+  StThreeVectorD dcaB = hNeg.at(s.second);
 
   StThreeVectorD v0_( (dcaA.x() + dcaB.x()) * 0.5,
                       (dcaA.y() + dcaB.y()) * 0.5,
                       (dcaA.z() + dcaB.z()) * 0.5 );
   dca12 = (dcaA - dcaB).mag();
+  if (dca12 < 0) return kFALSE;
 
-  if (dca12 < 0 || dca12 > lam.maxDaughterDCA) return kFALSE;
+  StThreeVectorD pPos = hPos.momentumAt(s.first,  bField * units::kilogauss);
+  StThreeVectorD pNeg = hNeg.momentumAt(s.second, bField * units::kilogauss);
 
-  StThreeVectorD pp  = hp.momentumAt(s.first,  bField * units::kilogauss);
-  StThreeVectorD ppi = hpi.momentumAt(s.second, bField * units::kilogauss);
-
-  momP.SetXYZ(pp.x(), pp.y(), pp.z());
-  momPi.SetXYZ(ppi.x(), ppi.y(), ppi.z());
+  momPos.SetXYZ(pPos.x(), pPos.y(), pPos.z());
+  momNeg.SetXYZ(pNeg.x(), pNeg.y(), pNeg.z());
   v0.SetXYZ(v0_.x(), v0_.y(), v0_.z());
 
   return kTRUE;
 }
 
+//-----------------------------------------------------------------------------
+void StLambdaMaker::PushLambda(const TVector3& mom, Double_t mass, const TVector3& v0,
+                               Double_t dca12, Double_t dcaV0, Double_t cosPoint,
+                               Int_t posIndex, Int_t negIndex, Short_t baryon) {
+  Lambda_t lam;
+  lam.px = mom.X();
+  lam.py = mom.Y();
+  lam.pz = mom.Z();
+  lam.mass = mass;
+  lam.decayX = v0.X();
+  lam.decayY = v0.Y();
+  lam.decayZ = v0.Z();
+  lam.dca12 = dca12;
+  lam.dcaV0 = dcaV0;
+  lam.cosPoint = cosPoint;
+  lam.posIndex = posIndex;
+  lam.negIndex = negIndex;
+  lam.baryon = baryon;
+  mLambdas.push_back(lam);
+}
+
 //-----------------------------------------------------------------------------
 Int_t StLambdaMaker::Make() {
+  // Histograms so far cover entries [0, mEntry)
+  if (m_histManager) m_histManager->Checkpoint(mEntry);
+  mEntry++;
+  mAccepted = kFALSE;
+
   if (!mPicoDstMaker) return kStWarn;
   mPicoDst = mPicoDstMaker->picoDst();
   if (!mPicoDst) return kStWarn;
@@ -145,68 +199,156 @@ Int_t StLambdaMaker::Make() {
   StPicoEvent* event = mPicoDst->event();
   if (!event) return kStWarn;
 
+  // Run quality and trigger selection before any histogram or track
+  if (!mRuns.Pass(mConfig->GetRunQuality(), event->runId(), event->eventId())) return kStOK;
+  if (!mTriggers.Pass(mConfig->GetEventCuts().triggers, *event)) return kStOK;
+
   mEventCounter++;
 
   TVector3 pVtx = event->primaryVertex();
-  Int_t nTr = mPicoDst->numberOfTracks();
-
   if (m_histManager) {
+    m_histManager->BeginEvent(event->runId(), event->eventId());  // bootstrap weights
     m_histManager->Fill("hVz", pVtx.Z());
     m_histManager->Fill("hRefMult", event->refMult());
   }
 
-  if (!PassEventCuts(nTr)) return kStOK;
+  // Track count from StPicoDst, so rejected events never fill the track view
+  if (mEventSelection ? !mEventSelection->IsAccepted() : !PassEventCuts(mPicoDst->numberOfTracks())) return kStOK;
+  mAccepted = kTRUE;
+
+  const StTrackView* view = &mOwnView;
+  if (mTrackViewMaker) {
+    view = &mTrackViewMaker->GetTrackView();
+  } else {
+    mOwnView.Fill(mPicoDst, pVtx, event->bField());
+  }
+  const StTrackView& tv = *view;
+  Int_t nTr = tv.nTracks;
 
+  const LambdaCutConfig& lam = mConfig->GetLambdaCuts();
   Double_t bField = event->bField();
 
-  for (Int_t ip = 0; ip < nTr; ip++) {
-    StPicoTrack* p = mPicoDst->track(ip);
-    if (!p) continue;
-    if (!PassProtonCuts(p, pVtx)) continue;
+  // Preselect daughters once per event, split by charge, one helix per track
+  mPosIdx.reserve(nTr); mPosFlags.reserve(nTr); mPosHelix.reserve(nTr);
+  mNegIdx.reserve(nTr); mNegFlags.reserve(nTr); mNegHelix.reserve(nTr);
+  mLambdas.reserve(64);
+  for (Int_t i = 0; i < nTr; i++) {
+    UChar_t flags = DaughterFlags(tv, i);
+    if (!flags) continue;
+    if (tv.charge[i] > 0) {
+      mPosIdx.push_back(i);
+      mPosFlags.push_back(flags);
+      mPosHelix.push_back(MakeHelix(tv, i));
+    } else {
+      mNegIdx.push_back(i);
+      mNegFlags.push_back(flags);
+      mNegHelix.push_back(MakeHelix(tv, i));
+    }
+  }
+
+  // Loosest daughter DCA over the enabled hypotheses
+  Double_t maxDCA12 = 0;
+  if (lam.enableLambda || lam.enableAntiLambda) maxDCA12 = lam.maxDaughterDCA;
+  if (lam.enableK0s && lam.maxDaughterDCAK0s > maxDCA12) maxDCA12 = lam.maxDaughterDCAK0s;
+
+  for (size_t ip = 0; ip < mPosIdx.size(); ip++) {
+    UChar_t fPos = mPosFlags[ip];
 
-    for (Int_t ii = 0; ii < nTr; ii++) {
-      if (ii == ip) continue;
-      StPicoTrack* pi = mPicoDst->track(ii);
-      if (!pi) continue;
-      if (!PassPionCuts(pi, pVtx)) continue;
+    for (size_t in = 0; in < mNegIdx.size(); in++) {
+      UChar_t fNeg = mNegFlags[in];
 
-      TVector3 v0, momP, momPi;
+      Bool_t isLambda     = lam.enableLambda     && (fPos & kProtonCand) && (fNeg & kPionCand);
+      Bool_t isAntiLambda = lam.enableAntiLambda && (fNeg & kProtonCand) && (fPos & kPionCand);
+      Bool_t isK0s        = lam.enableK0s        && (fPos & kPionK0sCand) && (fNeg & kPionK0sCand);
+      if (!isLambda && !isAntiLambda && !isK0s) continue;
+
+      // One helix solution shared by all hypotheses
+      TVector3 v0, momPos, momNeg;
       Double_t dca12 = 0;
-      if (!MakeLambdaHelix(p, pi, bField, v0, momP, momPi, dca12)) continue;
+      if (!SolvePair(mPosHelix[ip], mNegHelix[in], bField, v0, momPos, momNeg, dca12)) continue;
+      if (dca12 > maxDCA12) continue;
 
-      TVector3 pLam = momP + momPi;
-      Double_t pLamMag = pLam.Mag();
-      if (pLamMag < 1e-5) continue;
+      TVector3 pV0 = momPos + momNeg;
+      Double_t pV0Mag = pV0.Mag();
+      if (pV0Mag < 1e-5) continue;
 
-      TVector3 pLamUnit = pLam * (1.0 / pLamMag);
+      TVector3 pV0Unit = pV0 * (1.0 / pV0Mag);
       TVector3 diff = pVtx - v0;
-      Double_t dcaV0 = (diff.Cross(pLamUnit)).Mag();
-
-      LambdaCutConfig& lam = ConfigManager::GetInstance().GetLambdaCuts();
-      if (dcaV0 > lam.maxDCAV0) continue;
+      Double_t dcaV0 = (diff.Cross(pV0Unit)).Mag();
 
       TVector3 flight = v0 - pVtx;
-      Double_t cosPoint = flight.Dot(pLam) / (flight.Mag() * pLam.Mag() + 1e-10);
-      if (cosPoint < lam.minCosPointing) continue;
-
-      TLorentzVector lp, lpi;
-      lp.SetVectM(momP,  kProtonMass);
-      lpi.SetVectM(momPi, kPionMass);
-      Double_t invMass = (lp + lpi).M();
-
-      if (m_histManager) {
-        m_histManager->Fill("hLambda_InvMass", invMass);
-        m_histManager->Fill("hLambda_Pt", pLam.Pt());
-        m_histManager->Fill("hLambda_Eta", pLam.PseudoRapidity());
-        m_histManager->Fill("hLambda_Phi", pLam.Phi());
-        m_histManager->Fill("hDCA12", dca12);
-        m_histManager->Fill("hDCAV0", dcaV0);
-        m_histManager->Fill("hCosPointing", cosPoint);
-        m_histManager->Fill("hNSigmaProton", p->nSigmaProton());
-        m_histManager->Fill("hNSigmaPion", pi->nSigmaPion());
-        m_histManager->Fill("hLambda_InvMass_vs_Pt", pLam.Pt(), invMass);
-        m_histManager->Fill("hDCAV0_vs_InvMass", invMass, dcaV0);
-        m_histManager->Fill("hCosPointing_vs_InvMass", invMass, cosPoint);
+      Double_t cosPoint = flight.Dot(pV0) / (flight.Mag() * pV0Mag + 1e-10);
+
+      // Lambda / anti-Lambda share the topology cuts
+      Bool_t passLamTopo = (dca12 <= lam.maxDaughterDCA && dcaV0 <= lam.maxDCAV0 &&
+                            cosPoint >= lam.minCosPointing);
+
+      //--- Lambda: p(+) pi(-)
+      if (isLambda && passLamTopo) {
+        TLorentzVector lp, lpi;
+        lp.SetVectM(momPos, kProtonMass);
+        lpi.SetVectM(momNeg, kPionMass);
+        Double_t invMass = (lp + lpi).M();
+
+        if (invMass >= lam.lambdaMassMin && invMass <= lam.lambdaMassMax) {
+          PushLambda(pV0, invMass, v0, dca12, dcaV0, cosPoint, mPosIdx[ip], mNegIdx[in], 1);
+          if (m_histManager) {
+            m_histManager->Fill("hLambda_InvMass", invMass);
+            m_histManager->Fill("hLambda_Pt", pV0.Pt());
+            m_histManager->Fill("hLambda_Eta", pV0.PseudoRapidity());
+            m_histManager->Fill("hLambda_Phi", pV0.Phi());
+            m_histManager->Fill("hDCA12", dca12);
+            m_histManager->Fill("hDCAV0", dcaV0);
+            m_histManager->Fill("hCosPointing", cosPoint);
+            m_histManager->Fill("hNSigmaProton", tv.nSigmaProton[mPosIdx[ip]]);
+            m_histManager->Fill("hNSigmaPion", tv.nSigmaPion[mNegIdx[in]]);
+            m_histManager->Fill("hLambda_InvMass_vs_Pt", pV0.Pt(), invMass);
+            m_histManager->Fill("hDCAV0_vs_InvMass", invMass, dcaV0);
+            m_histManager->Fill("hCosPointing_vs_InvMass", invMass, cosPoint);
+          }
+        }
+      }
+
+      //--- anti-Lambda: pbar(-) pi(+)
+      if (isAntiLambda && passLamTopo) {
+        TLorentzVector lp, lpi;
+        lp.SetVectM(momNeg, kProtonMass);
+        lpi.SetVectM(momPos, kPionMass);
+        Double_t invMass = (lp + lpi).M();
+
+        if (invMass >= lam.lambdaMassMin && invMass <= lam.lambdaMassMax) {
+          PushLambda(pV0, invMass, v0, dca12, dcaV0, cosPoint, mPosIdx[ip], mNegIdx[in], -1);
+          if (m_histManager) {
+            m_histManager->Fill("hAntiLambda_InvMass", invMass);
+            m_histManager->Fill("hAntiLambda_Pt", pV0.Pt());
+            m_histManager->Fill("hAntiLambda_Eta", pV0.PseudoRapidity());
+            m_histManager->Fill("hAntiLambda_Phi", pV0.Phi());
+            m_histManager->Fill("hAntiLambda_DCA12", dca12);
+            m_histManager->Fill("hAntiLambda_DCAV0", dcaV0);
+            m_histManager->Fill("hAntiLambda_CosPointing", cosPoint);
+            m_histManager->Fill("hAntiLambda_InvMass_vs_Pt", pV0.Pt(), invMass);
+          }
+        }
+      }
+
+      //--- K0S: pi(+) pi(-)
+      if (isK0s && dca12 <= lam.maxDaughterDCAK0s && dcaV0 <= lam.maxDCAV0K0s &&
+          cosPoint >= lam.minCosPointingK0s) {
+        TLorentzVector lpip, lpim;
+        lpip.SetVectM(momPos, kPionMass);
+        lpim.SetVectM(momNeg, kPionMass);
+        Double_t invMass = (lpip + lpim).M();
+
+        if (m_histManager && invMass >= lam.k0sMassMin && invMass <= lam.k0sMassMax) {
+          m_histManager->Fill("hK0s_InvMass", invMass);
+          m_histManager->Fill("hK0s_Pt", pV0.Pt());
+          m_histManager->Fill("hK0s_Eta", pV0.PseudoRapidity());
+          m_histManager->Fill("hK0s_Phi", pV0.Phi());
+          m_histManager->Fill("hK0s_DCA12", dca12);
+          m_histManager->Fill("hK0s_DCAV0", dcaV0);
+          m_histManager->Fill("hK0s_CosPointing", cosPoint);
+          m_histManager->Fill("hK0s_InvMass_vs_Pt", pV0.Pt(), invMass);
+        }
       }
     }
   }
@@ -223,10 +365,18 @@ Int_t StLambdaMaker::Finish() {
       fout->cd();
       WriteHistograms();
       fout->Close();
+      if (m_histManager) m_histManager->RemoveCheckpoint();
     }
     if (fout) delete fout;
   }
-  std::cout << "StLambdaMaker::Finish() processed " << mEventCounter << " events" << std::endl;
+  std::cout << "StLambdaMaker::Finish() processed " << mEventCounter << " events";
+  if (mResumeEntry > 0) std::cout << " (resumed at entry " << mResumeEntry << ")";
+  std::cout << std::endl;
+  mRuns.Print("StLambdaMaker::Finish() ");
+  mTriggers.Print(mConfig->GetEventCuts().triggers, "StLambdaMaker::Finish() ");
+  std::cout << "StLambdaMaker::Finish() arena: " << mArena.GetNBlockAllocs()
+            << " heap block allocation(s) in " << mEventCounter << " events, high-water "
+            << mArena.GetHighWater() / 1024.0 << " kB" << std::endl;
   return kStOK;
 }
 
@@ -3,13 +3,20 @@
 
 #include "StMaker.h"
 #include "StarClassLibrary/StPhysicalHelixD.hh"
+#include "EventArena.h"
+#include "TriggerSelection.h"
+#include "RunQuality.h"
+#include "../StTrackViewMaker/StTrackViewMaker.h"
+#include <vector>
 
 class StPicoDst;
 class StPicoDstMaker;
+class ConfigContext;
 class StPicoEvent;
 class StPicoTrack;
 class TString;
 class HistManager;
+class StEventSelectionMaker;
 class TVector3;
 
 class StLambdaMaker;
@@ -29,19 +36,71 @@ public:
 
   void WriteHistograms();
 
+  // Read tracks from a StTrackViewMaker earlier in the chain (else filled here)
+  void SetTrackViewMaker(StTrackViewMaker* viewMaker) { mTrackViewMaker = viewMaker; }
+
+  // Use a shared StEventSelectionMaker instead of this maker's own event cuts
+  void SetEventSelectionMaker(StEventSelectionMaker* selMaker) { mEventSelection = selMaker; }
+
+  // Entry to continue from after Init() restored a checkpoint (0: none); the
+  // macro reads through the entries before it with this maker inactive
+  Long64_t GetResumeEntry() const { return mResumeEntry; }
+
+  // Lambda / anti-Lambda candidate (inside the lambdaMassMin/Max window) published
+  // per event for downstream makers in the same chain (e.g. StSigma1385Maker)
+  struct Lambda_t {
+    Float_t px, py, pz;              // momentum at the decay vertex
+    Float_t mass;
+    Float_t decayX, decayY, decayZ;  // decay vertex
+    Float_t dca12, dcaV0, cosPoint;
+    Int_t posIndex, negIndex;        // daughter track indices in StPicoDst
+    Short_t baryon;                  // +1 Lambda, -1 anti-Lambda
+  };
+
+  // Candidates of the current event (on this maker's arena); released in Clear()
+  typedef ArenaVector<Lambda_t>::type LambdaList;
+  const LambdaList& GetLambdaCandidates() const { return mLambdas; }
+
+  // kTRUE if the current event passed this maker's trigger and event cuts
+  Bool_t IsEventAccepted() const { return mAccepted; }
+
+  // Cuts and main.yaml keys from config instead of ConfigManager's default context
+  void SetConfigContext(const ConfigContext& config) { mConfig = &config; }
+
 private:
   StPicoDstMaker* mPicoDstMaker;
+  const ConfigContext* mConfig;
   StPicoDst* mPicoDst;
   TString mOutName;
   Int_t mEventCounter;
+  Long64_t mEntry;               // Make() calls, counted from mResumeEntry
+  Long64_t mResumeEntry;
   HistManager* m_histManager;
+  StTrackViewMaker* mTrackViewMaker;
+  StEventSelectionMaker* mEventSelection;
+  StTrackView mOwnView;          // used when no StTrackViewMaker is set
+  RunCounts mRuns;               // ConfigContext::GetRunQuality(), applied first in Make()
+  TriggerCounts mTriggers;       // EventCutConfig::triggers, applied next
+  Bool_t mAccepted;
+
+  // Daughter roles of a preselected track (bit mask)
+  enum { kProtonCand = 1, kPionCand = 2, kPionK0sCand = 4 };
+
+  // Per-event daughter and candidate lists on the maker's arena, reset in Clear()
+  EventArena mArena;
+  ArenaVector<Int_t>::type mPosIdx, mNegIdx;
+  ArenaVector<UChar_t>::type mPosFlags, mNegFlags;
+  ArenaVector<StPhysicalHelixD>::type mPosHelix, mNegHelix;
+  LambdaList mLambdas;
 
   Bool_t PassEventCuts(Int_t nTracks);
-  Bool_t PassProtonCuts(StPicoTrack* trk, const TVector3& pVtx);
-  Bool_t PassPionCuts(StPicoTrack* trk, const TVector3& pVtx);
-  StPhysicalHelixD MakeHelix(StPicoTrack* trk, Double_t bField);
-  Bool_t MakeLambdaHelix(StPicoTrack* p, StPicoTrack* pi, Double_t bField,
-                         TVector3& v0, TVector3& momP, TVector3& momPi, Double_t& dca12);
+  UChar_t DaughterFlags(const StTrackView& tv, Int_t i);
+  StPhysicalHelixD MakeHelix(const StTrackView& tv, Int_t i);
+  Bool_t SolvePair(const StPhysicalHelixD& hPos, const StPhysicalHelixD& hNeg, Double_t bField,
+                   TVector3& v0, TVector3& momPos, TVector3& momNeg, Double_t& dca12);
+  void PushLambda(const TVector3& mom, Double_t mass, const TVector3& v0,
+                  Double_t dca12, Double_t dcaV0, Double_t cosPoint,
+                  Int_t posIndex, Int_t negIndex, Short_t baryon);
 };
 
 #endif
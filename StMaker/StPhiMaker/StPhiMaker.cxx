@@ -1,6 +1,8 @@
 #include "StPhiMaker.h"
+#include "../StEventSelectionMaker/StEventSelectionMaker.h"
 #include "ConfigManager.h"
 #include "HistManager.h"
+#include "RunQA.h"
 #include "cuts/EventCutConfig.h"
 #include "cuts/TrackCutConfig.h"
 #include "cuts/PhiCutConfig.h"
@@ -8,33 +10,209 @@
 #include "StPicoEvent/StPicoDst.h"
 #include "StPicoEvent/StPicoTrack.h"
 #include "StPicoEvent/StPicoEvent.h"
-#include "StPicoEvent/StPicoBTofPidTraits.h"
 #include "StarClassLibrary/StPhysicalHelixD.hh"
 #include "StarClassLibrary/StThreeVectorF.hh"
 #include "StarClassLibrary/SystemOfUnits.h"
 
 #include "TFile.h"
+#include "TH1.h"
+#include "THnSparse.h"
 #include "TMath.h"
 #include "TSystem.h"
 #include "TVector3.h"
 #include "TVector2.h"
 
+#include <cstdlib>
 #include <iostream>
 #include <vector>
 #include <utility>
 
 namespace {
   const Double_t kKaonMass = 0.493677;
+
+  // Run QA observables by name: per accepted event, and per track passing the track cuts
+  enum RunQAEventVar { kQaRefMult, kQaVz, kQaVr, kQaVzVpd, kQaVzDiff, kQaNTofMatch, kQaNTracks, kNQaEventVars };
+  const char* const kRunQAEventVars[kNQaEventVars] = {
+    "refMult", "vz", "vr", "vzVpd", "vzDiff", "nTofMatch", "nTracks"
+  };
+  enum RunQATrackVar { kQaPt, kQaEta, kQaPhi, kQaDca, kQaNHitsFit, kQaNHitsDedx, kQaDedx,
+                       kQaNSigmaKaon, kQaNSigmaPion, kQaChi2, kNQaTrackVars };
+  const char* const kRunQATrackVars[kNQaTrackVars] = {
+    "pt", "eta", "phi", "dca", "nHitsFit", "nHitsDedx", "dEdx", "nSigmaKaon", "nSigmaPion", "chi2"
+  };
 }
 
+//-----------------------------------------------------------------------------
+// phi -> K+K-: one kaon list, unlike-sign pairs i < j
+struct StPhiMaker::KaonTraits {
+  static Double_t Mass1() { return kKaonMass; }
+  static Double_t Mass2() { return kKaonMass; }
+  static const Bool_t kIdentical = kTRUE;
+};
+
+struct StPhiMaker::Hists {
+  typedef HistManager::Handle H;
+  // Event
+  H vz, vxVy, refMult, vzVsRun, refMultVsVz, vzDiff, triggerIds;
+  // Track
+  H pt, eta, phi, nHitsFit, nHitsRatio, dca, charge, chi2;
+  H dedxVsP, nSigmaPionVsP, nSigmaKaonVsP, nSigmaProtonVsP;
+  H tofMatchMult, qxQy, psi2, n;
+  // Pair
+  H mkkAll, mkkSame, mkkVsPt, mkkAngleCut, mkkRapidityCut, mkkBothCuts;
+  H angleRaw, rapidityRaw, pairPtRaw, angleVsMkk, rapidityVsMkk, angleVsPt, angleVsRapidity, rapidityVsPt;
+  H angleAfterCuts, rapidityAfterCuts, pairPtAfterCuts;
+  H mkkSparse;                 // (M_KK, pT, RefMult, phi - Psi2)
+  HistManager::FamilyHandle mkkPtRefMult;  // M_KK per (pT bin, RefMult class)
+  // Which derived quantities some enabled histogram needs
+  Bool_t needP, needAngle, needRapidity, needPairFill;
+
+  Hists() { Resolve(0); }
+
+  void Resolve(HistManager* hm) {
+    vz = Get(hm, "hVz");
+    vxVy = Get(hm, "hVxVy");
+    refMult = Get(hm, "hRefMult");
+    vzVsRun = Get(hm, "hVzVsRun");
+    refMultVsVz = Get(hm, "hRefMultVsVz");
+    vzDiff = Get(hm, "hVzDiff");
+    triggerIds = Get(hm, "hTriggerIds");
+    pt = Get(hm, "hPt");
+    eta = Get(hm, "hEta");
+    phi = Get(hm, "hPhi");
+    nHitsFit = Get(hm, "hNHitsFit");
+    nHitsRatio = Get(hm, "hNHitsRatio");
+    dca = Get(hm, "hDCA");
+    charge = Get(hm, "hCharge");
+    chi2 = Get(hm, "hChi2");
+    dedxVsP = Get(hm, "hDedxVsP");
+    nSigmaPionVsP = Get(hm, "hNSigmaPionVsP");
+    nSigmaKaonVsP = Get(hm, "hNSigmaKaonVsP");
+    nSigmaProtonVsP = Get(hm, "hNSigmaProtonVsP");
+    tofMatchMult = Get(hm, "hTofMatchMult");
+    qxQy = Get(hm, "hQxQy");
+    psi2 = Get(hm, "hPsi2");
+    n = Get(hm, "hN");
+    mkkAll = Get(hm, "hMKK_AllCombinations");
+    mkkSame = Get(hm, "hMKK_SameEvent");
+    mkkVsPt = Get(hm, "hMKK_vs_Pt");
+    mkkAngleCut = Get(hm, "hMKK_OpeningAngleCut");
+    mkkRapidityCut = Get(hm, "hMKK_RapidityCut");
+    mkkBothCuts = Get(hm, "hMKK_BothCuts");
+    angleRaw = Get(hm, "hOpeningAngle_Raw");
+    rapidityRaw = Get(hm, "hPairRapidity_Raw");
+    pairPtRaw = Get(hm, "hPairPt_Raw");
+    angleVsMkk = Get(hm, "hOpeningAngle_vs_MKK");
+    rapidityVsMkk = Get(hm, "hPairRapidity_vs_MKK");
+    angleVsPt = Get(hm, "hOpeningAngle_vs_Pt");
+    angleVsRapidity = Get(hm, "hOpeningAngle_vs_Rapidity");
+    rapidityVsPt = Get(hm, "hPairRapidity_vs_Pt");
+    angleAfterCuts = Get(hm, "hOpeningAngle_AfterCuts");
+    rapidityAfterCuts = Get(hm, "hPairRapidity_AfterCuts");
+    pairPtAfterCuts = Get(hm, "hPairPt_AfterCuts");
+    mkkSparse = Get(hm, "hMKK_Pt_RefMult_dPhi");
+    mkkPtRefMult = hm ? hm->GetFamily("hMKK_PtRefMult") : 0;
+    if (mkkSparse && hm->GetSparse("hMKK_Pt_RefMult_dPhi")->GetNdimensions() != 4) {
+      std::cerr << "[StPhiMaker] hMKK_Pt_RefMult_dPhi needs 4 axes (M_KK, pT, RefMult, phi - Psi2); not filled." << std::endl;
+      mkkSparse = 0;
+    }
+
+    const Bool_t afterCuts = mkkBothCuts || mkkPtRefMult || angleAfterCuts || rapidityAfterCuts || pairPtAfterCuts;
+    needP = dedxVsP || nSigmaPionVsP || nSigmaKaonVsP || nSigmaProtonVsP;
+    needAngle = angleRaw || angleVsMkk || angleVsPt || angleVsRapidity || mkkAngleCut || afterCuts;
+    needRapidity = rapidityRaw || rapidityVsMkk || angleVsRapidity || rapidityVsPt || mkkRapidityCut || afterCuts;
+    needPairFill = needAngle || needRapidity || pairPtRaw || mkkVsPt || mkkSame || mkkSparse;
+  }
+
+  static H Get(HistManager* hm, const char* name) { return hm ? hm->GetHandle(name) : 0; }
+};
+
+struct StPhiMaker::PhiPairPolicy {
+  StPhiMaker* maker;
+  HistManager* hm;
+  const Hists& h;
+  const PhiCutConfig& cut;
+  Double_t invMass;             // from Accept(): helix momenta at the DCA
+  TVector3 phiMom;
+  Double_t refMult;             // event, for hMKK_Pt_RefMult_dPhi
+  Double_t psi2;
+  Bool_t hasPsi2;
+
+  PhiPairPolicy(StPhiMaker* m, Double_t mult, Double_t ep, Bool_t hasEp)
+    : maker(m), hm(m->m_histManager), h(*m->mHists),
+      cut(m->mConfig->GetPhiCuts()), invMass(0),
+      refMult(mult), psi2(ep), hasPsi2(hasEp) {}
+
+  Double_t MinMass() const { return cut.minInvMassPre; }
+  Double_t MaxMass() const { return cut.maxInvMassPre; }
+
+  Bool_t Raw(const Track_t&, const Track_t&, const TwoBody::Pair& pair) {
+    if (h.mkkAll) hm->Fill(h.mkkAll, pair.mass);
+    return kTRUE;
+  }
+
+  Bool_t Accept(const Track_t& k1, const Track_t& k2, TwoBody::Pair&) {
+    Double_t dca = 0;
+    return maker->ReconstructPhi(k1, k2, invMass, phiMom, dca);
+  }
+
+  // Opening angle and rapidity only if an enabled histogram uses them
+  void Fill(const Track_t& k1, const Track_t& k2, const TwoBody::Pair&) {
+    if (!h.needPairFill) return;
+    Double_t openingAngle = h.needAngle ? maker->CalculateOpeningAngle(k1, k2) : 0;
+    Double_t pairRapidity = h.needRapidity ? maker->CalculatePairRapidity(invMass, phiMom) : 0;
+    Double_t pairPt = phiMom.Pt();
+    if (h.angleRaw) hm->Fill(h.angleRaw, openingAngle);
+    if (h.rapidityRaw) hm->Fill(h.rapidityRaw, pairRapidity);
+    if (h.pairPtRaw) hm->Fill(h.pairPtRaw, pairPt);
+    if (h.angleVsMkk) hm->Fill(h.angleVsMkk, openingAngle, invMass);
+    if (h.rapidityVsMkk) hm->Fill(h.rapidityVsMkk, pairRapidity, invMass);
+    if (h.angleVsPt) hm->Fill(h.angleVsPt, openingAngle, pairPt);
+    if (h.angleVsRapidity) hm->Fill(h.angleVsRapidity, openingAngle, pairRapidity);
+    if (h.rapidityVsPt) hm->Fill(h.rapidityVsPt, pairRapidity, pairPt);
+    if (h.mkkVsPt) hm->Fill(h.mkkVsPt, pairPt, invMass);
+    if (h.mkkSame) hm->Fill(h.mkkSame, invMass);
+    if (h.mkkSparse && hasPsi2) {
+      Double_t dPhi = TVector2::Phi_0_2pi(phiMom.Phi() - psi2);
+      if (dPhi >= TMath::Pi()) dPhi -= TMath::Pi();
+      const Double_t x[4] = {invMass, pairPt, refMult, dPhi};
+      hm->FillND(h.mkkSparse, x);
+    }
+
+    Bool_t passAngle = (openingAngle >= cut.minOpeningAngle && openingAngle <= cut.maxOpeningAngle);
+    Bool_t passRapidity = (pairRapidity >= cut.minPairRapidity && pairRapidity <= cut.maxPairRapidity);
+    if (passAngle && h.mkkAngleCut) hm->Fill(h.mkkAngleCut, invMass);
+    if (passRapidity && h.mkkRapidityCut) hm->Fill(h.mkkRapidityCut, invMass);
+    if (passAngle && passRapidity) {
+      if (h.mkkBothCuts) hm->Fill(h.mkkBothCuts, invMass);
+      if (h.mkkPtRefMult) {
+        // Outside the index axes gives a 0 handle: not filled
+        hm->Fill(hm->GetHandle(h.mkkPtRefMult, hm->FindIndex(h.mkkPtRefMult, 0, pairPt),
+                               hm->FindIndex(h.mkkPtRefMult, 1, refMult)), invMass);
+      }
+      if (h.angleAfterCuts) hm->Fill(h.angleAfterCuts, openingAngle);
+      if (h.rapidityAfterCuts) hm->Fill(h.rapidityAfterCuts, pairRapidity);
+      if (h.pairPtAfterCuts) hm->Fill(h.pairPtAfterCuts, pairPt);
+    }
+  }
+};
+
 //-----------------------------------------------------------------------------
 StPhiMaker::StPhiMaker(const char* name, StPicoDstMaker* picoMaker, const char* outName)
     : StMaker(name),
       mPicoDstMaker(picoMaker),
+      mConfig(&ConfigManager::GetInstance().GetContext()),
       mPicoDst(0),
       mOutName(outName),
       mEventCounter(0),
-      m_histManager(0) {}
+      mEntry(0),
+      mResumeEntry(0),
+      m_histManager(0),
+      mTrackViewMaker(0),
+      mEventSelection(0),
+      mHists(new Hists()),
+      mRunQA(0),
+      mKaons(ArenaAllocator<Track_t>(&mArena)) {}
 
 //-----------------------------------------------------------------------------
 StPhiMaker::~StPhiMaker() {
@@ -42,6 +220,7 @@ StPhiMaker::~StPhiMaker() {
     delete m_histManager;
     m_histManager = 0;
   }
+  delete mHists;
 }
 
 //-----------------------------------------------------------------------------
@@ -55,27 +234,60 @@ extern "C" void* createStPhiMakerC(const char* name, void* picoMaker, const char
 
 //-----------------------------------------------------------------------------
 Int_t StPhiMaker::Init() {
-  std::string histPath = ConfigManager::GetInstance().GetHistConfigPath();
+  mPairTimer.Reset();  // TStopwatch starts on construction
+  const ConfigContext& cm = *mConfig;
+  // Track expression from the cut YAML, parsed once here and evaluated per event
+  const std::string& trackExpr = cm.GetTrackCuts().expression;
+  if (!mTrackExpr.Compile(trackExpr)) {
+    std::cerr << "[StPhiMaker] Bad track expression: " << mTrackExpr.GetError() << std::endl;
+    return kStFatal;
+  }
+  if (!mTrackExpr.IsEmpty()) {
+    std::cout << "[StPhiMaker] Track expression: " << trackExpr << std::endl;
+  }
+
+  // Per-maker key first, so several makers can share one main.yaml
+  std::string histPath = cm.HasMainConfigKey("hist_phi") ? cm.GetHistConfigPath("hist_phi") : cm.GetHistConfigPath();
   if (histPath.empty()) {
     std::cerr << "[StPhiMaker] GetHistConfigPath() returned empty; no histograms will be filled." << std::endl;
     m_histManager = 0;
     return kStOK;
   }
   m_histManager = new HistManager();
+  m_histManager->DisableTags(cm.GetMainConfigValue("hist_skip_tags"));  // e.g. "qa" in production
   if (!m_histManager->LoadFromFile(histPath.c_str())) {
     std::cerr << "[StPhiMaker] Failed to load hist config from " << histPath << std::endl;
     delete m_histManager;
     m_histManager = 0;
     return kStOK;
   }
+  mHists->Resolve(m_histManager);
+  ResolveRunQA();
+  // Checkpoints next to the output; one left by a killed job is resumed
+  const Double_t ckptEvents = std::atof(cm.GetMainConfigValue("checkpoint_events").c_str());
+  const Double_t ckptSeconds = std::atof(cm.GetMainConfigValue("checkpoint_seconds").c_str());
+  if (mOutName != "" && (ckptEvents > 0 || ckptSeconds > 0)) {
+    m_histManager->SetCheckpoint(std::string(mOutName.Data()) + ".ckpt", (Long64_t)ckptEvents, ckptSeconds);
+    // So the Finish() rejection summaries cover the whole job after a resume
+    m_histManager->AddCheckpointCounts("runCounts", mRuns);
+    m_histManager->AddCheckpointCounts("triggerCounts", mTriggers);
+    mResumeEntry = mEntry = m_histManager->RestoreCheckpoint();
+  }
   return kStOK;
 }
 
 //-----------------------------------------------------------------------------
-void StPhiMaker::Clear(Option_t* opt) {}
+void StPhiMaker::Clear(Option_t* opt) {
+  ArenaRelease(mKaons);
+  mArena.Reset();
+}
 
 //-----------------------------------------------------------------------------
 Int_t StPhiMaker::Make() {
+  // Histograms so far cover entries [0, mEntry)
+  if (m_histManager) m_histManager->Checkpoint(mEntry);
+  mEntry++;
+
   if (!mPicoDstMaker) {
     return kStWarn;
   }
@@ -89,6 +301,15 @@ Int_t StPhiMaker::Make() {
     return kStWarn;
   }
 
+  // Run quality and trigger selection before any histogram or track
+  if (!mRuns.Pass(mConfig->GetRunQuality(), event->runId(), event->eventId())) {
+    return kStOK;
+  }
+  const TriggerSelection& trig = mConfig->GetEventCuts().triggers;
+  if (!mTriggers.Pass(trig, *event)) {
+    return kStOK;
+  }
+
   mEventCounter++;
 
   TVector3 pVtx = event->primaryVertex();
@@ -97,65 +318,93 @@ Int_t StPhiMaker::Make() {
   Float_t vr = TMath::Sqrt(pVtx.X() * pVtx.X() + pVtx.Y() * pVtx.Y());
 
   // Event-level fills
-  if (m_histManager) {
-    m_histManager->Fill("hVz", pVtx.Z());
-    m_histManager->Fill("hVxVy", pVtx.X(), pVtx.Y());
-    m_histManager->Fill("hRefMult", refMult);
-    m_histManager->Fill("hVzVsRun", (Double_t)event->runId(), pVtx.Z());
-    m_histManager->Fill("hRefMultVsVz", pVtx.Z(), refMult);
-    EventCutConfig& ev = ConfigManager::GetInstance().GetEventCuts();
+  const Hists& h = *mHists;
+  HistManager* hm = m_histManager;
+  if (hm) hm->BeginEvent(event->runId(), event->eventId());  // bootstrap weights
+  if (h.vz) hm->Fill(h.vz, pVtx.Z());
+  if (h.vxVy) hm->Fill(h.vxVy, pVtx.X(), pVtx.Y());
+  if (h.refMult) hm->Fill(h.refMult, refMult);
+  if (h.vzVsRun) hm->Fill(h.vzVsRun, (Double_t)event->runId(), pVtx.Z());
+  if (h.refMultVsVz) hm->Fill(h.refMultVsVz, pVtx.Z(), refMult);
+  if (h.vzDiff) {
+    const EventCutConfig& ev = mConfig->GetEventCuts();
     if (TMath::Abs(vzVpd) < ev.maxAbsVzVpd) {
-      m_histManager->Fill("hVzDiff", pVtx.Z() - vzVpd);
+      hm->Fill(h.vzDiff, pVtx.Z() - vzVpd);
     }
-    std::vector<unsigned int> triggerIds = event->triggerIds();
-    for (size_t i = 0; i < triggerIds.size(); i++) {
-      m_histManager->Fill("hTriggerIds", triggerIds[i]);
+  }
+  if (h.triggerIds) {
+    if (trig.IsActive()) {
+      // Selected triggers the event fired, from the trigger stage (no copy)
+      const ULong64_t fired = mTriggers.GetFired();
+      for (Int_t k = 0; k < trig.GetN(); k++) {
+        if ((fired >> k) & 1) hm->Fill(h.triggerIds, trig.GetId(k));
+      }
+    } else {
+      std::vector<unsigned int> triggerIds = event->triggerIds();
+      for (size_t i = 0; i < triggerIds.size(); i++) {
+        hm->Fill(h.triggerIds, triggerIds[i]);
+      }
     }
   }
 
-  if (!PassEventCuts(pVtx.Z(), vr, refMult, vzVpd)) {
+  if (mEventSelection ? !mEventSelection->IsAccepted() : !PassEventCuts(pVtx.Z(), vr, refMult, vzVpd)) {
+    return kStOK;
+  }
+  // The event config's maxNTr (StEventSelectionMaker applies it there); it needs
+  // the track count, so AcceptEvent() leaves it here whatever decided the event
+  const Int_t evMaxNTr = mConfig->GetEventCuts().maxNTr;
+  if (!mEventSelection && evMaxNTr > 0 && (Int_t)mPicoDst->numberOfTracks() > evMaxNTr) {
     return kStOK;
   }
 
   Bool_t useTOF = kFALSE;
-  const Int_t kMaxKaons = 2000;
-  std::vector<Track_t> kaonsPlus;
-  std::vector<Track_t> kaonsMinus;
-  kaonsPlus.reserve(kMaxKaons / 2);
-  kaonsMinus.reserve(kMaxKaons / 2);
-
-  Int_t nTracks = mPicoDst->numberOfTracks();
-  PhiCutConfig& phiCfg = ConfigManager::GetInstance().GetPhiCuts();
+  const Int_t kMaxKaons = 4000;  // K+ and K- together
+
+  const StTrackView* view = &mOwnView;
+  if (mTrackViewMaker) {
+    view = &mTrackViewMaker->GetTrackView();
+  } else {
+    mOwnView.Fill(mPicoDst, pVtx, event->bField());
+  }
+  const StTrackView& tv = *view;
+
+  Int_t nTracks = tv.nTracks;
+  const PhiCutConfig& phiCfg = mConfig->GetPhiCuts();
   if (phiCfg.maxNTr > 0 && nTracks > phiCfg.maxNTr) {
     return kStOK;
   }
+  mTrackExpr.Evaluate(tv);  // all tracks in one pass; PassTrackCuts reads the result
+  mKaons.reserve(TMath::Min(nTracks, kMaxKaons));  // one arena allocation per event
+  if (mRunQA) mRunQA->SetRun(event->runId());
 
   Double_t Qx = 0.0, Qy = 0.0;
   Int_t nTofMatch = 0;
+  Int_t nGoodTracks = 0;
 
   for (Int_t itrk = 0; itrk < nTracks; itrk++) {
-    StPicoTrack* trk = mPicoDst->track(itrk);
-    if (!trk) continue;
-    if (!PassTrackCuts(trk, pVtx)) continue;
+    if (!PassTrackCuts(tv, itrk)) continue;
+    nGoodTracks++;
 
-    TVector3 pMom = trk->pMom();
+    TVector3 pMom = tv.PMom(itrk);
     Float_t pt = pMom.Perp();
     Float_t eta = pMom.PseudoRapidity();
     Float_t phi = pMom.Phi();
-
-    if (m_histManager) {
-      m_histManager->Fill("hPt", pt);
-      m_histManager->Fill("hEta", eta);
-      m_histManager->Fill("hPhi", phi);
-      m_histManager->Fill("hNHitsFit", trk->nHitsFit());
-      m_histManager->Fill("hNHitsRatio", (Float_t)trk->nHitsFit() / (Float_t)trk->nHitsMax());
-      m_histManager->Fill("hDCA", trk->gDCA(pVtx).Mag());
-      m_histManager->Fill("hCharge", trk->charge());
-      m_histManager->Fill("hChi2", trk->chi2());
-      m_histManager->Fill("hDedxVsP", pMom.Mag(), trk->dEdx());
-      m_histManager->Fill("hNSigmaPionVsP", pMom.Mag(), trk->nSigmaPion());
-      m_histManager->Fill("hNSigmaKaonVsP", pMom.Mag(), trk->nSigmaKaon());
-      m_histManager->Fill("hNSigmaProtonVsP", pMom.Mag(), trk->nSigmaProton());
+    if (!mRunQATrack.empty()) FillRunQATrack(tv, itrk, pt, eta, phi);
+
+    if (h.pt) hm->Fill(h.pt, pt);
+    if (h.eta) hm->Fill(h.eta, eta);
+    if (h.phi) hm->Fill(h.phi, phi);
+    if (h.nHitsFit) hm->Fill(h.nHitsFit, tv.nHitsFit[itrk]);
+    if (h.nHitsRatio) hm->Fill(h.nHitsRatio, (Float_t)tv.nHitsFit[itrk] / (Float_t)tv.nHitsMax[itrk]);
+    if (h.dca) hm->Fill(h.dca, tv.dca[itrk]);
+    if (h.charge) hm->Fill(h.charge, tv.charge[itrk]);
+    if (h.chi2) hm->Fill(h.chi2, tv.chi2[itrk]);
+    if (h.needP) {
+      Double_t p = pMom.Mag();
+      if (h.dedxVsP) hm->Fill(h.dedxVsP, p, tv.dEdx[itrk]);
+      if (h.nSigmaPionVsP) hm->Fill(h.nSigmaPionVsP, p, tv.nSigmaPion[itrk]);
+      if (h.nSigmaKaonVsP) hm->Fill(h.nSigmaKaonVsP, p, tv.nSigmaKaon[itrk]);
+      if (h.nSigmaProtonVsP) hm->Fill(h.nSigmaProtonVsP, p, tv.nSigmaProton[itrk]);
     }
 
     if (pt >= phiCfg.minPtEp && pt <= phiCfg.maxPtEp && TMath::Abs(eta) < phiCfg.maxEtaEp) {
@@ -163,25 +412,20 @@ Int_t StPhiMaker::Make() {
       Qy += TMath::Sin(2.0 * phi);
     }
 
-    Int_t btofIndex = trk->bTofPidTraitsIndex();
+    Int_t btofIndex = tv.btofIndex[itrk];
     if (btofIndex >= 0) nTofMatch++;
 
-    if (!PassKaonCuts(trk, pVtx)) continue;
+    if (!PassKaonCuts(tv, itrk)) continue;
 
     Track_t track;
-    BuildTrack(track, trk, event, pVtx);
+    track.index = itrk;
+    BuildTrack(track, tv, itrk);
     if (useTOF && btofIndex >= 0) {
-      StPicoBTofPidTraits* tof = mPicoDst->btofPidTraits(btofIndex);
-      if (tof) {
-        Double_t beta = tof->btofBeta();
-        if (beta > 1e-4) {
-          Double_t oneOverBeta = 1.0 / beta;
-          track.mass2 = pMom.Mag2() * (oneOverBeta * oneOverBeta - 1.0);
-          track.tofMatch = kTRUE;
-        } else {
-          track.mass2 = -999.0;
-          track.tofMatch = kFALSE;
-        }
+      Double_t beta = tv.beta[itrk];
+      if (beta > 1e-4) {
+        Double_t oneOverBeta = 1.0 / beta;
+        track.mass2 = pMom.Mag2() * (oneOverBeta * oneOverBeta - 1.0);
+        track.tofMatch = kTRUE;
       } else {
         track.mass2 = -999.0;
         track.tofMatch = kFALSE;
@@ -191,76 +435,48 @@ Int_t StPhiMaker::Make() {
       track.tofMatch = kFALSE;
     }
 
-    if (IsKaon(track, useTOF)) {
-      if (track.charge > 0 && (Int_t)kaonsPlus.size() < kMaxKaons) {
-        kaonsPlus.push_back(track);
-      } else if (track.charge < 0 && (Int_t)kaonsMinus.size() < kMaxKaons) {
-        kaonsMinus.push_back(track);
-      }
-    }
-  }
-
-  if (m_histManager) m_histManager->Fill("hTofMatchMult", nTofMatch);
-
-  // Phi reconstruction: ReconstructPhi pairs
-  for (size_t iPlus = 0; iPlus < kaonsPlus.size(); iPlus++) {
-    for (size_t iMinus = 0; iMinus < kaonsMinus.size(); iMinus++) {
-      Double_t invMass;
-      TVector3 phiMom, dcaPosPlus, dcaPosMinus;
-      if (!ReconstructPhi(kaonsPlus[iPlus], kaonsMinus[iMinus], invMass, phiMom, dcaPosPlus, dcaPosMinus)) continue;
-
-      Double_t openingAngle = CalculateOpeningAngle(kaonsPlus[iPlus], kaonsMinus[iMinus]);
-      Double_t pairRapidity = CalculatePairRapidity(invMass, phiMom);
-      if (m_histManager) {
-        m_histManager->Fill("hOpeningAngle_Raw", openingAngle);
-        m_histManager->Fill("hPairRapidity_Raw", pairRapidity);
-        m_histManager->Fill("hPairPt_Raw", phiMom.Pt());
-        m_histManager->Fill("hOpeningAngle_vs_MKK", openingAngle, invMass);
-        m_histManager->Fill("hPairRapidity_vs_MKK", pairRapidity, invMass);
-        m_histManager->Fill("hOpeningAngle_vs_Pt", openingAngle, phiMom.Pt());
-        m_histManager->Fill("hOpeningAngle_vs_Rapidity", openingAngle, pairRapidity);
-        m_histManager->Fill("hPairRapidity_vs_Pt", pairRapidity, phiMom.Pt());
-        m_histManager->Fill("hMKK_vs_Pt", phiMom.Pt(), invMass);
-        m_histManager->Fill("hMKK_SameEvent", invMass);
-      }
-
-      PhiCutConfig& phiCut = ConfigManager::GetInstance().GetPhiCuts();
-      Bool_t passAngle = (openingAngle >= phiCut.minOpeningAngle && openingAngle <= phiCut.maxOpeningAngle);
-      Bool_t passRapidity = (pairRapidity >= phiCut.minPairRapidity && pairRapidity <= phiCut.maxPairRapidity);
-      if (m_histManager) {
-        if (passAngle) m_histManager->Fill("hMKK_OpeningAngleCut", invMass);
-        if (passRapidity) m_histManager->Fill("hMKK_RapidityCut", invMass);
-        if (passAngle && passRapidity) {
-          m_histManager->Fill("hMKK_BothCuts", invMass);
-          m_histManager->Fill("hOpeningAngle_AfterCuts", openingAngle);
-          m_histManager->Fill("hPairRapidity_AfterCuts", pairRapidity);
-          m_histManager->Fill("hPairPt_AfterCuts", phiMom.Pt());
-        }
-      }
+    if (IsKaon(track, useTOF) && track.charge != 0 && (Int_t)mKaons.size() < kMaxKaons) {
+      track.helix = BuildHelix(track);
+      mKaons.push_back(track);
     }
   }
 
-  // All combinations (simple invariant mass)
-  if (m_histManager) {
-    for (size_t iPlus = 0; iPlus < kaonsPlus.size(); iPlus++) {
-      for (size_t iMinus = 0; iMinus < kaonsMinus.size(); iMinus++) {
-        Double_t invMass = CalculateInvariantMass(kaonsPlus[iPlus], kaonsMinus[iMinus], kKaonMass, kKaonMass);
-        m_histManager->Fill("hMKK_AllCombinations", invMass);
-      }
+  if (h.tofMatchMult) hm->Fill(h.tofMatchMult, nTofMatch);
+  if (!mRunQAEvent.empty()) {
+    const Bool_t vpdOk = TMath::Abs(vzVpd) < mConfig->GetEventCuts().maxAbsVzVpd;
+    Double_t qa[kNQaEventVars];
+    qa[kQaRefMult] = refMult;
+    qa[kQaVz] = pVtx.Z();
+    qa[kQaVr] = vr;
+    qa[kQaVzVpd] = vzVpd;
+    qa[kQaVzDiff] = pVtx.Z() - vzVpd;
+    qa[kQaNTofMatch] = nTofMatch;
+    qa[kQaNTracks] = nGoodTracks;
+    for (size_t k = 0; k < mRunQAEvent.size(); k++) {
+      const Int_t var = mRunQAEvent[k].first;
+      if ((var == kQaVzVpd || var == kQaVzDiff) && !vpdOk) continue;
+      mRunQA->Fill(mRunQAEvent[k].second, qa[var]);
     }
   }
 
-  // Event plane
+  // Event plane, before the pairs (filled relative to it)
   TVector2 Q(Qx, Qy);
-  if (m_histManager) {
-    m_histManager->Fill("hQxQy", Qx, Qy);
-    if (Q.Mod() > 0) {
-      Double_t psi2 = 0.5 * TMath::ATan2(Qy, Qx);
-      if (psi2 < 0) psi2 += TMath::Pi();
-      m_histManager->Fill("hPsi2", psi2);
-    }
-    m_histManager->Fill("hN", 0);
+  const Bool_t hasPsi2 = Q.Mod() > 0;
+  Double_t psi2 = 0;
+  if (hasPsi2) {
+    psi2 = 0.5 * TMath::ATan2(Qy, Qx);
+    if (psi2 < 0) psi2 += TMath::Pi();
   }
+
+  // Phi reconstruction: K+K- pairs with the mass-window pre-check before the helix DCA
+  mPairTimer.Start(kFALSE);
+  PhiPairPolicy policy(this, refMult, psi2, hasPsi2);
+  mPairCounts.Add(TwoBodyCombiner<KaonTraits, TwoBody::kUnlikeSign, PhiPairPolicy>::Combine(mKaons, policy));
+  mPairTimer.Stop();
+
+  if (h.qxQy) hm->Fill(h.qxQy, Qx, Qy);
+  if (h.psi2 && hasPsi2) hm->Fill(h.psi2, psi2);
+  if (h.n) hm->Fill(h.n, 0);
   return kStOK;
 }
 
@@ -271,8 +487,21 @@ Int_t StPhiMaker::Finish() {
     fout->cd();
     WriteHistograms();
     fout->Close();
+    if (m_histManager) m_histManager->RemoveCheckpoint();
   }
-  std::cout << "StPhiMaker::Finish() processed " << mEventCounter << " events" << std::endl;
+  std::cout << "StPhiMaker::Finish() processed " << mEventCounter << " events";
+  if (mResumeEntry > 0) std::cout << " (resumed at entry " << mResumeEntry << ")";
+  std::cout << std::endl;
+  mRuns.Print("StPhiMaker::Finish() ");
+  mTriggers.Print(mConfig->GetEventCuts().triggers, "StPhiMaker::Finish() ");
+  std::cout << "StPhiMaker::Finish() K+K- pairs: " << mPairCounts.nPairs
+            << ", in mass window: " << mPairCounts.nInWindow
+            << ", accepted: " << mPairCounts.nAccepted
+            << "; pair loop RealTime: " << mPairTimer.RealTime()
+            << " s CpuTime: " << mPairTimer.CpuTime() << " s" << std::endl;
+  std::cout << "StPhiMaker::Finish() arena: " << mArena.GetNBlockAllocs()
+            << " heap block allocation(s) in " << mEventCounter << " events, high-water "
+            << mArena.GetHighWater() / 1024.0 << " kB" << std::endl;
   return kStOK;
 }
 
@@ -281,46 +510,103 @@ void StPhiMaker::WriteHistograms() {
   if (m_histManager) m_histManager->Write();
 }
 
+//-----------------------------------------------------------------------------
+Bool_t StPhiMaker::AcceptEvent(const StPicoEvent* event) {
+  if (!event) return kFALSE;
+  if (!mRuns.Pass(mConfig->GetRunQuality(), event->runId(), event->eventId())) return kFALSE;
+  if (!mTriggers.Pass(mConfig->GetEventCuts().triggers, *event)) return kFALSE;
+  TVector3 pVtx = event->primaryVertex();
+  Float_t vr = TMath::Sqrt(pVtx.X() * pVtx.X() + pVtx.Y() * pVtx.Y());
+  return PassEventCuts(pVtx.Z(), vr, event->refMult(), event->vzVpd());
+}
+
+//-----------------------------------------------------------------------------
+Bool_t StPhiMaker::AcceptEvent(const EventTagIndex::Tag& tag) {
+  const EventTagIndex::TagEvent event(tag);
+  if (!mRuns.Pass(mConfig->GetRunQuality(), event.runId(), event.eventId())) return kFALSE;
+  if (!mTriggers.Pass(mConfig->GetEventCuts().triggers, event)) return kFALSE;
+  return PassEventCuts(tag.vz, tag.vr, tag.refMult, tag.vzVpd);
+}
+
+//-----------------------------------------------------------------------------
+void StPhiMaker::ResolveRunQA() {
+  mRunQA = m_histManager ? m_histManager->GetRunQA() : 0;
+  mRunQAEvent.clear();
+  mRunQATrack.clear();
+  if (!mRunQA) return;
+  for (Int_t col = 0; col < mRunQA->GetNObservables(); col++) {
+    const std::string& name = mRunQA->GetName(col);
+    Int_t var = 0;
+    while (var < kNQaEventVars && name != kRunQAEventVars[var]) var++;
+    if (var < kNQaEventVars) {
+      mRunQAEvent.push_back(std::make_pair(var, col));
+      continue;
+    }
+    var = 0;
+    while (var < kNQaTrackVars && name != kRunQATrackVars[var]) var++;
+    if (var < kNQaTrackVars) {
+      mRunQATrack.push_back(std::make_pair(var, col));
+      continue;
+    }
+    std::cerr << "[StPhiMaker] Unknown runQA observable '" << name << "'; not filled." << std::endl;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void StPhiMaker::FillRunQATrack(const StTrackView& tv, Int_t i, Float_t pt, Float_t eta, Float_t phi) {
+  for (size_t k = 0; k < mRunQATrack.size(); k++) {
+    Double_t x = 0;
+    switch (mRunQATrack[k].first) {
+      case kQaPt: x = pt; break;
+      case kQaEta: x = eta; break;
+      case kQaPhi: x = phi; break;
+      case kQaDca: x = tv.dca[i]; break;
+      case kQaNHitsFit: x = tv.nHitsFit[i]; break;
+      case kQaNHitsDedx: x = tv.nHitsDedx[i]; break;
+      case kQaDedx: x = tv.dEdx[i]; break;
+      case kQaNSigmaKaon: x = tv.nSigmaKaon[i]; break;
+      case kQaNSigmaPion: x = tv.nSigmaPion[i]; break;
+      case kQaChi2: x = tv.chi2[i]; break;
+    }
+    mRunQA->Fill(mRunQATrack[k].second, x);
+  }
+}
+
 //-----------------------------------------------------------------------------
 Bool_t StPhiMaker::PassEventCuts(Float_t vz, Float_t vr, Int_t refMult, Float_t vzVpd) {
-  EventCutConfig& ev = ConfigManager::GetInstance().GetEventCuts();
-  if (TMath::Abs(vz) > ev.maxVz) return kFALSE;
-  if (vr > ev.maxVr) return kFALSE;
-  if (refMult < ev.minRefMult) return kFALSE;
-  if (refMult > ev.maxRefMult) return kFALSE;
-  if (TMath::Abs(vz - vzVpd) > ev.maxVzDiff && TMath::Abs(vzVpd) < ev.maxAbsVzVpd) return kFALSE;
-  return kTRUE;
+  return mConfig->GetEventCuts().Pass(vz, vr, refMult, vzVpd);
 }
 
 //-----------------------------------------------------------------------------
-Bool_t StPhiMaker::PassTrackCuts(StPicoTrack* trk, TVector3& pVtx) {
-  TrackCutConfig& tr = ConfigManager::GetInstance().GetTrackCuts();
-  if (trk->nHitsFit() < tr.minNHitsFit) return kFALSE;
-  if ((Float_t)trk->nHitsFit() / (Float_t)trk->nHitsMax() < tr.minNHitsRatio) return kFALSE;
-  if (trk->nHitsDedx() < tr.minNHitsDedx) return kFALSE;
-  if (trk->chi2() > tr.maxChi2) return kFALSE;
-  TVector3 pMom = trk->pMom();
+Bool_t StPhiMaker::PassTrackCuts(const StTrackView& tv, Int_t i) {
+  const TrackCutConfig& tr = mConfig->GetTrackCuts();
+  if (!mTrackExpr.Pass(i)) return kFALSE;
+  if (tv.nHitsFit[i] < tr.minNHitsFit) return kFALSE;
+  if ((Float_t)tv.nHitsFit[i] / (Float_t)tv.nHitsMax[i] < tr.minNHitsRatio) return kFALSE;
+  if (tv.nHitsDedx[i] < tr.minNHitsDedx) return kFALSE;
+  if (tv.chi2[i] > tr.maxChi2) return kFALSE;
+  TVector3 pMom = tv.PMom(i);
   if (pMom.Mag() < 1e-4) return kFALSE;
   Float_t pt = pMom.Perp();
   Float_t eta = pMom.PseudoRapidity();
   if (pt < tr.minPt || pt > tr.maxPt) return kFALSE;
   if (TMath::Abs(eta) > tr.maxEta) return kFALSE;
-  if (trk->gDCA(pVtx).Mag() > tr.maxDCA) return kFALSE;
+  if (tv.dca[i] > tr.maxDCA) return kFALSE;
   return kTRUE;
 }
 
 //-----------------------------------------------------------------------------
-Bool_t StPhiMaker::PassKaonCuts(StPicoTrack* trk, TVector3& pVtx) {
-  if (!PassTrackCuts(trk, pVtx)) return kFALSE;
-  PhiCutConfig& phi = ConfigManager::GetInstance().GetPhiCuts();
-  if (trk->gDCA(pVtx).Mag() > phi.maxDCAKaon) return kFALSE;
-  if (TMath::Abs(trk->nSigmaKaon()) > phi.nSigmaKaon) return kFALSE;
+Bool_t StPhiMaker::PassKaonCuts(const StTrackView& tv, Int_t i) {
+  if (!PassTrackCuts(tv, i)) return kFALSE;
+  const PhiCutConfig& phi = mConfig->GetPhiCuts();
+  if (tv.dca[i] > phi.maxDCAKaon) return kFALSE;
+  if (TMath::Abs(tv.nSigmaKaon[i]) > phi.nSigmaKaon) return kFALSE;
   return kTRUE;
 }
 
 //-----------------------------------------------------------------------------
 Bool_t StPhiMaker::PassTrackCuts(const Track_t& trk) {
-  TrackCutConfig& tr = ConfigManager::GetInstance().GetTrackCuts();
+  const TrackCutConfig& tr = mConfig->GetTrackCuts();
   if (trk.nHitsFit < tr.minNHitsFit) return kFALSE;
   if ((Float_t)trk.nHitsFit / (Float_t)trk.nHitsMax < tr.minNHitsRatio) return kFALSE;
   if (trk.nHitsDedx < tr.minNHitsDedx) return kFALSE;
@@ -334,7 +620,7 @@ Bool_t StPhiMaker::PassTrackCuts(const Track_t& trk) {
 //-----------------------------------------------------------------------------
 Bool_t StPhiMaker::IsKaon(const Track_t& trk, Bool_t useTOF) {
   if (!PassTrackCuts(trk)) return kFALSE;
-  PhiCutConfig& phi = ConfigManager::GetInstance().GetPhiCuts();
+  const PhiCutConfig& phi = mConfig->GetPhiCuts();
   if (trk.DCA > phi.maxDCAKaon) return kFALSE;
   if (TMath::Abs(trk.nSigmaKaon) > phi.nSigmaKaon) return kFALSE;
   if (useTOF && trk.tofMatch) {
@@ -344,60 +630,46 @@ Bool_t StPhiMaker::IsKaon(const Track_t& trk, Bool_t useTOF) {
 }
 
 //-----------------------------------------------------------------------------
-void StPhiMaker::BuildTrack(Track_t& track, StPicoTrack* pico, StPicoEvent* event, TVector3& pVtx) {
-  TVector3 gmom = pico->gMom();
-  TVector3 org = pico->origin();
-  track.originX = org.X();
-  track.originY = org.Y();
-  track.originZ = org.Z();
-  track.momentumX = gmom.X();
-  track.momentumY = gmom.Y();
-  track.momentumZ = gmom.Z();
-  track.BField = event->bField();
+void StPhiMaker::BuildTrack(Track_t& track, const StTrackView& tv, Int_t i) {
+  TVector3 gmom = tv.GMom(i);
+  track.originX = tv.originX[i];
+  track.originY = tv.originY[i];
+  track.originZ = tv.originZ[i];
+  track.px = gmom.X();
+  track.py = gmom.Y();
+  track.pz = gmom.Z();
+  track.BField = tv.bField;
   track.pT = gmom.Perp();
   track.eta = gmom.PseudoRapidity();
   track.phi = gmom.Phi();
-  track.charge = pico->charge();
-  track.nHitsFit = pico->nHitsFit();
-  track.nHitsMax = pico->nHitsMax();
-  track.nHitsDedx = pico->nHitsDedx();
-  track.DCA = pico->gDCA(pVtx).Mag();
-  track.chi2 = pico->chi2();
-  track.nSigmaKaon = pico->nSigmaKaon();
+  track.charge = tv.charge[i];
+  track.nHitsFit = tv.nHitsFit[i];
+  track.nHitsMax = tv.nHitsMax[i];
+  track.nHitsDedx = tv.nHitsDedx[i];
+  track.DCA = tv.dca[i];
+  track.chi2 = tv.chi2[i];
+  track.nSigmaKaon = tv.nSigmaKaon[i];
 }
 
 //-----------------------------------------------------------------------------
 StPhysicalHelixD StPhiMaker::BuildHelix(const Track_t& trk) {
-  StThreeVectorF gmomSt(trk.momentumX, trk.momentumY, trk.momentumZ);
+  StThreeVectorF gmomSt(trk.px, trk.py, trk.pz);
   StThreeVectorF orgSt(trk.originX, trk.originY, trk.originZ);
   StPhysicalHelixD helix(gmomSt, orgSt, trk.BField * units::kilogauss, static_cast<float>(trk.charge));
   return helix;
 }
 
 //-----------------------------------------------------------------------------
-Double_t StPhiMaker::CalculateDCA(const Track_t& trk1, const Track_t& trk2, TVector3& dcaPos1, TVector3& dcaPos2) {
-  StPhysicalHelixD helix1 = BuildHelix(trk1);
-  StPhysicalHelixD helix2 = BuildHelix(trk2);
-  std::pair<Double_t, Double_t> pathLengths = helix1.pathLengths(helix2);
-  StThreeVectorF pos1 = helix1.at(pathLengths.first);
-  StThreeVectorF pos2 = helix2.at(pathLengths.second);
-  dcaPos1 = TVector3(pos1.x(), pos1.y(), pos1.z());
-  dcaPos2 = TVector3(pos2.x(), pos2.y(), pos2.z());
-  TVector3 dcaVec = dcaPos1 - dcaPos2;
-  return dcaVec.Mag();
-}
-
-//-----------------------------------------------------------------------------
-Bool_t StPhiMaker::ReconstructPhi(const Track_t& kPlus, const Track_t& kMinus, Double_t& invMass, TVector3& phiMom, TVector3& dcaPosPlus, TVector3& dcaPosMinus) {
-  PhiCutConfig& phi = ConfigManager::GetInstance().GetPhiCuts();
-  StPhysicalHelixD helixPlus = BuildHelix(kPlus);
-  StPhysicalHelixD helixMinus = BuildHelix(kMinus);
-  Double_t dca = CalculateDCA(kPlus, kMinus, dcaPosPlus, dcaPosMinus);
+Bool_t StPhiMaker::ReconstructPhi(const Track_t& kPlus, const Track_t& kMinus, Double_t& invMass, TVector3& phiMom, Double_t& dca) {
+  const PhiCutConfig& phi = mConfig->GetPhiCuts();
+  std::pair<Double_t, Double_t> pathLengths = kPlus.helix.pathLengths(kMinus.helix);
+  StThreeVectorD pos1 = kPlus.helix.at(pathLengths.first);
+  StThreeVectorD pos2 = kMinus.helix.at(pathLengths.second);
+  dca = (pos1 - pos2).mag();
   if (dca > phi.maxDCAKK) return kFALSE;
 
-  std::pair<Double_t, Double_t> pathLengths = helixPlus.pathLengths(helixMinus);
-  StThreeVectorF pPlus = helixPlus.momentumAt(pathLengths.first, kPlus.BField * units::kilogauss);
-  StThreeVectorF pMinus = helixMinus.momentumAt(pathLengths.second, kMinus.BField * units::kilogauss);
+  StThreeVectorF pPlus = kPlus.helix.momentumAt(pathLengths.first, kPlus.BField * units::kilogauss);
+  StThreeVectorF pMinus = kMinus.helix.momentumAt(pathLengths.second, kMinus.BField * units::kilogauss);
 
   Double_t EPlus = TMath::Sqrt(kKaonMass * kKaonMass + pPlus.mag() * pPlus.mag());
   Double_t EMinus = TMath::Sqrt(kKaonMass * kKaonMass + pMinus.mag() * pMinus.mag());
@@ -3,14 +3,26 @@
 
 #include "StMaker.h"
 #include "StarClassLibrary/StPhysicalHelixD.hh"
+#include "TStopwatch.h"
+#include "TwoBodyCombiner.h"
+#include "EventArena.h"
+#include "TriggerSelection.h"
+#include "RunQuality.h"
+#include "EventTagIndex.h"
+#include "../StTrackViewMaker/StTrackViewMaker.h"
+#include "../StTrackViewMaker/StTrackViewCut.h"
+#include <vector>
 
 class StPicoDst;
 class StPicoDstMaker;
+class ConfigContext;
 class StPicoEvent;
 class StPicoTrack;
 class StPicoBTofPidTraits;
 class TString;
 class HistManager;
+class RunQA;
+class StEventSelectionMaker;
 class TVector3;
 
 class StPhiMaker;
@@ -33,15 +45,58 @@ class StPhiMaker : public StMaker {
 
   void WriteHistograms();
 
+  // Read tracks from a StTrackViewMaker earlier in the chain (else filled here)
+  void SetTrackViewMaker(StTrackViewMaker* viewMaker) { mTrackViewMaker = viewMaker; }
+
+  // Use a shared StEventSelectionMaker instead of this maker's own event cuts
+  void SetEventSelectionMaker(StEventSelectionMaker* selMaker) { mEventSelection = selMaker; }
+
+  // Entry to continue from after Init() restored a checkpoint (0: none); the
+  // macro reads through the entries before it with this maker inactive
+  Long64_t GetResumeEntry() const { return mResumeEntry; }
+
+  // This maker's event cuts that need only the Event branch (run quality,
+  // triggers, vertex, refMult, VPD), so a driver can read the tracks of
+  // accepted events only; the Tag overload decides the same from an event-tag
+  // index entry, with the same run and trigger counts. maxNTr needs the tracks
+  // and stays in Make(). SkipEvent() counts an entry the driver rejected this
+  // way without calling Make(), for the checkpoint entry count.
+  Bool_t AcceptEvent(const StPicoEvent* event);
+  Bool_t AcceptEvent(const EventTagIndex::Tag& tag);
+  void SkipEvent() { mEntry++; }
+
+  // Cuts and main.yaml keys from config instead of ConfigManager's default context
+  void SetConfigContext(const ConfigContext& config) { mConfig = &config; }
+
  private:
   StPicoDstMaker* mPicoDstMaker;
+  const ConfigContext* mConfig;
   StPicoDst* mPicoDst;
   TString mOutName;
   Int_t mEventCounter;
+  Long64_t mEntry;               // Make() calls, counted from mResumeEntry
+  Long64_t mResumeEntry;
   HistManager* m_histManager;
+  StTrackViewMaker* mTrackViewMaker;
+  StEventSelectionMaker* mEventSelection;
+  StTrackView mOwnView;          // used when no StTrackViewMaker is set
+  StTrackViewCut mTrackExpr;     // TrackCutConfig::expression, compiled in Init()
+  RunCounts mRuns;               // ConfigContext::GetRunQuality(), applied first in Make()
+  TriggerCounts mTriggers;       // EventCutConfig::triggers, applied next
+
+  // HistManager handles, resolved in Init() (0 if disabled by hist_skip_tags)
+  struct Hists;
+  Hists* mHists;
+
+  // Run QA (hist YAML "runQA", owned by m_histManager): (variable, column)
+  // pairs of its event- and track-level observables, resolved in Init()
+  RunQA* mRunQA;
+  std::vector<std::pair<Int_t, Int_t> > mRunQAEvent;
+  std::vector<std::pair<Int_t, Int_t> > mRunQATrack;
 
   // Track structure for KK pair reconstruction
   struct Track_t {
+    Int_t index;                 // track index in StPicoDst
     Float_t pT, eta, phi;
     Short_t charge;
     Float_t nSigmaKaon;
@@ -51,20 +106,32 @@ class StPhiMaker : public StMaker {
     Bool_t tofMatch;
     Float_t mass2;
     Float_t originX, originY, originZ;
-    Float_t momentumX, momentumY, momentumZ;
+    Float_t px, py, pz;          // global momentum
     Float_t BField;
+    StPhysicalHelixD helix;      // built once per track
   };
 
+  // K+K- pair loop (TwoBodyCombiner traits / cut+fill policy, defined in .cxx)
+  struct KaonTraits;
+  struct PhiPairPolicy;
+  friend struct PhiPairPolicy;
+
+  EventArena mArena;             // per-event containers, reset in Clear()
+  ArenaVector<Track_t>::type mKaons;  // per-event kaon list
+  TStopwatch mPairTimer;         // accumulated time in the pair loop
+  TwoBody::Counts mPairCounts;
+
   // Helper methods
   Bool_t PassEventCuts(Float_t vz, Float_t vr, Int_t refMult, Float_t vzVpd);
-  Bool_t PassTrackCuts(StPicoTrack* trk, TVector3& pVtx);
-  Bool_t PassKaonCuts(StPicoTrack* trk, TVector3& pVtx);
+  Bool_t PassTrackCuts(const StTrackView& tv, Int_t i);
+  void ResolveRunQA();
+  void FillRunQATrack(const StTrackView& tv, Int_t i, Float_t pt, Float_t eta, Float_t phi);
+  Bool_t PassKaonCuts(const StTrackView& tv, Int_t i);
   Bool_t PassTrackCuts(const Track_t& trk);
   Bool_t IsKaon(const Track_t& trk, Bool_t useTOF);
-  void BuildTrack(Track_t& track, StPicoTrack* pico, StPicoEvent* event, TVector3& pVtx);
+  void BuildTrack(Track_t& track, const StTrackView& tv, Int_t i);
   StPhysicalHelixD BuildHelix(const Track_t& trk);
-  Double_t CalculateDCA(const Track_t& trk1, const Track_t& trk2, TVector3& dcaPos1, TVector3& dcaPos2);
-  Bool_t ReconstructPhi(const Track_t& kPlus, const Track_t& kMinus, Double_t& invMass, TVector3& phiMom, TVector3& dcaPosPlus, TVector3& dcaPosMinus);
+  Bool_t ReconstructPhi(const Track_t& kPlus, const Track_t& kMinus, Double_t& invMass, TVector3& phiMom, Double_t& dca);
   Double_t CalculateInvariantMass(const Track_t& trk1, const Track_t& trk2, Double_t mass1, Double_t mass2);
   Double_t CalculateOpeningAngle(const Track_t& trk1, const Track_t& trk2);
   Double_t CalculatePairRapidity(Double_t invMass, const TVector3& phiMom);
@@ -0,0 +1,250 @@
+#include "StSigma1385Maker.h"
+#include "../StLambdaMaker/StLambdaMaker.h"
+#include "ConfigManager.h"
+#include "HistManager.h"
+#include "cuts/EventCutConfig.h"
+#include "cuts/Sigma1385CutConfig.h"
+#include "StPicoDstMaker/StPicoDstMaker.h"
+#include "StPicoEvent/StPicoDst.h"
+#include "StPicoEvent/StPicoEvent.h"
+#include "StarClassLibrary/StPhysicalHelixD.hh"
+#include "StarClassLibrary/StThreeVectorF.hh"
+#include "StarClassLibrary/SystemOfUnits.h"
+
+#include "TFile.h"
+#include "TMath.h"
+#include "TVector3.h"
+
+#include <iostream>
+
+namespace {
+  const Double_t kLambdaMass = 1.115683;
+  const Double_t kPionMass   = 0.139570;
+  const Int_t kMaxDCAIter    = 5;
+}
+
+//-----------------------------------------------------------------------------
+StSigma1385Maker::StSigma1385Maker(const char* name, StPicoDstMaker* picoMaker,
+                                   StLambdaMaker* lambdaMaker, const char* outName)
+  : StMaker(name),
+    mPicoDstMaker(picoMaker),
+    mConfig(&ConfigManager::GetInstance().GetContext()),
+    mLambdaMaker(lambdaMaker),
+    mPicoDst(0),
+    mOutName(outName),
+    mEventCounter(0),
+    m_histManager(0),
+    mTrackViewMaker(0),
+    mBachelors(ArenaAllocator<Bachelor_t>(&mArena)),
+    mBachelorHelix(ArenaAllocator<StPhysicalHelixD>(&mArena)) {}
+
+//-----------------------------------------------------------------------------
+StSigma1385Maker::~StSigma1385Maker() {
+  if (m_histManager) {
+    delete m_histManager;
+    m_histManager = 0;
+  }
+}
+
+//-----------------------------------------------------------------------------
+StSigma1385Maker* createStSigma1385Maker(const char* name, StPicoDstMaker* picoMaker,
+                                         StLambdaMaker* lambdaMaker, const char* outName) {
+  return new StSigma1385Maker(name, picoMaker, lambdaMaker, outName);
+}
+
+extern "C" void* createStSigma1385MakerC(const char* name, void* picoMaker,
+                                         void* lambdaMaker, const char* outName) {
+  return (void*)createStSigma1385Maker(name, (StPicoDstMaker*)picoMaker,
+                                       (StLambdaMaker*)lambdaMaker, outName);
+}
+
+//-----------------------------------------------------------------------------
+Int_t StSigma1385Maker::Init() {
+  if (!mLambdaMaker) {
+    std::cerr << "[StSigma1385Maker] No StLambdaMaker given; it must run before this maker in the chain." << std::endl;
+    return kStErr;
+  }
+  std::string histPath = mConfig->GetHistConfigPath("hist_sigma1385");
+  if (histPath.empty()) {
+    std::cerr << "[StSigma1385Maker] GetHistConfigPath(\"hist_sigma1385\") returned empty; no histograms will be filled." << std::endl;
+    m_histManager = 0;
+    return kStOK;
+  }
+  m_histManager = new HistManager();
+  m_histManager->DisableTags(mConfig->GetMainConfigValue("hist_skip_tags"));  // e.g. "qa" in production
+  if (!m_histManager->LoadFromFile(histPath.c_str())) {
+    std::cerr << "[StSigma1385Maker] Failed to load hist config from " << histPath << std::endl;
+    delete m_histManager;
+    m_histManager = 0;
+    return kStOK;
+  }
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+void StSigma1385Maker::Clear(Option_t* opt) {
+  ArenaRelease(mBachelors);
+  ArenaRelease(mBachelorHelix);
+  mArena.Reset();
+}
+
+//-----------------------------------------------------------------------------
+Bool_t StSigma1385Maker::PassBachelorCuts(const StTrackView& tv, Int_t i) {
+  if (tv.charge[i] == 0) return kFALSE;
+  const Sigma1385CutConfig& sig = mConfig->GetSigma1385Cuts();
+  if (TMath::Abs(tv.nSigmaPion[i]) > sig.nSigmaPionForSigma) return kFALSE;
+  if (tv.dca[i] > sig.maxDCABachelor) return kFALSE;
+  return kTRUE;
+}
+
+//-----------------------------------------------------------------------------
+// DCA between the bachelor helix and the straight Lambda line through its decay
+// vertex (alternating projections; the Lambda does not bend)
+Double_t StSigma1385Maker::BachelorLambdaDCA(const StPhysicalHelixD& helix,
+                                             const TVector3& decayVtx, const TVector3& lambdaDir) {
+  StThreeVectorD l0(decayVtx.X(), decayVtx.Y(), decayVtx.Z());
+  StThreeVectorD u(lambdaDir.X(), lambdaDir.Y(), lambdaDir.Z());
+  StThreeVectorD onLine = l0;
+  StThreeVectorD onHelix = l0;
+  for (Int_t iter = 0; iter < kMaxDCAIter; iter++) {
+    onHelix = helix.at(helix.pathLength(onLine));
+    Double_t s = (onHelix - l0).dot(u);
+    onLine = l0 + s * u;
+  }
+  return (onHelix - onLine).mag();
+}
+
+//-----------------------------------------------------------------------------
+Int_t StSigma1385Maker::Make() {
+  if (!mPicoDstMaker || !mLambdaMaker) return kStWarn;
+  mPicoDst = mPicoDstMaker->picoDst();
+  if (!mPicoDst) return kStWarn;
+
+  StPicoEvent* event = mPicoDst->event();
+  if (!event) return kStWarn;
+
+  // Run quality and trigger selection before any histogram or track; then
+  // only events the StLambdaMaker accepted
+  if (!mRuns.Pass(mConfig->GetRunQuality(), event->runId(), event->eventId())) return kStOK;
+  if (!mTriggers.Pass(mConfig->GetEventCuts().triggers, *event)) return kStOK;
+  if (!mLambdaMaker->IsEventAccepted()) return kStOK;
+
+  mEventCounter++;
+  if (m_histManager) m_histManager->Fill("hN", 0);
+
+  const StLambdaMaker::LambdaList& lambdas = mLambdaMaker->GetLambdaCandidates();
+  if (m_histManager) m_histManager->Fill("hNLambda", lambdas.size());
+  if (lambdas.empty()) return kStOK;
+
+  const Sigma1385CutConfig& sig = mConfig->GetSigma1385Cuts();
+  TVector3 pVtx = event->primaryVertex();
+  Double_t bField = event->bField();
+
+  const StTrackView* view = &mOwnView;
+  if (mTrackViewMaker) {
+    view = &mTrackViewMaker->GetTrackView();
+  } else {
+    mOwnView.Fill(mPicoDst, pVtx, bField);
+  }
+  const StTrackView& tv = *view;
+
+  // Bachelor pions, selected once per event; momentum at the DCA to the PV
+  // from the helix (what StPicoTrack::gMom(pVtx, bField) computes)
+  StThreeVectorD pv(pVtx.X(), pVtx.Y(), pVtx.Z());
+  mBachelors.reserve(tv.nTracks);
+  mBachelorHelix.reserve(tv.nTracks);
+  for (Int_t i = 0; i < tv.nTracks; i++) {
+    if (!PassBachelorCuts(tv, i)) continue;
+    StThreeVectorF p(tv.gPx[i], tv.gPy[i], tv.gPz[i]);
+    StThreeVectorF o(tv.originX[i], tv.originY[i], tv.originZ[i]);
+    StPhysicalHelixD helix(p, o, bField * units::kilogauss, (Float_t)tv.charge[i]);
+    StThreeVectorD mom = helix.momentumAt(helix.pathLength(pv), bField * units::kilogauss);
+    Bachelor_t b;
+    b.index = i;
+    b.charge = tv.charge[i];
+    b.px = mom.x();
+    b.py = mom.y();
+    b.pz = mom.z();
+    mBachelors.push_back(b);
+    mBachelorHelix.push_back(helix);
+  }
+  if (m_histManager) m_histManager->Fill("hNBachelor", mBachelors.size());
+
+  for (size_t il = 0; il < lambdas.size(); il++) {
+    const StLambdaMaker::Lambda_t& lam = lambdas[il];
+    if (TMath::Abs(lam.mass - kLambdaMass) > sig.lambdaMassWindow) continue;
+
+    Double_t pLam2 = lam.px * lam.px + lam.py * lam.py + lam.pz * lam.pz;
+    Double_t eLam = TMath::Sqrt(pLam2 + lam.mass * lam.mass);
+
+    for (size_t ib = 0; ib < mBachelors.size(); ib++) {
+      const Bachelor_t& b = mBachelors[ib];
+      if (b.index == lam.posIndex || b.index == lam.negIndex) continue;
+
+      // Mass window first: plain four-vector sum, no vertexing
+      Double_t ePi = TMath::Sqrt(b.px * b.px + b.py * b.py + b.pz * b.pz + kPionMass * kPionMass);
+      Double_t sx = lam.px + b.px;
+      Double_t sy = lam.py + b.py;
+      Double_t sz = lam.pz + b.pz;
+      Double_t m2 = (eLam + ePi) * (eLam + ePi) - (sx * sx + sy * sy + sz * sz);
+      if (m2 <= 0) continue;
+      Double_t invMass = TMath::Sqrt(m2);
+      if (invMass < sig.minInvMass || invMass > sig.maxInvMass) continue;
+
+      // Bachelor - Lambda vertexing only for pairs inside the window
+      TVector3 decayVtx(lam.decayX, lam.decayY, lam.decayZ);
+      TVector3 lamDir(lam.px, lam.py, lam.pz);
+      lamDir = lamDir * (1.0 / TMath::Sqrt(pLam2));
+      Double_t dcaBL = BachelorLambdaDCA(mBachelorHelix[ib], decayVtx, lamDir);
+      if (dcaBL > sig.maxDCABachelorLambda) continue;
+
+      if (!m_histManager) continue;
+      Double_t pt = TMath::Sqrt(sx * sx + sy * sy);
+      m_histManager->Fill("hSigma_DCABachelorLambda", dcaBL);
+      if (lam.baryon > 0) {
+        if (b.charge > 0) {
+          m_histManager->Fill("hSigmaPlus_InvMass", invMass);
+          m_histManager->Fill("hSigmaPlus_InvMass_vs_Pt", pt, invMass);
+        } else {
+          m_histManager->Fill("hSigmaMinus_InvMass", invMass);
+          m_histManager->Fill("hSigmaMinus_InvMass_vs_Pt", pt, invMass);
+        }
+      } else {
+        if (b.charge < 0) {
+          m_histManager->Fill("hAntiSigmaMinus_InvMass", invMass);
+          m_histManager->Fill("hAntiSigmaMinus_InvMass_vs_Pt", pt, invMass);
+        } else {
+          m_histManager->Fill("hAntiSigmaPlus_InvMass", invMass);
+          m_histManager->Fill("hAntiSigmaPlus_InvMass_vs_Pt", pt, invMass);
+        }
+      }
+    }
+  }
+
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+Int_t StSigma1385Maker::Finish() {
+  if (mOutName != "") {
+    TFile* fout = new TFile(mOutName.Data(), "RECREATE");
+    if (fout && !fout->IsZombie()) {
+      fout->cd();
+      WriteHistograms();
+      fout->Close();
+    }
+    if (fout) delete fout;
+  }
+  std::cout << "StSigma1385Maker::Finish() processed " << mEventCounter << " events" << std::endl;
+  mRuns.Print("StSigma1385Maker::Finish() ");
+  mTriggers.Print(mConfig->GetEventCuts().triggers, "StSigma1385Maker::Finish() ");
+  std::cout << "StSigma1385Maker::Finish() arena: " << mArena.GetNBlockAllocs()
+            << " heap block allocation(s) in " << mEventCounter << " events, high-water "
+            << mArena.GetHighWater() / 1024.0 << " kB" << std::endl;
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+void StSigma1385Maker::WriteHistograms() {
+  if (m_histManager) m_histManager->Write();
+}
@@ -0,0 +1,80 @@
+#ifndef StSigma1385Maker_h
+#define StSigma1385Maker_h
+
+#include "StMaker.h"
+#include "StarClassLibrary/StPhysicalHelixD.hh"
+#include "EventArena.h"
+#include "TriggerSelection.h"
+#include "RunQuality.h"
+#include "../StTrackViewMaker/StTrackViewMaker.h"
+#include <vector>
+
+class StPicoDst;
+class StPicoDstMaker;
+class ConfigContext;
+class StPicoTrack;
+class StLambdaMaker;
+class TString;
+class HistManager;
+class TVector3;
+
+class StSigma1385Maker;
+
+StSigma1385Maker* createStSigma1385Maker(const char* name, StPicoDstMaker* picoMaker,
+                                         StLambdaMaker* lambdaMaker, const char* outName);
+extern "C" void* createStSigma1385MakerC(const char* name, void* picoMaker,
+                                         void* lambdaMaker, const char* outName);
+
+// Sigma(1385) -> Lambda pi. Runs after StLambdaMaker in the same chain and uses
+// its per-event Lambda buffer instead of redoing the V0 finding; events the
+// StLambdaMaker rejected are skipped.
+class StSigma1385Maker : public StMaker {
+public:
+  StSigma1385Maker(const char* name, StPicoDstMaker* picoMaker,
+                   StLambdaMaker* lambdaMaker, const char* outName);
+  virtual ~StSigma1385Maker();
+
+  virtual Int_t Init();
+  virtual Int_t Make();
+  virtual void Clear(Option_t* opt = "");
+  virtual Int_t Finish();
+
+  void WriteHistograms();
+
+  // Read tracks from a StTrackViewMaker earlier in the chain (else filled here)
+  void SetTrackViewMaker(StTrackViewMaker* viewMaker) { mTrackViewMaker = viewMaker; }
+
+  // Cuts and main.yaml keys from config instead of ConfigManager's default context
+  void SetConfigContext(const ConfigContext& config) { mConfig = &config; }
+
+private:
+  StPicoDstMaker* mPicoDstMaker;
+  const ConfigContext* mConfig;
+  StLambdaMaker* mLambdaMaker;
+  StPicoDst* mPicoDst;
+  TString mOutName;
+  Int_t mEventCounter;
+  HistManager* m_histManager;
+  StTrackViewMaker* mTrackViewMaker;
+  StTrackView mOwnView;          // used when no StTrackViewMaker is set
+  RunCounts mRuns;               // ConfigContext::GetRunQuality(), applied first in Make()
+  TriggerCounts mTriggers;       // EventCutConfig::triggers, applied next
+
+  // Bachelor pion (momentum at the DCA to the primary vertex)
+  struct Bachelor_t {
+    Int_t index;
+    Short_t charge;
+    Float_t px, py, pz;
+  };
+
+  // Per-event bachelor list on the maker's arena, reset in Clear()
+  EventArena mArena;
+  ArenaVector<Bachelor_t>::type mBachelors;
+  ArenaVector<StPhysicalHelixD>::type mBachelorHelix;
+
+  Bool_t PassBachelorCuts(const StTrackView& tv, Int_t i);
+  Double_t BachelorLambdaDCA(const StPhysicalHelixD& helix,
+                             const TVector3& decayVtx, const TVector3& lambdaDir);
+};
+
+#endif
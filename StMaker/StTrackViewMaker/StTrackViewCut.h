@@ -0,0 +1,99 @@
+#ifndef StTrackViewCut_h
+#define StTrackViewCut_h
+
+#include "StTrackViewMaker.h"
+#include "CutExpression.h"
+#include "TMath.h"
+#include <string>
+#include <vector>
+
+// TrackCutConfig::expression over the columns of an StTrackView, for the
+// analysis makers: Compile() at Init, Evaluate() once per event, then Pass(i)
+// in the track loop. Header-only; CutExpression itself is in libStarAnaConfig.
+//
+// Columns are the StTrackView names, plus px/py/pz for the primary momentum
+// and pT/eta/phi from it (computed per event only if the expression uses them).
+class StTrackViewCut {
+public:
+  StTrackViewCut() : mUsesPt(kFALSE), mUsesEta(kFALSE), mUsesPhi(kFALSE) {}
+
+  // kFALSE if expr does not parse or names an unknown column (see GetError())
+  Bool_t Compile(const std::string& expr) {
+    mError.clear();
+    if (!mExpr.Compile(expr)) return kFALSE;
+    mUsesPt = mExpr.Uses("pT");
+    mUsesEta = mExpr.Uses("eta");
+    mUsesPhi = mExpr.Uses("phi");
+    StTrackView empty;
+    Bind(empty);
+    if (!mExpr.CheckBindings()) {
+      mError = mExpr.GetError() + " in \"" + expr + "\"";
+      mExpr.Reset();
+      return kFALSE;
+    }
+    return kTRUE;
+  }
+
+  Bool_t IsEmpty() const { return mExpr.IsEmpty(); }
+  std::string GetError() const { return mError.empty() ? mExpr.GetError() : mError; }
+  const CutExpression& GetExpression() const { return mExpr; }
+
+  // Evaluate for every track of tv; returns the number passing
+  Int_t Evaluate(const StTrackView& tv) {
+    if (mExpr.IsEmpty()) return tv.nTracks;
+    if (mUsesPt || mUsesEta || mUsesPhi) FillKinematics(tv);
+    Bind(tv);
+    return mExpr.Evaluate(tv.nTracks, mPass);
+  }
+
+  // Track i passed (valid after Evaluate() for this event)
+  Bool_t Pass(Int_t i) const { return mExpr.IsEmpty() || mPass[i] != 0; }
+
+private:
+  CutExpression mExpr;
+  std::string mError;
+  std::vector<UChar_t> mPass;
+  std::vector<Float_t> mPt, mEta, mPhi;
+  Bool_t mUsesPt, mUsesEta, mUsesPhi;
+
+  template <class T>
+  static const T* Column(const std::vector<T>& v) { return v.empty() ? 0 : &v[0]; }
+
+  void Bind(const StTrackView& tv) {
+    mExpr.Bind("pT", Column(mPt));
+    mExpr.Bind("eta", Column(mEta));
+    mExpr.Bind("phi", Column(mPhi));
+    mExpr.Bind("charge", Column(tv.charge));
+    mExpr.Bind("nHitsFit", Column(tv.nHitsFit));
+    mExpr.Bind("nHitsMax", Column(tv.nHitsMax));
+    mExpr.Bind("nHitsDedx", Column(tv.nHitsDedx));
+    mExpr.Bind("chi2", Column(tv.chi2));
+    mExpr.Bind("dEdx", Column(tv.dEdx));
+    mExpr.Bind("dca", Column(tv.dca));
+    mExpr.Bind("nSigmaPion", Column(tv.nSigmaPion));
+    mExpr.Bind("nSigmaKaon", Column(tv.nSigmaKaon));
+    mExpr.Bind("nSigmaProton", Column(tv.nSigmaProton));
+    mExpr.Bind("nSigmaElectron", Column(tv.nSigmaElectron));
+    mExpr.Bind("beta", Column(tv.beta));
+    mExpr.Bind("px", Column(tv.pPx));
+    mExpr.Bind("py", Column(tv.pPy));
+    mExpr.Bind("pz", Column(tv.pPz));
+  }
+
+  // pT / eta / phi of the primary momentum, as TVector3 Perp/PseudoRapidity/Phi
+  void FillKinematics(const StTrackView& tv) {
+    const Int_t n = tv.nTracks;
+    mPt.resize(n);
+    mEta.resize(n);
+    mPhi.resize(n);
+    for (Int_t i = 0; i < n; i++) {
+      const Float_t px = tv.pPx[i], py = tv.pPy[i], pz = tv.pPz[i];
+      const Float_t pt = TMath::Sqrt(px * px + py * py);
+      mPt[i] = pt;
+      if (mUsesEta) mEta[i] = (pt > 0) ? TMath::ASinH(pz / pt) : (pz >= 0 ? 1e10 : -1e10);
+      if (mUsesPhi) mPhi[i] = TMath::ATan2(py, px);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "StTrackViewMaker.h"
+#include "StPicoDstMaker/StPicoDstMaker.h"
+#include "StPicoEvent/StPicoDst.h"
+#include "StPicoEvent/StPicoTrack.h"
+#include "StPicoEvent/StPicoEvent.h"
+#include "StPicoEvent/StPicoBTofPidTraits.h"
+
+#include <iostream>
+
+//-----------------------------------------------------------------------------
+void StTrackView::Clear() {
+  nTracks = 0;
+  charge.clear();
+  nHitsFit.clear(); nHitsMax.clear(); nHitsDedx.clear();
+  chi2.clear(); dEdx.clear();
+  gPx.clear(); gPy.clear(); gPz.clear();
+  pPx.clear(); pPy.clear(); pPz.clear();
+  originX.clear(); originY.clear(); originZ.clear();
+  dca.clear();
+  nSigmaPion.clear(); nSigmaKaon.clear(); nSigmaProton.clear(); nSigmaElectron.clear();
+  btofIndex.clear(); beta.clear();
+}
+
+//-----------------------------------------------------------------------------
+void StTrackView::Fill(StPicoDst* pico, const TVector3& pVtx, Float_t bz) {
+  Clear();
+  vx = pVtx.X();
+  vy = pVtx.Y();
+  vz = pVtx.Z();
+  bField = bz;
+  if (!pico) return;
+
+  Int_t n = pico->numberOfTracks();
+  nTracks = n;
+  charge.resize(n);
+  nHitsFit.resize(n); nHitsMax.resize(n); nHitsDedx.resize(n);
+  chi2.resize(n); dEdx.resize(n);
+  gPx.resize(n); gPy.resize(n); gPz.resize(n);
+  pPx.resize(n); pPy.resize(n); pPz.resize(n);
+  originX.resize(n); originY.resize(n); originZ.resize(n);
+  dca.resize(n);
+  nSigmaPion.resize(n); nSigmaKaon.resize(n); nSigmaProton.resize(n); nSigmaElectron.resize(n);
+  btofIndex.resize(n); beta.resize(n);
+
+  for (Int_t i = 0; i < n; i++) {
+    StPicoTrack* trk = pico->track(i);
+    if (!trk) {
+      charge[i] = 0;
+      nHitsFit[i] = 0; nHitsMax[i] = 1; nHitsDedx[i] = 0;
+      chi2[i] = 0; dEdx[i] = 0;
+      gPx[i] = gPy[i] = gPz[i] = 0;
+      pPx[i] = pPy[i] = pPz[i] = 0;
+      originX[i] = originY[i] = originZ[i] = 0;
+      dca[i] = 999.0;
+      nSigmaPion[i] = nSigmaKaon[i] = nSigmaProton[i] = nSigmaElectron[i] = 999.0;
+      btofIndex[i] = -1;
+      beta[i] = 0;
+      continue;
+    }
+    charge[i] = trk->charge();
+    nHitsFit[i] = trk->nHitsFit();
+    nHitsMax[i] = trk->nHitsMax();
+    nHitsDedx[i] = trk->nHitsDedx();
+    chi2[i] = trk->chi2();
+    dEdx[i] = trk->dEdx();
+    TVector3 g = trk->gMom();
+    gPx[i] = g.X(); gPy[i] = g.Y(); gPz[i] = g.Z();
+    TVector3 p = trk->pMom();
+    pPx[i] = p.X(); pPy[i] = p.Y(); pPz[i] = p.Z();
+    TVector3 o = trk->origin();
+    originX[i] = o.X(); originY[i] = o.Y(); originZ[i] = o.Z();
+    dca[i] = trk->gDCA(vx, vy, vz);
+    nSigmaPion[i] = trk->nSigmaPion();
+    nSigmaKaon[i] = trk->nSigmaKaon();
+    nSigmaProton[i] = trk->nSigmaProton();
+    nSigmaElectron[i] = trk->nSigmaElectron();
+    btofIndex[i] = trk->bTofPidTraitsIndex();
+    beta[i] = 0;
+    if (btofIndex[i] >= 0) {
+      StPicoBTofPidTraits* tof = pico->btofPidTraits(btofIndex[i]);
+      if (tof) beta[i] = tof->btofBeta();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+StTrackViewMaker::StTrackViewMaker(const char* name, StPicoDstMaker* picoMaker)
+  : StMaker(name),
+    mPicoDstMaker(picoMaker),
+    mPending(kFALSE),
+    mEventCounter(0),
+    mNFilled(0) {}
+
+//-----------------------------------------------------------------------------
+StTrackViewMaker::~StTrackViewMaker() {}
+
+//-----------------------------------------------------------------------------
+StTrackViewMaker* createStTrackViewMaker(const char* name, StPicoDstMaker* picoMaker) {
+  return new StTrackViewMaker(name, picoMaker);
+}
+
+extern "C" void* createStTrackViewMakerC(const char* name, void* picoMaker) {
+  return (void*)createStTrackViewMaker(name, (StPicoDstMaker*)picoMaker);
+}
+
+//-----------------------------------------------------------------------------
+Int_t StTrackViewMaker::Init() {
+  if (!mPicoDstMaker) {
+    std::cerr << "[StTrackViewMaker] No StPicoDstMaker given." << std::endl;
+    return kStErr;
+  }
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+void StTrackViewMaker::Clear(Option_t* opt) {
+  mPending = kFALSE;
+  mView.Clear();
+}
+
+//-----------------------------------------------------------------------------
+Int_t StTrackViewMaker::Make() {
+  mPending = kFALSE;
+  if (!mPicoDstMaker) return kStWarn;
+  StPicoDst* pico = mPicoDstMaker->picoDst();
+  if (!pico || !pico->event()) return kStWarn;
+  mEventCounter++;
+  mPending = kTRUE;
+  return kStOK;
+}
+
+//-----------------------------------------------------------------------------
+void StTrackViewMaker::FillView() {
+  mPending = kFALSE;
+  StPicoDst* pico = mPicoDstMaker->picoDst();
+  StPicoEvent* event = pico->event();
+  mNFilled++;
+  mView.Fill(pico, event->primaryVertex(), event->bField());
+}
+
+//-----------------------------------------------------------------------------
+Int_t StTrackViewMaker::Finish() {
+  std::cout << "StTrackViewMaker::Finish() processed " << mEventCounter << " events, tracks read for "
+            << mNFilled << std::endl;
+  return kStOK;
+}
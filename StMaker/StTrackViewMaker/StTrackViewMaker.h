@@ -0,0 +1,79 @@
+#ifndef StTrackViewMaker_h
+#define StTrackViewMaker_h
+
+#include "StMaker.h"
+#include "TVector3.h"
+#include <vector>
+
+class StPicoDst;
+class StPicoDstMaker;
+
+class StTrackViewMaker;
+
+StTrackViewMaker* createStTrackViewMaker(const char* name, StPicoDstMaker* picoMaker);
+extern "C" void* createStTrackViewMakerC(const char* name, void* picoMaker);
+
+// Per-event structure-of-arrays copy of the StPicoTrack fields used by the
+// analysis makers. Row i is StPicoDst::track(i); a missing track is left with
+// charge 0 and nHitsFit 0 so it fails every track cut. Fill() resizes the
+// columns without releasing capacity.
+struct StTrackView {
+  Int_t nTracks;
+  Float_t vx, vy, vz;                  // primary vertex used for dca
+  Float_t bField;                      // kG
+
+  std::vector<Short_t> charge;
+  std::vector<Short_t> nHitsFit, nHitsMax, nHitsDedx;
+  std::vector<Float_t> chi2;
+  std::vector<Float_t> dEdx;
+  std::vector<Float_t> gPx, gPy, gPz;  // global momentum at the origin
+  std::vector<Float_t> pPx, pPy, pPz;  // primary momentum (0 if not primary)
+  std::vector<Float_t> originX, originY, originZ;
+  std::vector<Float_t> dca;            // |gDCA| to (vx, vy, vz)
+  std::vector<Float_t> nSigmaPion, nSigmaKaon, nSigmaProton, nSigmaElectron;
+  std::vector<Int_t>   btofIndex;      // bTofPidTraitsIndex(), -1 if not matched
+  std::vector<Float_t> beta;           // btofBeta(), 0 if not matched
+
+  StTrackView() : nTracks(0), vx(0), vy(0), vz(0), bField(0) {}
+
+  void Fill(StPicoDst* pico, const TVector3& pVtx, Float_t bz);
+  void Clear();
+
+  TVector3 GMom(Int_t i) const { return TVector3(gPx[i], gPy[i], gPz[i]); }
+  TVector3 PMom(Int_t i) const { return TVector3(pPx[i], pPy[i], pPz[i]); }
+  TVector3 Origin(Int_t i) const { return TVector3(originX[i], originY[i], originZ[i]); }
+};
+
+// Shares one StTrackView per event between the analysis makers, so the
+// StPicoTrack accessors are paid once however many of them follow. The view is
+// filled on the first GetTrackView() of an event, i.e. after the asking
+// maker's run, trigger and event cuts: events every maker rejects never have
+// their tracks read.
+class StTrackViewMaker : public StMaker {
+public:
+  StTrackViewMaker(const char* name, StPicoDstMaker* picoMaker);
+  virtual ~StTrackViewMaker();
+
+  virtual Int_t Init();
+  virtual Int_t Make();
+  virtual void Clear(Option_t* opt = "");
+  virtual Int_t Finish();
+
+  // View of the current event (valid after this maker's Make()); filled here
+  // on the first call of the event
+  const StTrackView& GetTrackView() {
+    if (mPending) FillView();
+    return mView;
+  }
+
+private:
+  void FillView();
+
+  StPicoDstMaker* mPicoDstMaker;
+  StTrackView mView;
+  Bool_t mPending;               // Make() ran, view not filled yet
+  Int_t mEventCounter;
+  Int_t mNFilled;
+};
+
+#endif
@@ -3,7 +3,7 @@
 
 #include <TVector3.h>
 
-// Helper structure for track information
+// Helper structure for track information (one row; per-event lists are TrackBlock)
 struct TrackCandidate {
   Int_t eventIndex;
   Float_t pT;
@@ -21,6 +21,9 @@ struct TrackCandidate {
   Float_t beta;
   Float_t mass2;
   Bool_t tofMatch;
+  Float_t originX;   // helix reference point (global track origin) [cm]
+  Float_t originY;
+  Float_t originZ;
   
   // Helper function to get momentum vector
   TVector3 GetMomentum() const {
@@ -45,6 +48,8 @@ struct EventCandidate {
   Float_t psi2;
   Int_t nTracks;
   Float_t vzVpd;
+  Float_t bField;    // magnetic field [kGauss]
+  Bool_t hasHelix;   // bField and track origins were read (see V0Reconstructor)
 };
 
 #endif
@@ -0,0 +1,101 @@
+#ifndef CONFIG_CONTEXT_H
+#define CONFIG_CONTEXT_H
+
+#include "Rtypes.h"
+#include <map>
+#include <string>
+
+// Forward declarations
+class EventCutConfig;
+class TrackCutConfig;
+class PIDCutConfig;
+class V0CutConfig;
+class PhiCutConfig;
+class LambdaCutConfig;
+class Lambda1520CutConfig;
+class Sigma1385CutConfig;
+class MixingConfig;
+class RunQuality;
+
+/** All cuts and main.yaml keys of one analysis, loaded from a mainconf file.
+ *
+ *  A context owns its own cut config objects and is read-only once constructed,
+ *  so several contexts (e.g. cut variations) can live in one process and one
+ *  context can be shared by makers running on different threads. Makers,
+ *  TreeReader, EventMixer and V0Reconstructor take the context explicitly
+ *  (SetConfigContext / constructor); without one they use the default context
+ *  of ConfigManager, which is what ConfigManager::LoadConfig and the
+ *  XxxCutConfig::GetInstance() / CutConfig:: accessors refer to. */
+class ConfigContext {
+public:
+  /** Load mainConfigPath and every cut file it references; see IsValid(). */
+  explicit ConfigContext(const Char_t* mainConfigPath);
+  ~ConfigContext();
+
+  /** kFALSE if the main config or one of its cut files failed to parse
+   *  (missing cut files keep their defaults, as with ConfigManager). */
+  Bool_t IsValid() const { return m_valid; }
+
+  /** Main config this context was loaded from. */
+  const std::string& GetMainConfigPath() const { return m_mainConfigPath; }
+
+  /** Full path for the hist config of main.yaml key (default "hist"); empty if
+   *  the key is missing or its value empty. */
+  std::string GetHistConfigPath(const std::string& key = "hist") const;
+
+  /** True if main.yaml has the given key. */
+  Bool_t HasMainConfigKey(const std::string& key) const;
+
+  /** Plain (non-path) value of a main.yaml key, trimmed; empty if missing. */
+  std::string GetMainConfigValue(const std::string& key) const;
+
+  /** anaName from analysis_info (mainconf key "analysis"); empty if not set. */
+  const std::string& GetAnaName() const { return m_anaName; }
+
+  // Cut configs of this context
+  const EventCutConfig& GetEventCuts() const { return *eventCuts; }
+  const TrackCutConfig& GetTrackCuts() const { return *trackCuts; }
+  const PIDCutConfig& GetPIDCuts() const { return *pidCuts; }
+  const V0CutConfig& GetV0Cuts() const { return *v0Cuts; }
+  const PhiCutConfig& GetPhiCuts() const { return *phiCuts; }
+  const LambdaCutConfig& GetLambdaCuts() const { return *lambdaCuts; }
+  const Lambda1520CutConfig& GetLambda1520Cuts() const { return *lambda1520Cuts; }
+  const Sigma1385CutConfig& GetSigma1385Cuts() const { return *sigma1385Cuts; }
+  const MixingConfig& GetMixingConfig() const { return *mixingConfig; }
+
+  /** Good/bad run lists of analysis_info (dataset.goodRunList, dataset.badRunList). */
+  const RunQuality& GetRunQuality() const { return *runQuality; }
+
+private:
+  // ConfigManager keeps the default context: created with defaults only, then
+  // reloaded in place by LoadConfig, with mutable access for the legacy API
+  friend class ConfigManager;
+  ConfigContext();
+  ConfigContext(const ConfigContext&);
+  ConfigContext& operator=(const ConfigContext&);
+
+  void Create();
+  Bool_t Load(const Char_t* mainConfigPath);
+  Bool_t LoadConfigFile(const std::string& basePath, const std::string& key);
+  Bool_t ParseAnalysisInfoAnaName(const std::string& analysisInfoPath);
+  Bool_t LoadRunQuality(const std::string& analysisInfoPath);
+
+  EventCutConfig* eventCuts;
+  TrackCutConfig* trackCuts;
+  PIDCutConfig* pidCuts;
+  V0CutConfig* v0Cuts;
+  PhiCutConfig* phiCuts;
+  LambdaCutConfig* lambdaCuts;
+  Lambda1520CutConfig* lambda1520Cuts;
+  Sigma1385CutConfig* sigma1385Cuts;
+  MixingConfig* mixingConfig;
+  RunQuality* runQuality;
+
+  Bool_t m_valid;
+  std::string m_mainConfigPath;
+  std::map<std::string, std::string> m_mainConfigValues;  ///< Parsed key-value from main.yaml
+  std::string m_configBasePath;  ///< Project root (path before /config/, trailing slash included)
+  std::string m_anaName;        ///< From analysis_info (key analysis.anaName)
+};
+
+#endif
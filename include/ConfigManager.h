@@ -2,42 +2,50 @@
 #define CONFIG_MANAGER_H
 
 #include "Rtypes.h"
-#include <map>
 #include <string>
+#include "ConfigContext.h"
 
-// Forward declarations
-class EventCutConfig;
-class TrackCutConfig;
-class PIDCutConfig;
-class V0CutConfig;
-class PhiCutConfig;
-class LambdaCutConfig;
-class Lambda1520CutConfig;
-class Sigma1385CutConfig;
-class MixingConfig;
-
+/** Process-wide default ConfigContext (the singleton API).
+ *  LoadConfig reloads the default context in place, so references taken from it
+ *  stay valid; it is not meant to be called while makers are running. Code that
+ *  needs several configurations, or runs on several threads, builds its own
+ *  ConfigContext and passes it explicitly instead. */
 class ConfigManager {
 public:
   static ConfigManager& GetInstance();
   Bool_t LoadConfig(const Char_t* mainConfigPath = "config/main.yaml");
 
+  /** The default context (what the getters below and XxxCutConfig::GetInstance() refer to). */
+  const ConfigContext& GetContext() const { return m_context; }
+
   /** Return full path for hist config from main.yaml key "hist".
    *  Returns empty string if key missing or value empty. */
   std::string GetHistConfigPath();
 
+  /** Same as GetHistConfigPath() for another main.yaml key (e.g. "hist_sigma1385"),
+   *  so several makers in one chain can each have their own hist config. */
+  std::string GetHistConfigPath(const std::string& key);
+
+  /** True if main.yaml has the given key (e.g. an optional per-maker "hist_phi"). */
+  Bool_t HasMainConfigKey(const std::string& key) const;
+
+  /** Plain (non-path) value of a main.yaml key, trimmed; empty if missing. */
+  std::string GetMainConfigValue(const std::string& key) const;
+
   /** Return anaName from analysis_info (mainconf key "analysis"). Empty if not set. */
   std::string GetAnaName() const;
 
-  // Access to cut config classes
-  EventCutConfig& GetEventCuts();
-  TrackCutConfig& GetTrackCuts();
-  PIDCutConfig& GetPIDCuts();
-  V0CutConfig& GetV0Cuts();
-  PhiCutConfig& GetPhiCuts();
-  LambdaCutConfig& GetLambdaCuts();
-  Lambda1520CutConfig& GetLambda1520Cuts();
-  Sigma1385CutConfig& GetSigma1385Cuts();
-  MixingConfig& GetMixingConfig();
+  // Cut config classes of the default context, read-only: only LoadConfig()
+  // changes them (a maker with other cuts gets its own ConfigContext)
+  const EventCutConfig& GetEventCuts() const;
+  const TrackCutConfig& GetTrackCuts() const;
+  const PIDCutConfig& GetPIDCuts() const;
+  const V0CutConfig& GetV0Cuts() const;
+  const PhiCutConfig& GetPhiCuts() const;
+  const LambdaCutConfig& GetLambdaCuts() const;
+  const Lambda1520CutConfig& GetLambda1520Cuts() const;
+  const Sigma1385CutConfig& GetSigma1385Cuts() const;
+  const MixingConfig& GetMixingConfig() const;
 
 private:
   ConfigManager();
@@ -45,26 +53,8 @@ private:
   ConfigManager(const ConfigManager&);
   ConfigManager& operator=(const ConfigManager&);
 
-  Bool_t ParseMainConfig(const Char_t* filename);
-  Bool_t LoadConfigFile(const Char_t* basePath, const Char_t* relativePath, const Char_t* configType);
-
-  EventCutConfig* eventCuts;
-  TrackCutConfig* trackCuts;
-  PIDCutConfig* pidCuts;
-  V0CutConfig* v0Cuts;
-  PhiCutConfig* phiCuts;
-  LambdaCutConfig* lambdaCuts;
-  Lambda1520CutConfig* lambda1520Cuts;
-  Sigma1385CutConfig* sigma1385Cuts;
-  MixingConfig* mixingConfig;
-
+  ConfigContext m_context;
   Bool_t isLoaded;
-  std::map<std::string, std::string> m_mainConfigValues;  ///< Parsed key-value from main.yaml
-  std::string m_configBasePath;  ///< Project root (path before /config/, trailing slash included)
-  std::string m_anaName;        ///< From analysis_info (key analysis.anaName)
-
-  Bool_t ParseAnalysisInfoAnaName(const std::string& analysisInfoPath);
 };
 
 #endif
-
@@ -118,6 +118,9 @@ namespace CutConfig {
     inline Double_t nSigmaPionForSigma() { return Get().nSigmaPionForSigma; }
     inline Double_t minInvMass() { return Get().minInvMass; }
     inline Double_t maxInvMass() { return Get().maxInvMass; }
+    inline Double_t lambdaMassWindow() { return Get().lambdaMassWindow; }
+    inline Double_t maxDCABachelor() { return Get().maxDCABachelor; }
+    inline Double_t maxDCABachelorLambda() { return Get().maxDCABachelorLambda; }
   }
 
   // ----------------------------------------
@@ -0,0 +1,128 @@
+#ifndef CUT_EXPRESSION_H
+#define CUT_EXPRESSION_H
+
+#include <string>
+#include <vector>
+#include "Rtypes.h"
+
+// Cut written as an expression over per-track columns, e.g.
+//   abs(nSigmaKaon) < 2 && dca < 2.0 && nHitsFit/nHitsMax > 0.52
+// Compile() parses the string once (at Init) into a short stack program;
+// Evaluate() then runs each instruction over a chunk of rows at a time, so the
+// per-row cost is a few tight column loops instead of a tree walk per track.
+//
+// Syntax: numbers, column names, + - * /, < <= > >= == !=, && || !, parentheses
+// and the functions abs(x), sqrt(x), min(x, y), max(x, y). Everything is
+// evaluated in Float_t; a comparison gives 1 or 0 and any non-zero value is true.
+// Both sides of && and || are always evaluated (no short-circuit per row).
+//
+// Identifiers are not fixed by the parser: every distinct name becomes a
+// variable slot, to be bound to a column with Bind() before Evaluate(). The
+// columns must be bound again whenever their storage may have moved (usually
+// once per event).
+class CutExpression {
+public:
+  CutExpression();
+
+  // Parse expr; on failure returns kFALSE, GetError() says why and the
+  // expression is left empty (which accepts every row)
+  Bool_t Compile(const std::string& expr);
+  void Reset();
+
+  Bool_t IsEmpty() const { return fCode.empty(); }
+  const std::string& GetSource() const { return fSource; }
+  const std::string& GetError() const { return fError; }
+
+  // Variables referenced by the expression
+  Int_t GetNVariables() const { return (Int_t)fVars.size(); }
+  const std::string& GetVariable(Int_t slot) const { return fVars[slot].name; }
+  Int_t FindVariable(const std::string& name) const;  // -1 if not used
+  Bool_t Uses(const std::string& name) const { return FindVariable(name) >= 0; }
+
+  // Bind a variable to a column of at least n rows (n given to Evaluate).
+  // Returns kFALSE if the expression does not use name (not an error).
+  Bool_t Bind(const std::string& name, const Float_t* column);
+  Bool_t Bind(const std::string& name, const Int_t* column);
+  Bool_t Bind(const std::string& name, const Short_t* column);
+  Bool_t Bind(const std::string& name, const Char_t* column);
+  Bool_t Bind(const std::string& name, const UChar_t* column);
+
+  // kFALSE (with GetError() naming it) if a variable has no column
+  Bool_t CheckBindings();
+
+  // out[i] = 1 if row i passes, else 0, for rows [0, n). Returns the number
+  // of passing rows. An empty expression passes every row.
+  Int_t Evaluate(Int_t n, UChar_t* out);
+  Int_t Evaluate(Int_t n, std::vector<UChar_t>& out);
+
+  // Print the compiled program (for checking what a YAML cut turned into)
+  void Print() const;
+
+  // Instructions (public for the evaluator in CutExpression.cpp)
+  enum OpCode {
+    kLoad, kConst,
+    kNeg, kNot, kAbs, kSqrt,
+    kAdd, kSub, kMul, kDiv, kMin, kMax,
+    kLt, kLe, kGt, kGe, kEq, kNe, kAnd, kOr
+  };
+  enum ColumnType { kFloat, kInt, kShort, kChar, kUChar };
+  enum Operand { kStack = -1, kImm = -2 };  // else a variable slot
+
+  // lhs: kStack, or a variable slot (the result is then pushed).
+  // rhs (binary ops): kStack (popped), kImm, or a variable slot.
+  // So 'dca < 2' is one instruction and a Float_t column is read in place.
+  // andInto: the result is and-ed into the slot below instead of kept, which
+  // folds the '&&' of a cut list into the op producing its right operand.
+  struct Instr {
+    Int_t op;
+    Int_t lhs;
+    Int_t rhs;
+    Float_t imm;      // kConst value, or right operand if rhs == kImm
+    Bool_t andInto;
+  };
+
+  struct Variable {
+    std::string name;
+    Int_t type;       // ColumnType of the bound column
+    const void* data; // first row (0 for an empty column)
+    Bool_t bound;
+  };
+
+  enum { kChunk = 256 };  // rows per pass through the program
+
+private:
+  std::string fSource;
+  std::string fError;
+  std::vector<Instr> fCode;
+  std::vector<Variable> fVars;
+  Int_t fMaxDepth;
+  std::vector<Float_t> fStack;   // fMaxDepth * kChunk
+  std::vector<Float_t> fConvert; // non-Float_t columns of the current chunk, kChunk per slot
+  std::vector<const Float_t*> fColumn;  // current chunk of each variable
+
+  // Recursive-descent parser state (valid only inside Compile)
+  const char* fPos;
+  const char* fBegin;
+
+  Bool_t ParseOr();
+  Bool_t ParseAnd();
+  Bool_t ParseCompare();
+  Bool_t ParseAdd();
+  Bool_t ParseMul();
+  Bool_t ParseUnary();
+  Bool_t ParsePrimary();
+  void SkipSpace();
+  Bool_t Accept(const char* token);
+  Bool_t Fail(const std::string& what);
+
+  // Emit with constant folding and column/constant operands fused into the op
+  void EmitConst(Float_t value);
+  void EmitLoad(const std::string& name);
+  void EmitUnary(Int_t op);
+  void EmitBinary(Int_t op);
+
+  Bool_t BindColumn(const std::string& name, Int_t type, const void* data);
+  void Run(Int_t first, Int_t n);  // program over rows [first, first + n) into fStack[0..n)
+};
+
+#endif
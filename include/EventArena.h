@@ -0,0 +1,149 @@
+#ifndef EVENT_ARENA_H
+#define EVENT_ARENA_H
+
+#include "Rtypes.h"
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * Per-event bump allocator (header-only, C++98 so Makers can use it).
+ *
+ * A Maker owns one EventArena and declares its per-event candidate lists as
+ * ArenaVector<T>::type. Allocate() hands out memory from a few large blocks;
+ * deallocation is a no-op and Reset() rewinds all blocks in one step. Blocks are
+ * kept across Reset(), so once the first events have sized the arena the
+ * per-event containers do no heap allocation.
+ *
+ * Usage in a Maker:
+ *   Make():   mList.reserve(nTracks); ... mList.push_back(x);
+ *   Clear():  ArenaRelease(mList); ... mArena.Reset();
+ *
+ * Every container drawing from the arena must be released (ArenaRelease) before
+ * Reset(), since its storage is handed out again afterwards.
+ */
+class EventArena {
+public:
+  explicit EventArena(size_t blockSize = 1 << 20)
+    : mBlockSize(blockSize), mCurrent(0), mOffset(0),
+      mBytesUsed(0), mHighWater(0), mNBlockAllocs(0) {}
+
+  ~EventArena() {
+    for (size_t i = 0; i < mBlocks.size(); i++) delete[] mBlocks[i].data;
+  }
+
+  // Memory for 'bytes' bytes, aligned to kAlign; valid until Reset()
+  void* Allocate(size_t bytes) {
+    bytes = (bytes + kAlign - 1) & ~(kAlign - 1);
+    while (mCurrent < mBlocks.size()) {
+      Block& b = mBlocks[mCurrent];
+      if (mOffset + bytes <= b.size) {
+        void* p = b.data + mOffset;
+        mOffset += bytes;
+        mBytesUsed += bytes;
+        if (mBytesUsed > mHighWater) mHighWater = mBytesUsed;
+        return p;
+      }
+      mCurrent++;
+      mOffset = 0;
+    }
+    Block b;
+    b.size = (bytes > mBlockSize) ? bytes : mBlockSize;
+    b.data = new char[b.size];
+    mNBlockAllocs++;
+    mBlocks.push_back(b);
+    mCurrent = mBlocks.size() - 1;
+    mOffset = bytes;
+    mBytesUsed += bytes;
+    if (mBytesUsed > mHighWater) mHighWater = mBytesUsed;
+    return b.data;
+  }
+
+  // Rewind to the first block; blocks are kept for the next event
+  void Reset() {
+    mCurrent = 0;
+    mOffset = 0;
+    mBytesUsed = 0;
+  }
+
+  size_t GetNBlocks() const { return mBlocks.size(); }
+  Long64_t GetNBlockAllocs() const { return mNBlockAllocs; }  // heap allocations so far
+  size_t GetBytesUsed() const { return mBytesUsed; }
+  size_t GetHighWater() const { return mHighWater; }          // max bytes used in one event
+
+private:
+  enum { kAlign = 16 };
+
+  struct Block {
+    char* data;
+    size_t size;
+  };
+
+  std::vector<Block> mBlocks;
+  size_t mBlockSize;
+  size_t mCurrent;
+  size_t mOffset;
+  size_t mBytesUsed;
+  size_t mHighWater;
+  Long64_t mNBlockAllocs;
+
+  EventArena(const EventArena&);
+  EventArena& operator=(const EventArena&);
+};
+
+// STL allocator drawing from an EventArena (plain operator new without an arena)
+template <class T>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <class U> struct rebind { typedef ArenaAllocator<U> other; };
+
+  ArenaAllocator() : mArena(0) {}
+  explicit ArenaAllocator(EventArena* arena) : mArena(arena) {}
+  template <class U> ArenaAllocator(const ArenaAllocator<U>& o) : mArena(o.arena()) {}
+
+  EventArena* arena() const { return mArena; }
+
+  pointer allocate(size_type n, const void* = 0) {
+    if (mArena) return static_cast<pointer>(mArena->Allocate(n * sizeof(T)));
+    return static_cast<pointer>(::operator new(n * sizeof(T)));
+  }
+  void deallocate(pointer p, size_type) {
+    if (!mArena) ::operator delete(p);
+  }
+
+  void construct(pointer p, const T& val) { new (static_cast<void*>(p)) T(val); }
+  void destroy(pointer p) { p->~T(); }
+  pointer address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+  size_type max_size() const { return size_t(-1) / sizeof(T); }
+
+private:
+  EventArena* mArena;
+};
+
+template <class T, class U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+template <class T, class U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() != b.arena(); }
+
+// std::vector on an EventArena (C++98 stand-in for a template alias)
+template <class T>
+struct ArenaVector {
+  typedef std::vector<T, ArenaAllocator<T> > type;
+};
+
+// Destroy the elements and drop the storage, keeping the arena; call before EventArena::Reset()
+template <class V>
+inline void ArenaRelease(V& v) {
+  V(v.get_allocator()).swap(v);
+}
+
+#endif
@@ -6,51 +6,55 @@
 #include <TMath.h>
 #include <TRandom.h>
 #include "CandidateTypes.h"
+#include "TrackBlock.h"
 #include "CutConfig.h"
 #include "TreeReader.h"
 
 // Structure to store event and its tracks for mixing
 struct MixingEvent {
   EventCandidate event;
-  std::vector<TrackCandidate> tracks;
+  TrackBlock tracks;
 };
 
 class EventMixer {
 public:
   EventMixer();
+  // Mixing bins from config instead of ConfigManager's default context
+  explicit EventMixer(const ConfigContext& config);
   ~EventMixer();
   
   // Initialize mixing bins
   void InitializeMixingBins();
   
   // Add event to mixing pool
-  void AddEvent(const EventCandidate& evt, const std::vector<TrackCandidate>& tracks);
+  void AddEvent(const EventCandidate& evt, const TrackBlock& tracks);
   
   // Get mixing bin index for an event
   Int_t GetMixingBinIndex(const EventCandidate& evt) const;
   
   // Generate mixed pairs (background)
   // Returns vector of invariant masses from mixed events
-  std::vector<Double_t> GenerateMixedPairs(const std::vector<TrackCandidate>& tracks1,
-                                            const std::vector<TrackCandidate>& tracks2,
+  std::vector<Double_t> GenerateMixedPairs(const TrackBlock& tracks1,
+                                            const TrackBlock& tracks2,
                                             Int_t nPairs = 1000) const;
   
   // Generate mixed pairs with invariant mass calculation
+  // (massFunc(tracks1, idx1, tracks2, idx2), e.g. a lambda around TrackBlock::PairMass)
   template<typename MassFunc>
-  std::vector<Double_t> GenerateMixedPairsWithMass(const std::vector<TrackCandidate>& tracks1,
-                                                    const std::vector<TrackCandidate>& tracks2,
+  std::vector<Double_t> GenerateMixedPairsWithMass(const TrackBlock& tracks1,
+                                                    const TrackBlock& tracks2,
                                                     MassFunc massFunc,
                                                     Int_t nPairs = 1000) const {
     std::vector<Double_t> masses;
     masses.reserve(nPairs);
     
-    if (tracks1.empty() || tracks2.empty()) return masses;
+    if (tracks1.Empty() || tracks2.Empty()) return masses;
     
     for (Int_t i = 0; i < nPairs; i++) {
-      Int_t idx1 = (Int_t)(gRandom->Uniform(0, tracks1.size()));
-      Int_t idx2 = (Int_t)(gRandom->Uniform(0, tracks2.size()));
+      Int_t idx1 = (Int_t)(gRandom->Uniform(0, tracks1.Size()));
+      Int_t idx2 = (Int_t)(gRandom->Uniform(0, tracks2.Size()));
       
-      Double_t mass = massFunc(tracks1[idx1], tracks2[idx2]);
+      Double_t mass = massFunc(tracks1, idx1, tracks2, idx2);
       masses.push_back(mass);
     }
     
@@ -79,6 +83,9 @@ private:
   // Calculate bin index from event properties
   Int_t CalculateBinIndex(Float_t vz, Float_t centrality, Float_t psi2 = 0.0) const;
   
+  // Bin counts from the mixing config
+  void Configure(const MixingConfig& mixingConfig);
+
   // Get random event from mixing pool
   const MixingEvent* GetRandomEvent(Int_t binIndex) const;
 };
@@ -0,0 +1,74 @@
+#ifndef EVENT_TAG_INDEX_H
+#define EVENT_TAG_INDEX_H
+
+#include "Rtypes.h"
+
+class TFile;
+class TTree;
+
+// Compact per-event tags of a picoDst file list: one "EventTags" entry per
+// entry of the TChain built from the same list, with only the Event-branch
+// quantities the event cuts need. Written once per list by
+// analysis/buildEventTags.C. anaPhi.C in tag mode reads the tag of every entry
+// and hands it to StPhiMaker::AcceptEvent(), the same decision (and run and
+// trigger bookkeeping) as for the Event branch, and reads only the entries it
+// accepts, so the picoDst branches of rejected events are never read.
+class EventTagIndex {
+public:
+  static const Int_t kMaxTriggerIds = 64;
+
+  struct Tag {
+    Long64_t entry;              // entry in the TChain of the input list
+    Int_t file;                  // tree number of that entry in the chain
+    Int_t runId, eventId;
+    Float_t vz, vr, vzVpd;
+    Int_t refMult;
+    Int_t nTriggerIds;
+    UInt_t triggerIds[kMaxTriggerIds];
+  };
+
+  EventTagIndex();
+  ~EventTagIndex();
+
+  // Writing: Create(), then set GetTag() and Fill() for every chain entry in
+  // order, then Close(). inputList is stored with the tags for reference.
+  Bool_t Create(const Char_t* filename, const Char_t* inputList);
+  Tag& GetTag() { return fTag; }
+  void Fill();
+  Bool_t Close();
+
+  // Reading: Open(), then Read(i) sets GetTag() to the tag of chain entry i.
+  // Open() fails if the index does not have nEntries entries, i.e. was built
+  // from another file list.
+  Bool_t Open(const Char_t* filename, Long64_t nEntries);
+  Bool_t Read(Long64_t entry);
+  const Tag& GetTag() const { return fTag; }
+
+  // A Tag with the StPicoEvent calls TriggerCounts::Pass() and
+  // TriggerSelection::Match() make, so a maker counts tags and events alike
+  class TagEvent {
+  public:
+    explicit TagEvent(const Tag& tag) : fTag(tag) {}
+    Int_t runId() const { return fTag.runId; }
+    Int_t eventId() const { return fTag.eventId; }
+    Bool_t isTrigger(UInt_t id) const {
+      for (Int_t k = 0; k < fTag.nTriggerIds; k++) {
+        if (fTag.triggerIds[k] == id) return kTRUE;
+      }
+      return kFALSE;
+    }
+  private:
+    const Tag& fTag;
+  };
+
+private:
+  TFile* fFile;
+  TTree* fTree;
+  Bool_t fWriting;  // Create()d, Close() writes the tree
+  Tag fTag;
+
+  EventTagIndex(const EventTagIndex&);
+  EventTagIndex& operator=(const EventTagIndex&);
+};
+
+#endif
@@ -5,22 +5,112 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
+class TDirectory;
 class TH1;
+class THnSparse;
+class RunQA;
 
 /**
  * Loads histogram definitions from a flat key-value YAML and creates TH1/TH2.
  * Fill by name; missing keys are logged once and Fill is skipped.
+ *
+ * Histograms can carry "tags: [qa, ...]" in the YAML; DisableTags() before
+ * LoadFromFile (makers take it from the mainconf key "hist_skip_tags") leaves
+ * every histogram with one of those tags out. Fill by name then skips it
+ * silently, and GetHandle() gives 0, so hot loops resolve handles once and
+ * skip computing the fill arguments of disabled histograms:
+ *   if (hDedx) hm->Fill(hDedx, p.Mag(), dEdx);
+ *
+ * Backends (top-level "backend:" in the hist YAML, or SetBackend()):
+ *   root - every Fill goes to a TH1F/TH2F/TH1I (default).
+ *   flat - counts and stat sums are kept in plain arrays (uniform bins, one
+ *          multiply per axis) and turned into the same TH1F/TH2F/TH1I, with
+ *          entries and stats, only in Flush()/Write().
+ *
+ * type: RunIndexed (xAxis: run-ID range, yAxis): one x bin per run ID, rows
+ * allocated only for the runs filled; written as a THnSparseF (Get() gives 0).
+ * The xAxis nBins is not used (a warning if it differs from max - min).
+ *
+ * type: THnSparse, axes: [*Preset, ...] (presets may have a title): an
+ * N-dimensional THnSparseF, memory per filled bin, filled with one FillND()
+ * call per entry; project it to 1D/2D at analysis time.
+ *
+ * Families ("families:" section): a histogram definition plus
+ * "index: [*Preset]" or "index: [*Preset, *Preset]" (or plain counts, [9]),
+ * e.g. M_KK per (pT bin, RefMult class). GetFamily() once, then
+ * GetHandle(family, i, j) per fill is an array lookup, no name formatting;
+ * out-of-range indices give 0. An instance (name_i or name_i_j, index ranges in
+ * the title) is created on its first fill and only filled ones are written.
+ *
+ * Bootstrap ("bootstrapReplicas: N" at the top, "bootstrap: true" on 1D
+ * histograms): every fill is also added to N replicas with per-event
+ * Poisson(1) weights, drawn in BeginEvent() from a counter-based hash of
+ * (runId, eventId), so a replica does not depend on how events are split into
+ * jobs. The replicas live in one flat array per histogram and are written as
+ * one TH2F name_bootstrap (x: the histogram's axis, y: replica) that hadd
+ * merges; the spread over replicas is the statistical error of any quantity
+ * computed from the histogram (analysis/bootstrapErrors.C).
+ *
+ * Checkpoints (SetCheckpoint(); makers take the mainconf keys checkpoint_events
+ * and checkpoint_seconds): Checkpoint(nextEntry), called before every entry,
+ * writes what Write() would plus nextEntry to path.tmp and renames it to path
+ * once the interval has passed, so a killed job always leaves the last
+ * complete checkpoint. RestoreCheckpoint() adds its histograms back and gives
+ * the entry to go on from. Counters the maker keeps itself (run quality and
+ * trigger counts) go into the checkpoint through AddCheckpointCounts().
+ *
+ * Run QA ("runQA:" at the top, a map with "observables: [name, ...]" and
+ * optional "tags"): a RunQA table of per-run means and variances of those
+ * observables, which the maker fills by name (GetRunQA()). It is written
+ * with the histograms (tree "RunQA") and restored from checkpoints.
+ *
+ * Buffered fills (root backend): "bufferSize: N" at the top of the hist YAML,
+ * or per histogram, or SetBufferSize(), keeps the last N values of each
+ * histogram (x, or x and y) and hands them to TH1::FillN when the buffer is
+ * full and in Flush()/Write(). The histograms come out the same as with one
+ * Fill per value. 0 (default) fills directly.
  */
 class HistManager {
+  struct Slot;
+  struct Family;
+
 public:
+  enum Backend { kRootBackend, kFlatBackend };
+
+  /** Resolved histogram for Fill(Handle, ...); valid while the HistManager lives. */
+  typedef Slot* Handle;
+
+  /** Histogram family from the "families:" section, for GetHandle(family, i, j). */
+  typedef Family* FamilyHandle;
+
   HistManager();
   ~HistManager();
 
+  /** Use this backend whatever the YAML says. Call before LoadFromFile. */
+  void SetBackend(Backend backend);
+  Backend GetBackend() const { return m_backend; }
+
+  /** Leave out histograms tagged with any of tags ("qa", "qa, pair"). Call before LoadFromFile. */
+  void DisableTags(const std::string& tags);
+
+  /** Default buffer size whatever the YAML says (0: off). Call before LoadFromFile. */
+  void SetBufferSize(Int_t size);
+
+  /** Draw this event's bootstrap weights; call once per event before its fills. No-op without bootstrap. */
+  void BeginEvent(Int_t runId, Int_t eventId);
+
   /** Load YAML and create histograms. Path can be absolute or relative. */
   Bool_t LoadFromFile(const Char_t* yamlPath);
 
-  /** Get histogram by name. Returns nullptr if not found. */
+  /**
+   * Get histogram by name. Returns nullptr if not found.
+   * With the flat backend the object only holds what has been flushed; it may
+   * still be filled directly, Flush() adds the array counts on top.
+   * Values buffered for it are filled first.
+   */
   TH1* Get(const char* name) const;
 
   /** Fill 1D histogram. No-op and log once if name not found. */
@@ -29,15 +119,122 @@ public:
   /** Fill 2D histogram. No-op and log once if name not found. */
   void Fill(const char* name, Double_t x, Double_t y);
 
-  /** Write all owned histograms to current TDirectory. */
+  /** Handle for name; 0 if disabled by tag, or not defined (logged once). */
+  Handle GetHandle(const char* name);
+
+  /** Family by name; 0 if disabled by tag, or not defined (logged once). */
+  FamilyHandle GetFamily(const char* name);
+
+  /** Instance (i, j) of a family (j = 0 with one index axis); 0 if f is 0 or an index is out of range. */
+  Handle GetHandle(FamilyHandle f, Int_t i, Int_t j = 0) const;
+
+  /** Index of value on index axis (0 or 1) of f; -1 outside the axis range or if f is 0. */
+  Int_t FindIndex(FamilyHandle f, Int_t axis, Double_t value) const;
+
+  /** Fill through a handle (no name lookup). No-op for a 0 handle. */
+  void Fill(Handle h, Double_t x);
+  void Fill(Handle h, Double_t x, Double_t y);
+
+  /** Fill a THnSparse histogram; x holds one value per axis, in YAML order. */
+  void FillND(const char* name, const Double_t* x);
+  void FillND(Handle h, const Double_t* x);
+
+  /** Run QA table of the "runQA" section; 0 if there is none or it is disabled by tag. */
+  RunQA* GetRunQA() const { return m_runQA; }
+
+  /** THnSparse histogram by name (0 if not defined, disabled or not THnSparse). */
+  THnSparse* GetSparse(const char* name) const;
+
+  /** Fill buffered values; flat backend: move the array counts into the histograms. */
+  void Flush();
+
+  /** Write all owned histograms to current TDirectory (flushes first); family instances only if filled. */
   void Write();
 
+  /** Checkpoint to path every everyEvents entries and/or everySeconds (0: that trigger off). */
+  void SetCheckpoint(const std::string& path, Long64_t everyEvents, Double_t everySeconds);
+
+  /** Write the checkpoint if one is due; nextEntry = entries done so far. */
+  void Checkpoint(Long64_t nextEntry);
+
+  /** Write the checkpoint now: path.tmp, then renamed to path. False (old checkpoint kept) on error. */
+  Bool_t WriteCheckpoint(Long64_t nextEntry);
+
+  /** Add the histograms of an existing checkpoint (call after LoadFromFile); its nextEntry, 0 if none. */
+  Long64_t RestoreCheckpoint();
+
+  /**
+   * Save counts (not owned; a RunCounts, TriggerCounts or anything with
+   * Save(std::vector<Long64_t>&) const and Restore(const std::vector<Long64_t>&))
+   * with every checkpoint, as tree name; RestoreCheckpoint() adds them back.
+   * Call before RestoreCheckpoint().
+   */
+  template <class Counts>
+  void AddCheckpointCounts(const char* name, Counts& counts) {
+    m_ckptCounts.push_back(std::make_pair(std::string(name), (CountsIO*)new CountsOf<Counts>(counts)));
+  }
+
+  /** Delete the checkpoint file, once the final output is written. */
+  void RemoveCheckpoint();
+
 private:
+  struct CountsIO {
+    virtual ~CountsIO() {}
+    virtual void Save(std::vector<Long64_t>& values) const = 0;
+    virtual void Restore(const std::vector<Long64_t>& values) = 0;
+  };
+  template <class Counts>
+  struct CountsOf : public CountsIO {
+    Counts& counts;
+    explicit CountsOf(Counts& c) : counts(c) {}
+    virtual void Save(std::vector<Long64_t>& values) const { counts.Save(values); }
+    virtual void Restore(const std::vector<Long64_t>& values) { counts.Restore(values); }
+  };
+
   HistManager(const HistManager&);
   HistManager& operator=(const HistManager&);
 
-  std::map<std::string, TH1*> m_histograms;
+  struct FlatHist;    // flat backend storage, see HistManager.cpp
+  struct FillBuffer;  // bufferSize > 0
+  struct RunHist;     // type: RunIndexed
+  struct Bootstrap;   // bootstrap: true
+
+  struct Slot {
+    TH1* hist;           // root: made at load; flat: made on Get()/Flush()
+    FlatHist* flat;      // 0 for the root backend
+    FillBuffer* buffer;  // 0 if unbuffered (always for flat)
+    RunHist* run;        // type: RunIndexed (then hist, flat, buffer are 0)
+    THnSparse* sparse;   // type: THnSparse (likewise)
+    Family* family;      // family instance: hist or flat made on the first fill
+    Bootstrap* boot;     // bootstrap: true (in addition to hist or flat)
+
+    Slot() : hist(0), flat(0), buffer(0), run(0), sparse(0), family(0), boot(0) {}
+  };
+
+  Slot* Find(const char* name);
+  TH1* Materialize(Slot& slot) const;
+  void FlushSlot(Slot& slot);
+  void WriteSlot(Slot& slot);
+  Bool_t RestoreSlot(Slot& slot, const std::string& name, TDirectory* dir);
+  static void FreeSlot(Slot& slot);
+
+  mutable std::map<std::string, Slot> m_histograms;
+  std::map<std::string, Family*> m_families;
   std::set<std::string> m_missingKeyWarned;
+  std::set<std::string> m_disabledTags;
+  std::set<std::string> m_disabled;  // defined in the YAML, left out by tag
+  Backend m_backend;
+  Bool_t m_backendFixed;  // SetBackend() called; the YAML key is ignored
+  Int_t m_bufferSize;
+  Bool_t m_bufferSizeFixed;
+  std::vector<Float_t> m_bootWeights;  // one per replica, for the current event
+  RunQA* m_runQA;
+  std::string m_ckptPath;  // empty: no checkpoints
+  Long64_t m_ckptEvery;
+  Double_t m_ckptSeconds;
+  Long64_t m_ckptEntry;    // nextEntry of the last checkpoint (or restore)
+  Double_t m_ckptTime;     // time(0) then
+  std::vector<std::pair<std::string, CountsIO*> > m_ckptCounts;  // AddCheckpointCounts()
 };
 
 #endif
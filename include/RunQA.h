@@ -0,0 +1,80 @@
+#ifndef RUN_QA_H
+#define RUN_QA_H
+
+#include "Rtypes.h"
+#include <map>
+#include <string>
+#include <vector>
+
+class TTree;
+
+/**
+ * Per-run running mean and variance of a list of observables (the "runQA"
+ * section of a hist YAML, see HistManager::GetRunQA()), one row per run seen.
+ * Each value is added with Welford's update; tables of several jobs or a
+ * checkpoint are combined with the pairwise formula of Chan et al., so the
+ * result does not depend on how the events were split into jobs.
+ *
+ * Written as a TTree (one entry per run: run, n[nObs], mean[nObs], m2[nObs];
+ * the observable names in the title) that hadd concatenates. Add(tree) and
+ * analysis/runQAReport.C combine the entries of the same run.
+ *
+ * Per event: SetRun(runId) once, then Fill(k, x) for observable k.
+ */
+class RunQA {
+public:
+  struct Stat {
+    Long64_t n;
+    Double_t mean;
+    Double_t m2;   // sum of squared deviations from mean
+
+    Stat() : n(0), mean(0), m2(0) {}
+
+    void Add(Double_t x) {
+      n++;
+      const Double_t d = x - mean;
+      mean += d / n;
+      m2 += d * (x - mean);
+    }
+
+    void Merge(const Stat& other);
+    Double_t Variance() const { return n > 1 ? m2 / (n - 1) : 0; }
+  };
+
+  explicit RunQA(const std::vector<std::string>& observables);
+
+  Int_t GetNObservables() const { return (Int_t)fNames.size(); }
+  const std::string& GetName(Int_t k) const { return fNames[k]; }
+
+  void SetRun(Int_t runId) {
+    if (runId != fRunId || fStats.empty()) SelectRun(runId);
+  }
+  void Fill(Int_t k, Double_t x) { fStats[fRow + k].Add(x); }
+
+  Int_t GetNRuns() const { return (Int_t)fRuns.size(); }
+  Int_t GetRunId(Int_t row) const { return fRuns[row]; }
+  const Stat& GetStat(Int_t row, Int_t k) const { return fStats[row * fNames.size() + k]; }
+
+  /** Tree name in the current directory. */
+  void Write(const Char_t* name) const;
+
+  /** Combine the entries of a tree written by Write() (or hadd of several);
+   *  kFALSE if its observables differ from this table's. */
+  Bool_t Add(TTree* tree);
+
+private:
+  RunQA(const RunQA&);
+  RunQA& operator=(const RunQA&);
+
+  void SelectRun(Int_t runId);
+  std::string JoinedNames() const;
+
+  std::vector<std::string> fNames;
+  std::map<Int_t, Int_t> fRowOf;  // run -> row
+  std::vector<Int_t> fRuns;       // row -> run
+  std::vector<Stat> fStats;       // row * nObs + k
+  Int_t fRunId;                   // run of the current row
+  size_t fRow;                    // first Stat of the current row
+};
+
+#endif
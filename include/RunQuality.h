@@ -0,0 +1,104 @@
+#ifndef RUN_QUALITY_H
+#define RUN_QUALITY_H
+
+#include "Rtypes.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// Good/bad run lists of an analysis (analysis_info dataset.goodRunList /
+// dataset.badRunList), loaded once per ConfigContext. The listed runs are kept
+// as a bitmap over the span of the lists, so IsGoodRun() is one subtraction and
+// one bit test per event; lists spanning more than kMaxDenseSpan run numbers
+// fall back to a sorted array (binary search).
+//
+// List files: one run number per line, '#' starts a comment. A line "run event"
+// in the bad-run list rejects that single event.
+class RunQuality {
+public:
+  static const Int_t kMaxDenseSpan = 1 << 24;  // run numbers; a 2 MB bitmap
+
+  RunQuality();
+
+  // "" for a list not used. With a good-run list only its runs pass; runs in
+  // the bad-run list never pass. Returns kFALSE (and accepts everything) if a
+  // given list cannot be read.
+  Bool_t Load(const std::string& goodRunList, const std::string& badRunList);
+  void Clear();
+
+  Bool_t IsActive() const { return fActive; }
+
+  Bool_t IsGoodRun(Int_t runId) const {
+    if (!fActive) return kTRUE;
+    return IsListed(runId) == fBitIsGood;
+  }
+
+  Bool_t IsGoodEvent(Int_t runId, Int_t eventId) const {
+    if (!IsGoodRun(runId)) return kFALSE;
+    return fBadEvents.empty() || !IsBadEvent(runId, eventId);
+  }
+
+private:
+  Bool_t fActive;
+  Bool_t fBitIsGood;              // bit = good run (good list given), else bad run
+  Bool_t fDense;
+  Int_t fMin;                     // first run of the bitmap
+  UInt_t fSpan;
+  std::vector<UChar_t> fBits;
+  std::vector<Int_t> fRuns;       // runs with the bit set, sorted (sparse case)
+  std::vector<ULong64_t> fBadEvents;  // (run << 32 | event), sorted
+
+  Bool_t IsListed(Int_t runId) const {
+    if (fDense) {
+      const UInt_t d = (UInt_t)(runId - fMin);
+      return d < fSpan && ((fBits[d >> 3] >> (d & 7)) & 1);
+    }
+    return IsListedSparse(runId);
+  }
+  Bool_t IsListedSparse(Int_t runId) const;
+  Bool_t IsBadEvent(Int_t runId, Int_t eventId) const;
+  static Bool_t ReadList(const std::string& path, std::vector<Int_t>& runs,
+                         std::vector<ULong64_t>* events);
+};
+
+// A maker's run-quality stage: Pass() decides each event (runId, eventId)
+// once, however often it is called (AcceptEvent() and Make()), and counts
+// accepted and rejected events per run, so Print() shows what the rejected
+// runs would have cost.
+class RunCounts {
+public:
+  RunCounts();
+
+  Bool_t Pass(const RunQuality& quality, Int_t runId, Int_t eventId) {
+    if (runId == fRunId && eventId == fEventId) return fPass;
+    fEventId = eventId;
+    if (runId != fRunId || !fCurrent) {
+      fRunId = runId;
+      fCurrent = &fRuns[runId];
+    }
+    fPass = quality.IsGoodEvent(runId, eventId);
+    if (fPass) fCurrent->nAccepted++;
+    else fCurrent->nRejected++;
+    return fPass;
+  }
+
+  // Totals and one line per run with rejected events, each after prefix
+  void Print(const Char_t* prefix) const;
+
+  // (run, nAccepted, nRejected) per run, for HistManager::AddCheckpointCounts();
+  // Restore() adds them to the counts
+  void Save(std::vector<Long64_t>& values) const;
+  void Restore(const std::vector<Long64_t>& values);
+
+private:
+  struct Counts {
+    Long64_t nAccepted, nRejected;
+    Counts() : nAccepted(0), nRejected(0) {}
+  };
+  std::map<Int_t, Counts> fRuns;
+  Counts* fCurrent;
+  Int_t fRunId, fEventId;
+  Bool_t fPass;
+};
+
+#endif
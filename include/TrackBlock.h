@@ -0,0 +1,129 @@
+#ifndef TRACK_BLOCK_H
+#define TRACK_BLOCK_H
+
+#include <vector>
+#include <cmath>
+#include "Rtypes.h"
+#include "CandidateTypes.h"
+
+// Structure-of-arrays track list for one event (or one mixing-pool entry).
+// Row i is the i-th track; every field is a contiguous column so cut and mass
+// loops run over plain arrays. The Cartesian momentum is computed once in
+// Push() from pT/eta/phi. Charge and hit counts are stored in 8 bits (TPC has
+// at most 72 pad rows). Clear() keeps the capacity, so one instance can be
+// reused for every event.
+class TrackBlock {
+public:
+  // Read-only view of one row, with the accessors of a track record
+  class TrackRef {
+  public:
+    TrackRef(const TrackBlock* b, Int_t i) : fBlock(b), fIndex(i) {}
+    Int_t Index() const { return fIndex; }
+    Int_t EventIndex() const { return fBlock->eventIndex[fIndex]; }
+    Float_t Px() const { return fBlock->px[fIndex]; }
+    Float_t Py() const { return fBlock->py[fIndex]; }
+    Float_t Pz() const { return fBlock->pz[fIndex]; }
+    Float_t Pt() const { return fBlock->pT[fIndex]; }
+    Float_t Eta() const { return fBlock->eta[fIndex]; }
+    Float_t Phi() const { return fBlock->phi[fIndex]; }
+    Short_t Charge() const { return fBlock->charge[fIndex]; }
+    Short_t NHitsFit() const { return fBlock->nHitsFit[fIndex]; }
+    Short_t NHitsMax() const { return fBlock->nHitsMax[fIndex]; }
+    Short_t NHitsDedx() const { return fBlock->nHitsDedx[fIndex]; }
+    Float_t DCA() const { return fBlock->DCA[fIndex]; }
+    Float_t Chi2() const { return fBlock->chi2[fIndex]; }
+    Float_t NSigmaPion() const { return fBlock->nSigmaPion[fIndex]; }
+    Float_t NSigmaKaon() const { return fBlock->nSigmaKaon[fIndex]; }
+    Float_t NSigmaProton() const { return fBlock->nSigmaProton[fIndex]; }
+    Float_t Beta() const { return fBlock->beta[fIndex]; }
+    Float_t Mass2() const { return fBlock->mass2[fIndex]; }
+    Bool_t TofMatch() const { return fBlock->tofMatch[fIndex] != 0; }
+    Float_t OriginX() const { return fBlock->originX[fIndex]; }
+    Float_t OriginY() const { return fBlock->originY[fIndex]; }
+    Float_t OriginZ() const { return fBlock->originZ[fIndex]; }
+  private:
+    const TrackBlock* fBlock;
+    Int_t fIndex;
+  };
+
+  // Forward iterator over rows
+  class const_iterator {
+  public:
+    const_iterator(const TrackBlock* b, Int_t i) : fBlock(b), fIndex(i) {}
+    TrackRef operator*() const { return TrackRef(fBlock, fIndex); }
+    const_iterator& operator++() { ++fIndex; return *this; }
+    bool operator==(const const_iterator& o) const { return fIndex == o.fIndex && fBlock == o.fBlock; }
+    bool operator!=(const const_iterator& o) const { return !(*this == o); }
+  private:
+    const TrackBlock* fBlock;
+    Int_t fIndex;
+  };
+
+  // Contiguous read-only view of one column
+  template <class T>
+  struct Span {
+    const T* data;
+    Int_t size;
+    const T& operator[](Int_t i) const { return data[i]; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+  };
+
+  // Columns
+  std::vector<Int_t> eventIndex;
+  std::vector<Float_t> px, py, pz;      // from pT/eta/phi, filled in Push()
+  std::vector<Float_t> pT, eta, phi;
+  std::vector<Char_t> charge;
+  std::vector<UChar_t> nHitsFit, nHitsMax, nHitsDedx;
+  std::vector<Float_t> DCA, chi2;
+  std::vector<Float_t> nSigmaPion, nSigmaKaon, nSigmaProton;
+  std::vector<Float_t> beta, mass2;
+  std::vector<UChar_t> tofMatch;
+  std::vector<Float_t> originX, originY, originZ;  // helix reference point [cm]
+
+  Int_t Size() const { return (Int_t)pT.size(); }
+  Bool_t Empty() const { return pT.empty(); }
+
+  void Clear();
+  void Reserve(Int_t n);
+
+  // Append one track record
+  void Push(const TrackCandidate& trk);
+
+  // Append row i of src (Cartesian momentum copied, not recomputed)
+  void PushRow(const TrackBlock& src, Int_t i);
+
+  // Row i as a track record
+  TrackCandidate Get(Int_t i) const;
+
+  TrackRef operator[](Int_t i) const { return TrackRef(this, i); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, Size()); }
+
+  template <class T>
+  static Span<T> MakeSpan(const std::vector<T>& column) {
+    Span<T> s;
+    s.data = column.empty() ? 0 : &column[0];
+    s.size = (Int_t)column.size();
+    return s;
+  }
+
+  // Invariant mass of row i of a and row j of b for daughter masses m1, m2
+  static Double_t PairMass(const TrackBlock& a, Int_t i, const TrackBlock& b, Int_t j,
+                           Double_t m1, Double_t m2) {
+    Double_t p1x = a.px[i], p1y = a.py[i], p1z = a.pz[i];
+    Double_t p2x = b.px[j], p2y = b.py[j], p2z = b.pz[j];
+    Double_t e = std::sqrt(m1 * m1 + p1x * p1x + p1y * p1y + p1z * p1z) +
+                 std::sqrt(m2 * m2 + p2x * p2x + p2y * p2y + p2z * p2z);
+    Double_t sx = p1x + p2x, sy = p1y + p2y, sz = p1z + p2z;
+    Double_t m2sum = e * e - (sx * sx + sy * sy + sz * sz);
+    return (m2sum > 0) ? std::sqrt(m2sum) : 0.0;
+  }
+
+  // Pair masses of row i of a with rows idx[k] of b, written to mass[k]
+  static void PairMasses(const TrackBlock& a, Int_t i, const TrackBlock& b,
+                         const std::vector<Int_t>& idx, Double_t m1, Double_t m2,
+                         std::vector<Double_t>& mass);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef TRACK_CUT_ENGINE_H
+#define TRACK_CUT_ENGINE_H
+
+#include <string>
+#include <vector>
+#include "Rtypes.h"
+#include "TrackBlock.h"
+#include "CutExpression.h"
+
+class ConfigContext;
+
+// Track + PID cuts over a whole TrackBlock in one pass.
+// Evaluate() writes one species bitmask per track. Every comparison is done for
+// every track and combined with '&', so the loop has no data-dependent branches
+// and is auto-vectorized (see CXXFLAGS_VEC in the Makefile).
+//
+// Bit meanings follow TreeReader::IsPion/IsKaon/IsProton: the "TOF" bits also
+// require the mass2 window, but only for TOF-matched tracks.
+//
+// TrackCutConfig::expression, if set, is compiled when the cuts are loaded and
+// a track failing it gets no bits at all. Its columns are the TrackBlock ones
+// (dca for DCA).
+class TrackCutEngine {
+public:
+  enum SpeciesBit {
+    kTrack     = 1 << 0,   // track quality cuts (nHits, DCA, eta, pT, chi2)
+    kPion      = 1 << 1,   // kTrack && |nSigmaPion| <= cut
+    kKaon      = 1 << 2,
+    kProton    = 1 << 3,
+    kPionTOF   = 1 << 4,   // kPion && (!tofMatch || mass2 in pion window)
+    kKaonTOF   = 1 << 5,
+    kProtonTOF = 1 << 6
+  };
+
+  TrackCutEngine();
+
+  // Copy the current track and PID cuts from the config context (done by Evaluate()
+  // unless the cuts were loaded explicitly with LoadCuts() and SetAutoLoad(kFALSE))
+  void LoadCuts();
+  void SetAutoLoad(Bool_t autoLoad) { fAutoLoad = autoLoad; }
+
+  // Context to take the cuts from (default: ConfigManager's)
+  void SetConfigContext(const ConfigContext& config) { fConfig = &config; }
+
+  // Species bits for every row of tracks; mask is resized to tracks.Size().
+  // Returns the number of rows passing the track cuts.
+  Int_t Evaluate(const TrackBlock& tracks, std::vector<UChar_t>& mask);
+
+  // Rows with all of bits set (idx is cleared first)
+  static void Indices(const std::vector<UChar_t>& mask, UChar_t bits, std::vector<Int_t>& idx);
+
+  // Bit for a species with or without TOF
+  static UChar_t PionBit(Bool_t useTOF) { return useTOF ? kPionTOF : kPion; }
+  static UChar_t KaonBit(Bool_t useTOF) { return useTOF ? kKaonTOF : kKaon; }
+  static UChar_t ProtonBit(Bool_t useTOF) { return useTOF ? kProtonTOF : kProton; }
+
+  // Compiled track expression (empty if none or if it failed to compile)
+  const CutExpression& GetExpression() const { return fExpression; }
+
+private:
+  const ConfigContext* fConfig;
+  Bool_t fAutoLoad;
+
+  // Track cuts as Float_t, compared directly against the columns (rounded so
+  // that each comparison agrees with TreeReader's against the Double_t cut)
+  Float_t fMinNHitsFit, fMinNHitsRatio, fMinNHitsDedx;
+  Float_t fMaxDCA, fMaxEta, fMinPt, fMaxPt, fMaxChi2;
+
+  // PID cuts
+  Float_t fNSigmaPion, fNSigmaKaon, fNSigmaProton;
+  Float_t fMinMass2Pion, fMaxMass2Pion;
+  Float_t fMinMass2Kaon, fMaxMass2Kaon;
+  Float_t fMinMass2Proton, fMaxMass2Proton;
+
+  // Track expression; recompiled only when the text changes
+  std::string fExpressionSource;
+  CutExpression fExpression;
+  std::vector<UChar_t> fExpressionMask;
+
+  void SetExpression(const std::string& expr);
+  void BindExpression(const TrackBlock& tracks);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef TRACK_HELIX_H
+#define TRACK_HELIX_H
+
+#include "Rtypes.h"
+
+// Lightweight helix for a charged track in a uniform solenoidal field (Bz).
+// ROOT-only replacement for StPhysicalHelixD so that the TreeReader-based
+// second stage can do the same V0 topology as the Makers.
+//
+// Parametrised by the transverse path length t [cm] from the reference point
+// (origin). Position:  x(t) = xc + sin(psi(t)) / w,  y(t) = yc - cos(psi(t)) / w,
+//                      z(t) = z0 + t * pz / pT,      psi(t) = psi0 + w * t
+// with w = -sign(q*B) * curvature. w = 0 is handled as a straight line.
+class TrackHelix {
+public:
+  TrackHelix();
+
+  // Momentum [GeV/c] and origin [cm] at the reference point, charge in units of e, field in kGauss
+  TrackHelix(Double_t px, Double_t py, Double_t pz,
+             Double_t ox, Double_t oy, Double_t oz,
+             Int_t charge, Double_t bFieldKGauss);
+
+  void Set(Double_t px, Double_t py, Double_t pz,
+           Double_t ox, Double_t oy, Double_t oz,
+           Int_t charge, Double_t bFieldKGauss);
+
+  // Position at transverse path length t
+  void At(Double_t t, Double_t& x, Double_t& y, Double_t& z) const;
+
+  // Momentum at transverse path length t
+  void MomentumAt(Double_t t, Double_t& px, Double_t& py, Double_t& pz) const;
+
+  // 3D path length corresponding to transverse path length t
+  Double_t PathLength3D(Double_t t) const { return t * fInvCosDip; }
+
+  Double_t Curvature() const { return fW < 0 ? -fW : fW; }
+  Bool_t IsStraight() const { return fStraight; }
+
+  // Transverse path lengths (t1 on h1, t2 on h2) at the points of closest approach.
+  // Returns the 3D distance between those points (negative if the search failed).
+  static Double_t PathLengths(const TrackHelix& h1, const TrackHelix& h2,
+                              Double_t& t1, Double_t& t2);
+
+  // Transverse path length at the point of closest approach to (x, y, z)
+  Double_t PathLength(Double_t x, Double_t y, Double_t z) const;
+
+private:
+  Double_t fX0, fY0, fZ0;    // reference point
+  Double_t fPsi0;            // transverse direction at reference point
+  Double_t fPt;              // transverse momentum
+  Double_t fPz;
+  Double_t fTanDip;          // pz / pT (dz/dt)
+  Double_t fInvCosDip;       // p / pT  (ds/dt)
+  Double_t fW;               // signed curvature dpsi/dt [1/cm]
+  Double_t fXc, fYc;         // circle centre (unused if straight)
+  Bool_t   fStraight;
+
+  // First and second derivative of the position w.r.t. t
+  void Derivatives(Double_t t, Double_t* d1, Double_t* d2) const;
+
+  // Transverse path length of the point on the circle closest to (x, y), in (-pi/|w|, pi/|w|]
+  Double_t CirclePathLength(Double_t x, Double_t y) const;
+};
+
+#endif
@@ -9,10 +9,14 @@
 #include <iostream>
 #include "CutConfig.h"
 #include "CandidateTypes.h"
+#include "TrackBlock.h"
+#include "TrackCutEngine.h"
 
 class TreeReader {
 public:
   TreeReader();
+  // Cuts from config instead of ConfigManager's default context
+  explicit TreeReader(const ConfigContext& config);
   ~TreeReader();
   
   // Open file and load trees
@@ -30,34 +34,48 @@ public:
   const EventCandidate& GetEvent() const { return currentEvent; }
   
   // Get all tracks for current event
-  const std::vector<TrackCandidate>& GetTracks() const { return currentTracks; }
+  const TrackBlock& GetTracks() const { return currentTracks; }
   
   // Apply event cuts
   Bool_t PassEventCuts(const EventCandidate& evt) const;
   
-  // Apply track cuts
-  Bool_t PassTrackCuts(const TrackCandidate& trk) const;
+  // Apply track cuts to row i
+  Bool_t PassTrackCuts(const TrackBlock& tracks, Int_t i) const;
+
+  // TrackCutEngine species bits of every track of the current event
+  // (evaluated once per event, on first use)
+  const std::vector<UChar_t>& GetSpeciesMask() const;
   
   // PID selection functions
-  Bool_t IsPion(const TrackCandidate& trk, Bool_t useTOF = kFALSE) const;
-  Bool_t IsKaon(const TrackCandidate& trk, Bool_t useTOF = kFALSE) const;
-  Bool_t IsProton(const TrackCandidate& trk, Bool_t useTOF = kFALSE) const;
+  Bool_t IsPion(const TrackBlock& tracks, Int_t i, Bool_t useTOF = kFALSE) const;
+  Bool_t IsKaon(const TrackBlock& tracks, Int_t i, Bool_t useTOF = kFALSE) const;
+  Bool_t IsProton(const TrackBlock& tracks, Int_t i, Bool_t useTOF = kFALSE) const;
   
-  // Get selected candidates
-  std::vector<TrackCandidate> GetPionCandidates(Bool_t useTOF = kFALSE) const;
-  std::vector<TrackCandidate> GetKaonCandidates(Bool_t useTOF = kFALSE) const;
-  std::vector<TrackCandidate> GetProtonCandidates(Bool_t useTOF = kFALSE) const;
+  // Selected candidates of the current event, copied to out (cleared first)
+  void GetPionCandidates(TrackBlock& out, Bool_t useTOF = kFALSE) const;
+  void GetKaonCandidates(TrackBlock& out, Bool_t useTOF = kFALSE) const;
+  void GetProtonCandidates(TrackBlock& out, Bool_t useTOF = kFALSE) const;
+
+  // Indices into GetTracks() of selected candidates (idx is cleared first)
+  void GetPionIndices(std::vector<Int_t>& idx, Bool_t useTOF = kFALSE) const;
+  void GetKaonIndices(std::vector<Int_t>& idx, Bool_t useTOF = kFALSE) const;
+  void GetProtonIndices(std::vector<Int_t>& idx, Bool_t useTOF = kFALSE) const;
+
+  // True if the input has origin/bField branches (needed for helix V0 topology;
+  // GetEvent().hasHelix says the same per event)
+  Bool_t HasHelixInfo() const { return hasHelixInfo; }
   
-  // Calculate invariant mass of two tracks
-  static Double_t CalculateInvariantMass(const TrackCandidate& trk1, 
-                                          const TrackCandidate& trk2,
+  // Calculate invariant mass of row i1 of b1 and row i2 of b2
+  static Double_t CalculateInvariantMass(const TrackBlock& b1, Int_t i1,
+                                          const TrackBlock& b2, Int_t i2,
                                           Double_t mass1, Double_t mass2);
   
   // Calculate invariant mass assuming massless particles
-  static Double_t CalculateInvariantMassMassless(const TrackCandidate& trk1,
-                                                  const TrackCandidate& trk2);
+  static Double_t CalculateInvariantMassMassless(const TrackBlock& b1, Int_t i1,
+                                                  const TrackBlock& b2, Int_t i2);
 
 private:
+  const ConfigContext* fConfig;
   TFile *inputFile;
   TTree *eventTree;
   TTree *trackTree;
@@ -69,6 +87,7 @@ private:
   Float_t ev_Qx, ev_Qy, ev_psi2;
   Int_t ev_nTracks;
   Float_t ev_vzVpd;
+  Float_t ev_bField;
   
   // Track tree branches
   Int_t tr_eventIndex;
@@ -79,14 +98,23 @@ private:
   Float_t tr_nSigmaPion, tr_nSigmaKaon, tr_nSigmaProton;
   Float_t tr_beta, tr_mass2;
   Bool_t tr_tofMatch;
+  Float_t tr_originX, tr_originY, tr_originZ;
+  Bool_t hasHelixInfo;
   
   // Current loaded data
   EventCandidate currentEvent;
-  std::vector<TrackCandidate> currentTracks;
+  TrackBlock currentTracks;
   Long64_t currentEventIndex;
+
+  // Species bitmask of the current event (fMaskEvent = event it belongs to)
+  mutable TrackCutEngine fCutEngine;
+  mutable std::vector<UChar_t> fMask;
+  mutable Long64_t fMaskEvent;
+  mutable std::vector<Int_t> fIdx;
   
   // Helper function to load tracks for current event
   void LoadTracksForEvent(Long64_t eventIndex);
+
 };
 
 #endif
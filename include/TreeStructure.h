@@ -22,6 +22,8 @@
  * - psi2 (Float_t): Event plane angle [rad]
  * - nTracks (Int_t): Number of tracks saved for this event
  * - vzVpd (Float_t): VPD vertex Z [cm] (for pileup check)
+ * - bField (Float_t): Magnetic field [kGauss] (optional; needed for V0 helix topology,
+ *   without it V0Reconstructor uses the approximate topology from the daughter DCAs)
  * 
  * One entry per event
  */
@@ -47,6 +49,8 @@
  * - beta (Float_t): TOF beta (if TOF matched, else -999)
  * - mass2 (Float_t): TOF mass^2 [(GeV/c^2)^2] (if TOF matched, else -999)
  * - tofMatch (Bool_t): Whether track has TOF match
+ * - originX, originY, originZ (Float_t): Global track origin [cm] (optional; helix
+ *   reference point, pT/eta/phi are the global momentum at this point)
  * 
  * Multiple entries per event (one per track)
  * Use eventIndex to match tracks to events
@@ -70,6 +74,9 @@ struct TrackInfo {
   Float_t beta;
   Float_t mass2;
   Bool_t tofMatch;
+  Float_t originX;
+  Float_t originY;
+  Float_t originZ;
 };
 
 // Helper structure for reading events (optional, for convenience)
@@ -87,6 +94,7 @@ struct EventInfo {
   Float_t psi2;
   Int_t nTracks;
   Float_t vzVpd;
+  Float_t bField;
 };
 
 #endif
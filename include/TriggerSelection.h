@@ -0,0 +1,93 @@
+#ifndef TRIGGER_SELECTION_H
+#define TRIGGER_SELECTION_H
+
+#include "Rtypes.h"
+#include <string>
+#include <vector>
+
+// Set of accepted trigger IDs (EventCutConfig key "triggerIds"), kept as a
+// sorted array of at most kMaxIds entries. An event passes when it fired any of
+// them; an empty set accepts every event. Match() returns which of the set the
+// event fired as a bit mask (bit k = GetId(k)), so a maker can count per trigger
+// in a plain array without copying the event's trigger list.
+class TriggerSelection {
+public:
+  static const Int_t kMaxIds = 64;  // bits of the Match() mask
+
+  TriggerSelection();
+
+  // IDs separated by commas and/or spaces, optionally in [ ] (e.g. "[640001, 640011]").
+  // Empty clears the set. Returns kFALSE (and clears the set) on a malformed list.
+  Bool_t Parse(const std::string& list);
+
+  Bool_t IsActive() const { return fN > 0; }
+  Int_t GetN() const { return fN; }
+  UInt_t GetId(Int_t k) const { return fIds[k]; }
+
+  // Position of id in the set (binary search), -1 if not in it
+  Int_t Find(UInt_t id) const;
+
+  // Bits of the set fired by the given IDs (e.g. EventTagIndex::Tag::triggerIds)
+  ULong64_t Match(const UInt_t* ids, Int_t n) const;
+
+  // Same for an event with isTrigger(id) (StPicoEvent): one lookup per ID of
+  // the set, the event's trigger vector is not copied
+  template <class Event>
+  ULong64_t Match(const Event& event) const {
+    ULong64_t mask = 0;
+    for (Int_t k = 0; k < fN; k++) {
+      if (event.isTrigger(fIds[k])) mask |= (ULong64_t)1 << k;
+    }
+    return mask;
+  }
+
+private:
+  UInt_t fIds[kMaxIds];
+  Int_t fN;
+};
+
+// A maker's trigger stage: per-trigger event counts (index = position in the
+// TriggerSelection) and the decision for the current event. Pass() evaluates
+// and counts each event (runId, eventId) once, however often it is called, so
+// a driver's AcceptEvent() and the maker's Make() can both use it.
+class TriggerCounts {
+public:
+  TriggerCounts();
+
+  template <class Event>
+  Bool_t Pass(const TriggerSelection& sel, const Event& event) {
+    if (event.runId() != fRunId || event.eventId() != fEventId) {
+      fRunId = event.runId();
+      fEventId = event.eventId();
+      fFired = sel.Match(event);
+      fPass = !sel.IsActive() || fFired != 0;
+      if (!fPass) fNRejected++;
+      for (Int_t k = 0; k < sel.GetN(); k++) {
+        if ((fFired >> k) & 1) fCounts[k]++;
+      }
+    }
+    return fPass;
+  }
+
+  // Bits of the selection fired by the current event
+  ULong64_t GetFired() const { return fFired; }
+  Long64_t GetCount(Int_t k) const { return fCounts[k]; }
+  Long64_t GetNRejected() const { return fNRejected; }
+
+  // One line per trigger ID, then the rejected count, each after prefix
+  void Print(const TriggerSelection& sel, const Char_t* prefix) const;
+
+  // Rejected count, then the count per trigger, for HistManager::AddCheckpointCounts();
+  // Restore() adds them to the counts
+  void Save(std::vector<Long64_t>& values) const;
+  void Restore(const std::vector<Long64_t>& values);
+
+private:
+  Int_t fRunId, fEventId;
+  ULong64_t fFired;
+  Bool_t fPass;
+  Long64_t fNRejected;
+  Long64_t fCounts[TriggerSelection::kMaxIds];
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef TWO_BODY_COMBINER_H
+#define TWO_BODY_COMBINER_H
+
+#include "Rtypes.h"
+#include <cmath>
+#include <vector>
+
+/**
+ * Compile-time specialised two-body pair loop (header-only, C++98 so Makers can use it).
+ *
+ *   Traits     daughter masses:  static Double_t Mass1(), Mass2()
+ *              and whether both daughters come from the same list (kIdentical)
+ *   ChargeMode TwoBody::kUnlikeSign, kLikeSign or kAllSign
+ *   Policy     cuts + histogram filling, called in this order for every pair of
+ *              the requested charge combination:
+ *                Bool_t Raw(d1, d2, pair)      any cheap per-pair bookkeeping; kFALSE drops the pair
+ *                Double_t MinMass(), MaxMass() mass window checked on the straight-line mass
+ *                Bool_t Accept(d1, d2, pair)   expensive cuts (helix DCA ...), may refine pair
+ *                void Fill(d1, d2, pair)       histogram filling (through HistManager)
+ *
+ * Daughter types need public members px, py, pz (GeV/c), charge and index
+ * (index into the source track list, used to avoid pairing a track with itself).
+ * Lists may use any allocator (e.g. ArenaVector<T>::type from EventArena.h).
+ */
+namespace TwoBody {
+  enum ChargeMode { kUnlikeSign = 1, kLikeSign = 2, kAllSign = 3 };
+
+  // Pair kinematics. Filled from the daughter momenta before the mass window;
+  // Accept() may overwrite them (e.g. with momenta at the DCA).
+  struct Pair {
+    Double_t px, py, pz;
+    Double_t e;
+    Double_t mass;
+    Int_t sign;        // q1 + q2: 0 for unlike-sign, +-2 for like-sign
+  };
+
+  inline Double_t Mass(Double_t e, Double_t px, Double_t py, Double_t pz) {
+    Double_t m2 = e * e - (px * px + py * py + pz * pz);
+    return (m2 > 0) ? std::sqrt(m2) : 0.0;
+  }
+
+  inline Double_t Pt(const Pair& p) { return std::sqrt(p.px * p.px + p.py * p.py); }
+
+  inline Double_t Rapidity(const Pair& p) {
+    if (p.e <= std::fabs(p.pz)) return 0.0;
+    return 0.5 * std::log((p.e + p.pz) / (p.e - p.pz));
+  }
+
+  // Pair counters for one Combine() call
+  struct Counts {
+    Long64_t nPairs;     // pairs with the requested charge combination
+    Long64_t nInWindow;  // ... inside the mass window
+    Long64_t nAccepted;  // ... passing Accept()
+    Counts() : nPairs(0), nInWindow(0), nAccepted(0) {}
+    void Add(const Counts& o) { nPairs += o.nPairs; nInWindow += o.nInWindow; nAccepted += o.nAccepted; }
+  };
+}
+
+template <class Traits, Int_t ChargeMode, class Policy>
+class TwoBodyCombiner {
+public:
+  // Different-species (or different-list) combination: every (a[i], b[j]) pair
+  template <class D1, class A1, class D2, class A2>
+  static TwoBody::Counts Combine(const std::vector<D1, A1>& a, const std::vector<D2, A2>& b, Policy& policy) {
+    TwoBody::Counts n;
+    const Double_t m1 = Traits::Mass1();
+    const Double_t m2 = Traits::Mass2();
+    const Double_t minMass = policy.MinMass();
+    const Double_t maxMass = policy.MaxMass();
+    for (size_t i = 0; i < a.size(); i++) {
+      const D1& d1 = a[i];
+      const Double_t e1 = std::sqrt(m1 * m1 + d1.px * d1.px + d1.py * d1.py + d1.pz * d1.pz);
+      size_t j0 = Traits::kIdentical ? i + 1 : 0;
+      for (size_t j = j0; j < b.size(); j++) {
+        const D2& d2 = b[j];
+        if (!Traits::kIdentical && d1.index == d2.index) continue;
+        Int_t qq = d1.charge * d2.charge;
+        if (ChargeMode == TwoBody::kUnlikeSign && qq >= 0) continue;
+        if (ChargeMode == TwoBody::kLikeSign && qq <= 0) continue;
+        n.nPairs++;
+
+        TwoBody::Pair pair;
+        pair.px = d1.px + d2.px;
+        pair.py = d1.py + d2.py;
+        pair.pz = d1.pz + d2.pz;
+        pair.e = e1 + std::sqrt(m2 * m2 + d2.px * d2.px + d2.py * d2.py + d2.pz * d2.pz);
+        pair.mass = TwoBody::Mass(pair.e, pair.px, pair.py, pair.pz);
+        pair.sign = d1.charge + d2.charge;
+
+        if (!policy.Raw(d1, d2, pair)) continue;
+        if (pair.mass < minMass || pair.mass > maxMass) continue;
+        n.nInWindow++;
+        if (!policy.Accept(d1, d2, pair)) continue;
+        n.nAccepted++;
+        policy.Fill(d1, d2, pair);
+      }
+    }
+    return n;
+  }
+
+  // Identical-species combination from one list (Traits::kIdentical): pairs i < j
+  template <class D, class A>
+  static TwoBody::Counts Combine(const std::vector<D, A>& a, Policy& policy) {
+    return Combine(a, a, policy);
+  }
+};
+
+#endif
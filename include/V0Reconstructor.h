@@ -5,7 +5,9 @@
 #include <TMath.h>
 #include <TVector3.h>
 #include "CandidateTypes.h"
+#include "TrackBlock.h"
 #include "TreeReader.h"
+#include "TrackHelix.h"
 #include "CutConfig.h"
 
 // Lambda mass
@@ -13,62 +15,165 @@ const Double_t kLambdaMass = 1.115683;  // GeV/c^2
 const Double_t kProtonMass = 0.938272;   // GeV/c^2
 const Double_t kPionMass = 0.139570;    // GeV/c^2
 
-// Structure for V0 candidate (Lambda)
+// Topology of a daughter pair at their point of closest approach
+struct V0Topology {
+  Double_t px, py, pz;      // V0 momentum (sum of daughter momenta at the DCA)
+  Double_t mass;            // Invariant mass
+  Double_t decayX, decayY, decayZ;  // Decay vertex (midpoint of the daughter DCA)
+  Double_t daughterDCA;     // DCA between daughters
+  Double_t decayLength;     // |decay vertex - PV|
+  Double_t pointingAngle;   // Angle between V0 momentum and PV->decay vertex [rad]
+  Double_t dcaToPV;         // DCA of the V0 line to the primary vertex
+};
+
+// Structure for V0 candidate (Lambda). Daughters are referenced by index into
+// the event track list (TreeReader::GetTracks()) instead of being copied.
 struct V0Candidate {
-  TrackCandidate proton;   // Daughter track (p for Lambda)
-  TrackCandidate pion;     // Daughter track (π⁻ for Lambda)
-  
-  TVector3 momentum;       // V0 momentum
+  Int_t protonIndex;       // Daughter track index (p for Lambda)
+  Int_t pionIndex;         // Daughter track index (π⁻ for Lambda)
+
+  Double_t px, py, pz;     // V0 momentum
   Double_t mass;           // Invariant mass
   Double_t pt;             // Transverse momentum
   Double_t eta;            // Pseudorapidity
   Double_t phi;            // Azimuthal angle
-  
+
   // Topology variables
+  Double_t decayX, decayY, decayZ;  // Decay vertex
   Double_t daughterDCA;    // DCA between daughters
   Double_t decayLength;     // Decay length
   Double_t pointingAngle;   // Pointing angle (angle between V0 momentum and PV-V0 vector)
   Double_t dcaToPV;        // DCA of V0 to primary vertex
-  
+
   Int_t eventIndex;        // Event index
+
+  TrackBlock::TrackRef Proton(const TrackBlock& tracks) const { return tracks[protonIndex]; }
+  TrackBlock::TrackRef Pion(const TrackBlock& tracks) const { return tracks[pionIndex]; }
+  TVector3 GetMomentum() const { return TVector3(px, py, pz); }
+};
+
+// Structure-of-arrays V0 candidate list. Daughters are referenced by index into
+// the event track list (TreeReader::GetTracks()). Clear() keeps the capacity so
+// one instance can be reused for every event.
+struct V0Candidates {
+  std::vector<Int_t> posIndex;   // positive daughter (p for Lambda)
+  std::vector<Int_t> negIndex;   // negative daughter (π⁻ for Lambda)
+  std::vector<Float_t> px, py, pz;
+  std::vector<Float_t> mass;
+  std::vector<Float_t> decayX, decayY, decayZ;
+  std::vector<Float_t> daughterDCA;
+  std::vector<Float_t> decayLength;
+  std::vector<Float_t> pointingAngle;
+  std::vector<Float_t> dcaToPV;
+
+  Int_t Size() const { return (Int_t)mass.size(); }
+
+  void Clear() {
+    posIndex.clear(); negIndex.clear();
+    px.clear(); py.clear(); pz.clear(); mass.clear();
+    decayX.clear(); decayY.clear(); decayZ.clear();
+    daughterDCA.clear(); decayLength.clear(); pointingAngle.clear(); dcaToPV.clear();
+  }
+
+  void Reserve(Int_t n) {
+    posIndex.reserve(n); negIndex.reserve(n);
+    px.reserve(n); py.reserve(n); pz.reserve(n); mass.reserve(n);
+    decayX.reserve(n); decayY.reserve(n); decayZ.reserve(n);
+    daughterDCA.reserve(n); decayLength.reserve(n); pointingAngle.reserve(n); dcaToPV.reserve(n);
+  }
+
+  void Push(Int_t iPos, Int_t iNeg, const V0Topology& topo) {
+    posIndex.push_back(iPos); negIndex.push_back(iNeg);
+    px.push_back(topo.px); py.push_back(topo.py); pz.push_back(topo.pz);
+    mass.push_back(topo.mass);
+    decayX.push_back(topo.decayX); decayY.push_back(topo.decayY); decayZ.push_back(topo.decayZ);
+    daughterDCA.push_back(topo.daughterDCA);
+    decayLength.push_back(topo.decayLength);
+    pointingAngle.push_back(topo.pointingAngle);
+    dcaToPV.push_back(topo.dcaToPV);
+  }
+
+  void Push(const V0Candidate& v0) {
+    posIndex.push_back(v0.protonIndex); negIndex.push_back(v0.pionIndex);
+    px.push_back(v0.px); py.push_back(v0.py); pz.push_back(v0.pz);
+    mass.push_back(v0.mass);
+    decayX.push_back(v0.decayX); decayY.push_back(v0.decayY); decayZ.push_back(v0.decayZ);
+    daughterDCA.push_back(v0.daughterDCA);
+    decayLength.push_back(v0.decayLength);
+    pointingAngle.push_back(v0.pointingAngle);
+    dcaToPV.push_back(v0.dcaToPV);
+  }
 };
 
 class V0Reconstructor {
 public:
   V0Reconstructor();
+  // v0reco cuts from config instead of ConfigManager's default context
+  explicit V0Reconstructor(const ConfigContext& config);
   ~V0Reconstructor();
-  
-  // Reconstruct Lambda candidates from p and π tracks
-  std::vector<V0Candidate> ReconstructLambda(const std::vector<TrackCandidate>& protons,
-                                             const std::vector<TrackCandidate>& pions,
-                                             const EventCandidate& event,
-                                             Bool_t useTOF = kFALSE) const;
-  
+
+  // Helix-based Lambda finding (ApproximateTopology() if !event.hasHelix).
+  // protonIdx / pionIdx index into tracks (see
+  // TreeReader::GetProtonIndices). Candidates passing the v0reco topology and
+  // mass cuts are written to out, which is cleared first. Returns out.Size().
+  // The pair loop is GetLambdaCandidates(); this copies its records into columns.
+  Int_t FindLambdas(const TrackBlock& tracks,
+                    const std::vector<Int_t>& protonIdx,
+                    const std::vector<Int_t>& pionIdx,
+                    const EventCandidate& event,
+                    V0Candidates& out) const;
+
+  // Lambda candidates passing all cuts, as V0Candidate records; cuts are
+  // applied before a record is written. out is cleared first and keeps its
+  // capacity, so reuse one vector for every event.
+  Int_t GetLambdaCandidates(const TrackBlock& tracks,
+                            const std::vector<Int_t>& protonIdx,
+                            const std::vector<Int_t>& pionIdx,
+                            const EventCandidate& event,
+                            std::vector<V0Candidate>& out) const;
+
   // Apply topology cuts to V0 candidate
   Bool_t PassTopologyCuts(const V0Candidate& v0) const;
-  
-  // Calculate topology variables
-  void CalculateTopology(V0Candidate& v0, const EventCandidate& event) const;
-  
-  // Get Lambda candidates passing all cuts
-  std::vector<V0Candidate> GetLambdaCandidates(const std::vector<TrackCandidate>& protons,
-                                                const std::vector<TrackCandidate>& pions,
-                                                const EventCandidate& event,
-                                                Bool_t useTOF = kFALSE) const;
+  Bool_t PassTopologyCuts(const V0Topology& topo) const;
+
+  // Calculate kinematics and topology of v0 from its daughter indices.
+  // Returns kFALSE (and sets values failing every cut) if no DCA solution exists.
+  Bool_t CalculateTopology(V0Candidate& v0, const TrackBlock& tracks,
+                           const EventCandidate& event) const;
+
+  // Fill a V0Candidate from a solved topology
+  static void FillCandidate(V0Candidate& v0, Int_t iProton, Int_t iPion,
+                            const V0Topology& topo, Int_t eventIndex);
+
+  // Helix of row i of tracks in the event field
+  static TrackHelix MakeHelix(const TrackBlock& tracks, Int_t i, Double_t bField);
+
+  // Solve the daughter pair once and fill the V0 topology for the given mass hypothesis.
+  // Returns kFALSE if the helix DCA could not be found.
+  static Bool_t SolveTopology(const TrackHelix& hPos, const TrackHelix& hNeg,
+                              Double_t massPos, Double_t massNeg,
+                              const EventCandidate& event, V0Topology& topo);
+
+  // Topology for input without bField/origin branches (event.hasHelix false),
+  // where every helix would be a line from (0,0,0): daughter DCA, decay length
+  // and DCA to PV from the daughters' DCA to the primary vertex, the decay
+  // vertex on the V0 momentum at that decay length, momenta at the reference point.
+  static void ApproximateTopology(const TrackBlock& tracks, Int_t iPos, Int_t iNeg,
+                                  Double_t massPos, Double_t massNeg,
+                                  const EventCandidate& event, V0Topology& topo);
 
 private:
-  // Calculate DCA between two tracks
-  Double_t CalculateDCA(const TrackCandidate& trk1, const TrackCandidate& trk2) const;
-  
-  // Calculate decay length (simplified - assumes straight line)
-  Double_t CalculateDecayLength(const V0Candidate& v0, const EventCandidate& event) const;
-  
-  // Calculate pointing angle
-  Double_t CalculatePointingAngle(const V0Candidate& v0, const EventCandidate& event) const;
-  
-  // Calculate DCA of V0 to primary vertex
-  Double_t CalculateDCAToPV(const V0Candidate& v0, const EventCandidate& event) const;
+  const ConfigContext* fConfig;
+
+  // Per-event helix scratch, reused across calls
+  mutable std::vector<TrackHelix> fProtonHelices;
+  mutable std::vector<TrackHelix> fPionHelices;
+  mutable std::vector<V0Candidate> fCandidates;  // FindLambdas scratch
+
+  void BuildHelices(const TrackBlock& tracks,
+                    const std::vector<Int_t>& protonIdx,
+                    const std::vector<Int_t>& pionIdx,
+                    Double_t bField) const;
 };
 
 #endif
-
@@ -2,10 +2,12 @@
 #define EVENT_CUT_CONFIG_H
 
 #include "Rtypes.h"
+#include "TriggerSelection.h"
 
 class EventCutConfig {
 public:
-  static EventCutConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const EventCutConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
   
   // Cut values (public member variables)
@@ -16,11 +18,17 @@ public:
   Double_t maxVzDiff;
   Double_t maxAbsVzVpd;  // cm; use VPD (e.g. for hVzDiff / vzDiff cut) only when |vzVpd| < this
   Int_t maxNTr;  // 0 or negative = no limit; event skipped when nTracks > maxNTr
+  TriggerSelection triggers;  // "triggerIds"; empty = all triggers
 
   // Set default values
   void SetDefaults();
+
+  // Vertex, refMult and VPD cuts (everything except maxNTr, which needs the tracks,
+  // and the trigger selection, see triggers.Match())
+  Bool_t Pass(Float_t vz, Float_t vr, Int_t refMult, Float_t vzVpd) const;
   
 private:
+  friend class ConfigContext;  // each context owns its own instance
   EventCutConfig();
   ~EventCutConfig();
   EventCutConfig(const EventCutConfig&);  // Copy constructor (disabled)
@@ -5,7 +5,8 @@
 
 class Lambda1520CutConfig {
 public:
-  static Lambda1520CutConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const Lambda1520CutConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
   
   // Cut values (public member variables)
@@ -13,11 +14,15 @@ public:
   Double_t nSigmaKaon;
   Double_t minInvMass;
   Double_t maxInvMass;
+  Double_t maxDCAProton;   // cm, DCA to PV
+  Double_t maxDCAKaon;     // cm, DCA to PV
+  Bool_t fillLikeSign;     // also fill pK+ / pbarK- (combinatorial background)
 
   // Set default values
   void SetDefaults();
   
 private:
+  friend class ConfigContext;  // each context owns its own instance
   Lambda1520CutConfig();
   ~Lambda1520CutConfig();
   Lambda1520CutConfig(const Lambda1520CutConfig&);
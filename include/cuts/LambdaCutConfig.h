@@ -5,7 +5,8 @@
 
 class LambdaCutConfig {
 public:
-  static LambdaCutConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const LambdaCutConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
 
   // V0 Lambda (p+ pi-) reconstruction cuts
@@ -17,10 +18,28 @@ public:
   Double_t maxDCAV0;         // max DCA of Lambda to primary vertex
   Double_t minCosPointing;   // min cos(pointing angle)
   Double_t maxPathLength;    // max |path length| for helix (e.g. 100)
+  Double_t lambdaMassMin;    // Lambda / anti-Lambda invariant mass window
+  Double_t lambdaMassMax;
+
+  // Hypotheses evaluated on each (+,-) daughter pair. Anti-Lambda (pbar+ pi+)
+  // uses the Lambda PID and topology cuts with the charges swapped.
+  Bool_t enableLambda;
+  Bool_t enableAntiLambda;
+  Bool_t enableK0s;
+
+  // K0S (pi+ pi-) cuts
+  Double_t nSigmaPionK0s;
+  Double_t minDCAPionK0s;      // min DCA to PV for both pions
+  Double_t maxDaughterDCAK0s;
+  Double_t maxDCAV0K0s;
+  Double_t minCosPointingK0s;
+  Double_t k0sMassMin;
+  Double_t k0sMassMax;
 
   void SetDefaults();
 
 private:
+  friend class ConfigContext;  // each context owns its own instance
   LambdaCutConfig();
   ~LambdaCutConfig();
   LambdaCutConfig(const LambdaCutConfig&);
@@ -5,7 +5,8 @@
 
 class MixingConfig {
 public:
-  static MixingConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const MixingConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
   
   // Config values (public member variables)
@@ -18,6 +19,7 @@ public:
   void SetDefaults();
   
 private:
+  friend class ConfigContext;  // each context owns its own instance
   MixingConfig();
   ~MixingConfig();
   MixingConfig(const MixingConfig&);
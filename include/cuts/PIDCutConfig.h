@@ -5,7 +5,8 @@
 
 class PIDCutConfig {
 public:
-  static PIDCutConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const PIDCutConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
   
   // Cut values (public member variables)
@@ -25,6 +26,7 @@ public:
   void SetDefaults();
   
 private:
+  friend class ConfigContext;  // each context owns its own instance
   PIDCutConfig();
   ~PIDCutConfig();
   PIDCutConfig(const PIDCutConfig&);
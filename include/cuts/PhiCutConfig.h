@@ -5,7 +5,8 @@
 
 class PhiCutConfig {
 public:
-  static PhiCutConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const PhiCutConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
   
   // Cut values (public member variables)
@@ -16,6 +17,10 @@ public:
   Double_t maxDCAKK;
   Double_t minInvMass;
   Double_t maxInvMass;
+  // Pair-loop mass window on the straight-line K+K- mass, checked before the helix DCA;
+  // wider than the hMKK axis (default by 20 MeV each side) so no helix-DCA mass in range is lost
+  Double_t minInvMassPre;
+  Double_t maxInvMassPre;
   Double_t minOpeningAngle;
   Double_t maxOpeningAngle;
   Double_t minPairRapidity;
@@ -31,6 +36,7 @@ public:
   void SetDefaults();
   
 private:
+  friend class ConfigContext;  // each context owns its own instance
   PhiCutConfig();
   ~PhiCutConfig();
   PhiCutConfig(const PhiCutConfig&);
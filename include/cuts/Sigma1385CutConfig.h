@@ -5,7 +5,8 @@
 
 class Sigma1385CutConfig {
 public:
-  static Sigma1385CutConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const Sigma1385CutConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
   
   // Cut values (public member variables)
@@ -14,11 +15,15 @@ public:
   Double_t nSigmaPionForSigma;
   Double_t minInvMass;
   Double_t maxInvMass;
+  Double_t lambdaMassWindow;      // |M(p pi) - M_Lambda| for Lambda candidates used
+  Double_t maxDCABachelor;        // max DCA to PV for the bachelor pion
+  Double_t maxDCABachelorLambda;  // max DCA between bachelor helix and Lambda line
 
   // Set default values
   void SetDefaults();
   
 private:
+  friend class ConfigContext;  // each context owns its own instance
   Sigma1385CutConfig();
   ~Sigma1385CutConfig();
   Sigma1385CutConfig(const Sigma1385CutConfig&);
@@ -1,11 +1,13 @@
 #ifndef TRACK_CUT_CONFIG_H
 #define TRACK_CUT_CONFIG_H
 
+#include <string>
 #include "Rtypes.h"
 
 class TrackCutConfig {
 public:
-  static TrackCutConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const TrackCutConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
   
   // Cut values (public member variables)
@@ -18,10 +20,15 @@ public:
   Double_t maxPt;
   Double_t maxChi2;
 
+  // Extra cut as an expression over the track columns, applied together with
+  // the cuts above (see CutExpression.h); empty for none
+  std::string expression;
+
   // Set default values
   void SetDefaults();
   
 private:
+  friend class ConfigContext;  // each context owns its own instance
   TrackCutConfig();
   ~TrackCutConfig();
   TrackCutConfig(const TrackCutConfig&);
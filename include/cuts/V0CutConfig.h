@@ -5,7 +5,8 @@
 
 class V0CutConfig {
 public:
-  static V0CutConfig& GetInstance();
+  // Cuts of ConfigManager's default context (see ConfigContext)
+  static const V0CutConfig& GetInstance();
   Bool_t LoadFromFile(const Char_t* filename);
   
   // Cut values (public member variables)
@@ -23,6 +24,7 @@ public:
   void SetDefaults();
   
 private:
+  friend class ConfigContext;  // each context owns its own instance
   V0CutConfig();
   ~V0CutConfig();
   V0CutConfig(const V0CutConfig&);
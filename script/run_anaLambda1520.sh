@@ -0,0 +1,34 @@
+#!/bin/bash
+# Run anaLambda1520.C - Lambda(1520) -> p K analysis (StLambda1520Maker)
+# Usage: Run from project root: ./script/run_anaLambda1520.sh
+#        ./script/run_anaLambda1520.sh [inputFile] [outputFile] [jobid] [nEvents] [configPath] [readMode]
+#        readMode: 0 StPicoDstMaker reads (default), 1 macro reads, 2 tracks read
+#        only for events passing the event cuts (1 and 2 print bytes per entry)
+# Default: auau19 list, auau19_anaLambda1520 output, main_auau19_anaLambda1520.yaml
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+cd "$PROJECT_ROOT" || exit 1
+
+source "$SCRIPT_DIR/setup.sh" config/mainconf/main_auau19_anaLambda1520.yaml
+export LD_LIBRARY_PATH="$PROJECT_ROOT/lib:$LD_LIBRARY_PATH"
+
+INPUT_FILE="${1:-config/picoDstList/auau19GeV.list}"
+OUTPUT_FILE="${2:-rootfile/auau19_anaLambda1520/auau19_anaLambda1520.root}"
+JOBID="${3:-0}"
+NEVENTS="${4:--1}"
+CONFIG_PATH="${5:-}"
+READ_MODE="${6:-0}"
+
+mkdir -p "$(dirname "$OUTPUT_FILE")"
+
+echo "=== anaLambda1520.C ==="
+echo "Input:   $INPUT_FILE"
+echo "Output:  $OUTPUT_FILE"
+echo "JobID:   $JOBID"
+echo "nEvents: $NEVENTS"
+echo "Config:  ${CONFIG_PATH:-config/mainconf/main_auau19_anaLambda1520.yaml (default)}"
+echo "Read:    mode $READ_MODE"
+echo "================================"
+
+root4star -b -q "analysis/run_anaLambda1520.C(\"$INPUT_FILE\",\"$OUTPUT_FILE\",\"$JOBID\",$NEVENTS,\"$CONFIG_PATH\",$READ_MODE)"
@@ -0,0 +1,34 @@
+#!/bin/bash
+# Run anaMulti.C - combined phi + Lambda analysis (one pass, shared event selection)
+# Usage: Run from project root: ./script/run_anaMulti.sh
+#        ./script/run_anaMulti.sh [inputFile] [outputFile] [jobid] [nEvents] [configPath]
+# Default: auau19 list, auau19_anaMulti output, main_auau19_anaMulti.yaml
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+cd "$PROJECT_ROOT" || exit 1
+
+source "$SCRIPT_DIR/setup.sh" config/mainconf/main_auau19_anaMulti.yaml
+export LD_LIBRARY_PATH="$PROJECT_ROOT/lib:$LD_LIBRARY_PATH"
+
+INPUT_FILE="${1:-config/picoDstList/auau19GeV.list}"
+OUTPUT_FILE="${2:-rootfile/auau19_anaMulti/auau19_anaMulti.root}"
+JOBID="${3:-0}"
+NEVENTS="${4:--1}"
+CONFIG_PATH="${5:-}"
+
+mkdir -p "$(dirname "$OUTPUT_FILE")"
+
+echo "=== anaMulti.C ==="
+echo "Input:   $INPUT_FILE"
+echo "Output:  $OUTPUT_FILE"
+echo "JobID:   $JOBID"
+echo "nEvents: $NEVENTS"
+echo "Config:  ${CONFIG_PATH:-config/mainconf/main_auau19_anaMulti.yaml (default)}"
+echo "================================"
+
+if [ -n "$CONFIG_PATH" ]; then
+  root4star -b -q "analysis/run_anaMulti.C(\"$INPUT_FILE\",\"$OUTPUT_FILE\",\"$JOBID\",$NEVENTS,\"$CONFIG_PATH\")"
+else
+  root4star -b -q "analysis/run_anaMulti.C(\"$INPUT_FILE\",\"$OUTPUT_FILE\",\"$JOBID\",$NEVENTS)"
+fi
@@ -1,7 +1,11 @@
 #!/bin/bash
 # Run anaPhi.C - phi analysis with StPhiMaker
 # Usage: Run from project root: ./script/run_anaPhi.sh
-#        ./script/run_anaPhi.sh [inputFile] [outputFile] [jobid] [nEvents] [configPath]
+#        ./script/run_anaPhi.sh [inputFile] [outputFile] [jobid] [nEvents] [configPath] [tagFile] [readMode]
+#        tagFile: event-tag index of inputFile (analysis/run_buildEventTags.C); only
+#        entries passing the event cuts are read
+#        readMode: 0 StPicoDstMaker reads (default), 1 macro reads, 2 tracks read
+#        only for events passing the event cuts (1 and 2 print bytes per entry)
 # Default: main_auau19_anaPhi.yaml
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
@@ -16,6 +20,8 @@ OUTPUT_FILE="${2:-rootfile/auau19_anaPhi_temp/auau19_anaPhi_temp.root}"
 JOBID="${3:-0}"
 NEVENTS="${4:--1}"
 CONFIG_PATH="${5:-}"
+TAG_FILE="${6:-}"
+READ_MODE="${7:-0}"
 
 mkdir -p "$(dirname "$OUTPUT_FILE")"
 
@@ -25,10 +31,8 @@ echo "Output:  $OUTPUT_FILE"
 echo "JobID:   $JOBID"
 echo "nEvents: $NEVENTS"
 echo "Config:  ${CONFIG_PATH:-config/mainconf/main_auau19_anaPhi.yaml (default)}"
+echo "Tags:    ${TAG_FILE:-none}"
+echo "Read:    mode $READ_MODE"
 echo "================================"
 
-if [ -n "$CONFIG_PATH" ]; then
-  root4star -b -q "analysis/run_anaPhi.C(\"$INPUT_FILE\",\"$OUTPUT_FILE\",\"$JOBID\",$NEVENTS,\"$CONFIG_PATH\")"
-else
-  root4star -b -q "analysis/run_anaPhi.C(\"$INPUT_FILE\",\"$OUTPUT_FILE\",\"$JOBID\",$NEVENTS)"
-fi
+root4star -b -q "analysis/run_anaPhi.C(\"$INPUT_FILE\",\"$OUTPUT_FILE\",\"$JOBID\",$NEVENTS,\"$CONFIG_PATH\",\"$TAG_FILE\",$READ_MODE)"
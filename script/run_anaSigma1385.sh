@@ -0,0 +1,34 @@
+#!/bin/bash
+# Run anaSigma1385.C - Sigma(1385) -> Lambda pi analysis (StLambdaMaker + StSigma1385Maker)
+# Usage: Run from project root: ./script/run_anaSigma1385.sh
+#        ./script/run_anaSigma1385.sh [inputFile] [outputFile] [jobid] [nEvents] [configPath]
+# Default: auau19 list, auau19_anaSigma1385 output, main_auau19_anaSigma1385.yaml
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+cd "$PROJECT_ROOT" || exit 1
+
+source "$SCRIPT_DIR/setup.sh" config/mainconf/main_auau19_anaSigma1385.yaml
+export LD_LIBRARY_PATH="$PROJECT_ROOT/lib:$LD_LIBRARY_PATH"
+
+INPUT_FILE="${1:-config/picoDstList/auau19GeV.list}"
+OUTPUT_FILE="${2:-rootfile/auau19_anaSigma1385/auau19_anaSigma1385.root}"
+JOBID="${3:-0}"
+NEVENTS="${4:--1}"
+CONFIG_PATH="${5:-}"
+
+mkdir -p "$(dirname "$OUTPUT_FILE")"
+
+echo "=== anaSigma1385.C ==="
+echo "Input:   $INPUT_FILE"
+echo "Output:  $OUTPUT_FILE"
+echo "JobID:   $JOBID"
+echo "nEvents: $NEVENTS"
+echo "Config:  ${CONFIG_PATH:-config/mainconf/main_auau19_anaSigma1385.yaml (default)}"
+echo "================================"
+
+if [ -n "$CONFIG_PATH" ]; then
+  root4star -b -q "analysis/run_anaSigma1385.C(\"$INPUT_FILE\",\"$OUTPUT_FILE\",\"$JOBID\",$NEVENTS,\"$CONFIG_PATH\")"
+else
+  root4star -b -q "analysis/run_anaSigma1385.C(\"$INPUT_FILE\",\"$OUTPUT_FILE\",\"$JOBID\",$NEVENTS)"
+fi
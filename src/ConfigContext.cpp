@@ -0,0 +1,217 @@
+#include "ConfigContext.h"
+#include "cuts/EventCutConfig.h"
+#include "cuts/TrackCutConfig.h"
+#include "cuts/PIDCutConfig.h"
+#include "cuts/V0CutConfig.h"
+#include "cuts/PhiCutConfig.h"
+#include "cuts/LambdaCutConfig.h"
+#include "cuts/Lambda1520CutConfig.h"
+#include "cuts/Sigma1385CutConfig.h"
+#include "cuts/MixingConfig.h"
+#include "RunQuality.h"
+#include "YamlParser.h"
+#include <map>
+#include <string>
+#include <iostream>
+#include <fstream>
+
+namespace {
+  std::string trimWhitespace(const std::string& s) {
+    const char* ws = " \t\r\n";
+    size_t start = s.find_first_not_of(ws);
+    if (start == std::string::npos) return "";
+    size_t end = s.find_last_not_of(ws);
+    return s.substr(start, end - start + 1);
+  }
+
+  // Cut config keys of main.yaml, in load order
+  const char* const kCutKeys[] = {
+    "event", "track", "pid", "v0", "phi", "lambda", "lambda1520", "sigma1385", "mixing"
+  };
+  const Int_t kNCutKeys = sizeof(kCutKeys) / sizeof(kCutKeys[0]);
+}
+
+ConfigContext::ConfigContext(const Char_t* mainConfigPath) {
+  Create();
+  Load(mainConfigPath);
+}
+
+ConfigContext::ConfigContext() {
+  Create();
+}
+
+void ConfigContext::Create() {
+  eventCuts = new EventCutConfig();
+  trackCuts = new TrackCutConfig();
+  pidCuts = new PIDCutConfig();
+  v0Cuts = new V0CutConfig();
+  phiCuts = new PhiCutConfig();
+  lambdaCuts = new LambdaCutConfig();
+  lambda1520Cuts = new Lambda1520CutConfig();
+  sigma1385Cuts = new Sigma1385CutConfig();
+  mixingConfig = new MixingConfig();
+  runQuality = new RunQuality();
+  m_valid = kFALSE;
+}
+
+ConfigContext::~ConfigContext() {
+  delete eventCuts;
+  delete trackCuts;
+  delete pidCuts;
+  delete v0Cuts;
+  delete phiCuts;
+  delete lambdaCuts;
+  delete lambda1520Cuts;
+  delete sigma1385Cuts;
+  delete mixingConfig;
+  delete runQuality;
+}
+
+Bool_t ConfigContext::Load(const Char_t* mainConfigPath) {
+  std::map<std::string, std::string> values;
+  if (!YamlParser::ParseFile(mainConfigPath, values)) {
+    std::cerr << "ERROR: Failed to parse main config file: " << mainConfigPath << std::endl;
+    m_valid = kFALSE;
+    return kFALSE;
+  }
+
+  // Base path = project root (path before "/config/" in full path). Supports any main filename (e.g. main.yaml, main_pp500.yaml).
+  std::string pathStr(mainConfigPath);
+  std::string basePath;
+  size_t configPos = pathStr.find("/config/");
+  if (configPos != std::string::npos) {
+    basePath = pathStr.substr(0, configPos + 1);  // include trailing slash
+  }
+
+  m_mainConfigPath = pathStr;
+  m_mainConfigValues = values;
+  m_configBasePath = basePath;
+  m_anaName.clear();
+  runQuality->Clear();
+
+  // Load each config file (relativePath is under config/; fullPath = basePath + "config/" + relativePath)
+  Bool_t success = kTRUE;
+  for (Int_t k = 0; k < kNCutKeys; k++) {
+    if (values.find(kCutKeys[k]) == values.end()) {
+      std::cerr << "WARNING: '" << kCutKeys[k] << "' key not found in main config" << std::endl;
+      continue;
+    }
+    if (!LoadConfigFile(basePath, kCutKeys[k])) success = kFALSE;
+  }
+
+  if (values.find("analysis") != values.end()) {
+    std::string analysisRel = trimWhitespace(values["analysis"]);
+    if (!analysisRel.empty()) {
+      std::string analysisPath = basePath;
+      if (!analysisPath.empty() && analysisPath[analysisPath.length() - 1] != '/') {
+        analysisPath += "/";
+      }
+      analysisPath += "config/";
+      analysisPath += analysisRel;
+      if (ParseAnalysisInfoAnaName(analysisPath) && !LoadRunQuality(analysisPath)) success = kFALSE;
+    }
+  }
+
+  m_valid = success;
+  return success;
+}
+
+Bool_t ConfigContext::LoadConfigFile(const std::string& basePath, const std::string& key) {
+  // fullPath = basePath (project root with trailing /) + "config/" + relativePath
+  std::string fullPath = basePath;
+  if (!fullPath.empty() && fullPath[fullPath.length() - 1] != '/') {
+    fullPath += "/";
+  }
+  fullPath += "config/";
+  fullPath += m_mainConfigValues[key];
+
+  if (key == "event") return eventCuts->LoadFromFile(fullPath.c_str());
+  if (key == "track") return trackCuts->LoadFromFile(fullPath.c_str());
+  if (key == "pid") return pidCuts->LoadFromFile(fullPath.c_str());
+  if (key == "v0") return v0Cuts->LoadFromFile(fullPath.c_str());
+  if (key == "phi") return phiCuts->LoadFromFile(fullPath.c_str());
+  if (key == "lambda") return lambdaCuts->LoadFromFile(fullPath.c_str());
+  if (key == "lambda1520") return lambda1520Cuts->LoadFromFile(fullPath.c_str());
+  if (key == "sigma1385") return sigma1385Cuts->LoadFromFile(fullPath.c_str());
+  if (key == "mixing") return mixingConfig->LoadFromFile(fullPath.c_str());
+  std::cerr << "ERROR: Unknown config type: " << key << std::endl;
+  return kFALSE;
+}
+
+Bool_t ConfigContext::ParseAnalysisInfoAnaName(const std::string& analysisInfoPath) {
+  m_anaName.clear();
+  std::ifstream file(analysisInfoPath.c_str());
+  if (!file.is_open()) {
+    std::cerr << "WARNING: Cannot open analysis info file: " << analysisInfoPath << std::endl;
+    return kFALSE;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.find("anaName") == std::string::npos) continue;
+    size_t q1 = line.find('"');
+    if (q1 != std::string::npos) {
+      size_t q2 = line.find('"', q1 + 1);
+      if (q2 != std::string::npos && q2 > q1 + 1) {
+        m_anaName = line.substr(q1 + 1, q2 - q1 - 1);
+        break;
+      }
+    }
+    q1 = line.find('\'');
+    if (q1 != std::string::npos) {
+      size_t q2 = line.find('\'', q1 + 1);
+      if (q2 != std::string::npos && q2 > q1 + 1) {
+        m_anaName = line.substr(q1 + 1, q2 - q1 - 1);
+        break;
+      }
+    }
+  }
+  file.close();
+  return kTRUE;
+}
+
+Bool_t ConfigContext::LoadRunQuality(const std::string& analysisInfoPath) {
+  // goodRunList / badRunList are unique keys of analysis_info, so the flat parser finds them
+  std::map<std::string, std::string> info;
+  if (!YamlParser::ParseFile(analysisInfoPath.c_str(), info)) return kFALSE;
+  std::string lists[2];
+  const char* const keys[2] = { "goodRunList", "badRunList" };
+  for (Int_t k = 0; k < 2; k++) {
+    std::string value = trimWhitespace(info[keys[k]]);
+    if (value.size() >= 2 && (value[0] == '"' || value[0] == '\'') && value[value.size() - 1] == value[0]) {
+      value = value.substr(1, value.size() - 2);
+    }
+    if (value.empty() || value[0] == '/') {
+      lists[k] = value;
+    } else {
+      lists[k] = m_configBasePath + "config/" + value;  // under config/, like allPicoDstList
+    }
+  }
+  return runQuality->Load(lists[0], lists[1]);
+}
+
+std::string ConfigContext::GetHistConfigPath(const std::string& key) const {
+  std::map<std::string, std::string>::const_iterator it = m_mainConfigValues.find(key);
+  if (it == m_mainConfigValues.end()) {
+    std::cerr << "WARNING: GetHistConfigPath: key '" << key << "' not found in main config" << std::endl;
+    return "";
+  }
+  std::string value = trimWhitespace(it->second);
+  if (value.empty()) {
+    std::cerr << "WARNING: GetHistConfigPath: key '" << key << "' has empty value" << std::endl;
+    return "";
+  }
+  if (m_configBasePath.empty()) {
+    return std::string("config/") + value;
+  }
+  return m_configBasePath + "config/" + value;
+}
+
+Bool_t ConfigContext::HasMainConfigKey(const std::string& key) const {
+  return m_mainConfigValues.find(key) != m_mainConfigValues.end();
+}
+
+std::string ConfigContext::GetMainConfigValue(const std::string& key) const {
+  std::map<std::string, std::string>::const_iterator it = m_mainConfigValues.find(key);
+  if (it == m_mainConfigValues.end()) return "";
+  return trimWhitespace(it->second);
+}
@@ -1,301 +1,85 @@
 #include "ConfigManager.h"
-#include "cuts/EventCutConfig.h"
-#include "cuts/TrackCutConfig.h"
-#include "cuts/PIDCutConfig.h"
-#include "cuts/V0CutConfig.h"
-#include "cuts/PhiCutConfig.h"
-#include "cuts/LambdaCutConfig.h"
-#include "cuts/Lambda1520CutConfig.h"
-#include "cuts/Sigma1385CutConfig.h"
-#include "cuts/MixingConfig.h"
-#include "YamlParser.h"
-#include <map>
 #include <string>
 #include <iostream>
-#include <fstream>
-#include <cstring>
-
-namespace {
-  std::string trimWhitespace(const std::string& s) {
-    const char* ws = " \t\r\n";
-    size_t start = s.find_first_not_of(ws);
-    if (start == std::string::npos) return "";
-    size_t end = s.find_last_not_of(ws);
-    return s.substr(start, end - start + 1);
-  }
-}
 
 ConfigManager& ConfigManager::GetInstance() {
   static ConfigManager instance;
   return instance;
 }
 
-ConfigManager::ConfigManager() 
-  : eventCuts(0), trackCuts(0), pidCuts(0), v0Cuts(0),
-    phiCuts(0), lambdaCuts(0), lambda1520Cuts(0), sigma1385Cuts(0), mixingConfig(0),
-    isLoaded(kFALSE) {
-  // Initialize all cut config instances
-  eventCuts = &EventCutConfig::GetInstance();
-  trackCuts = &TrackCutConfig::GetInstance();
-  pidCuts = &PIDCutConfig::GetInstance();
-  v0Cuts = &V0CutConfig::GetInstance();
-  phiCuts = &PhiCutConfig::GetInstance();
-  lambdaCuts = &LambdaCutConfig::GetInstance();
-  lambda1520Cuts = &Lambda1520CutConfig::GetInstance();
-  sigma1385Cuts = &Sigma1385CutConfig::GetInstance();
-  mixingConfig = &MixingConfig::GetInstance();
+ConfigManager::ConfigManager()
+  : isLoaded(kFALSE) {
 }
 
 ConfigManager::~ConfigManager() {
-  // Note: We don't delete the instances since they are singletons
 }
 
 Bool_t ConfigManager::LoadConfig(const Char_t* mainConfigPath) {
   if (isLoaded) {
     std::cerr << "WARNING: Config already loaded, reloading..." << std::endl;
   }
-  
-  if (!ParseMainConfig(mainConfigPath)) {
+
+  if (!m_context.Load(mainConfigPath)) {
     std::cerr << "ERROR: Failed to parse main config file: " << mainConfigPath << std::endl;
     return kFALSE;
   }
-  
+
   isLoaded = kTRUE;
   return kTRUE;
 }
 
-Bool_t ConfigManager::ParseMainConfig(const Char_t* filename) {
-  std::map<std::string, std::string> values;
-  if (!YamlParser::ParseFile(filename, values)) {
-    std::cerr << "ERROR: Failed to parse main config file: " << filename << std::endl;
-    return kFALSE;
-  }
-  
-  // Base path = project root (path before "/config/" in full path). Supports any main filename (e.g. main.yaml, main_pp500.yaml).
-  std::string pathStr(filename);
-  std::string basePath;
-  size_t configPos = pathStr.find("/config/");
-  if (configPos != std::string::npos) {
-    basePath = pathStr.substr(0, configPos + 1);  // include trailing slash
-  } else {
-    basePath = "";
-  }
-
-  m_mainConfigValues = values;
-  m_configBasePath = basePath;
-  m_anaName.clear();
-
-  // Load each config file (relativePath is under config/; fullPath = basePath + "config/" + relativePath)
-  Bool_t success = kTRUE;
-
-  if (values.find("event") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["event"].c_str(), "event")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'event' key not found in main config" << std::endl;
-  }
-  
-  if (values.find("track") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["track"].c_str(), "track")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'track' key not found in main config" << std::endl;
-  }
-  
-  if (values.find("pid") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["pid"].c_str(), "pid")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'pid' key not found in main config" << std::endl;
-  }
-  
-  if (values.find("v0") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["v0"].c_str(), "v0")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'v0' key not found in main config" << std::endl;
-  }
-  
-  if (values.find("phi") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["phi"].c_str(), "phi")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'phi' key not found in main config" << std::endl;
-  }
-
-  if (values.find("lambda") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["lambda"].c_str(), "lambda")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'lambda' key not found in main config" << std::endl;
-  }
-  
-  if (values.find("lambda1520") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["lambda1520"].c_str(), "lambda1520")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'lambda1520' key not found in main config" << std::endl;
-  }
-  
-  if (values.find("sigma1385") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["sigma1385"].c_str(), "sigma1385")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'sigma1385' key not found in main config" << std::endl;
-  }
-  
-  if (values.find("mixing") != values.end()) {
-    if (!LoadConfigFile(basePath.c_str(), values["mixing"].c_str(), "mixing")) {
-      success = kFALSE;
-    }
-  } else {
-    std::cerr << "WARNING: 'mixing' key not found in main config" << std::endl;
-  }
-
-  if (values.find("analysis") != values.end()) {
-    std::string analysisRel = trimWhitespace(values["analysis"]);
-    if (!analysisRel.empty()) {
-      std::string analysisPath = basePath;
-      if (!analysisPath.empty() && analysisPath[analysisPath.length() - 1] != '/') {
-        analysisPath += "/";
-      }
-      analysisPath += "config/";
-      analysisPath += analysisRel;
-      ParseAnalysisInfoAnaName(analysisPath);
-    }
-  }
-
-  return success;
+std::string ConfigManager::GetAnaName() const {
+  return m_context.GetAnaName();
 }
 
-Bool_t ConfigManager::ParseAnalysisInfoAnaName(const std::string& analysisInfoPath) {
-  m_anaName.clear();
-  std::ifstream file(analysisInfoPath.c_str());
-  if (!file.is_open()) {
-    std::cerr << "WARNING: Cannot open analysis info file: " << analysisInfoPath << std::endl;
-    return kFALSE;
-  }
-  std::string line;
-  while (std::getline(file, line)) {
-    if (line.find("anaName") == std::string::npos) continue;
-    size_t q1 = line.find('"');
-    if (q1 != std::string::npos) {
-      size_t q2 = line.find('"', q1 + 1);
-      if (q2 != std::string::npos && q2 > q1 + 1) {
-        m_anaName = line.substr(q1 + 1, q2 - q1 - 1);
-        break;
-      }
-    }
-    q1 = line.find('\'');
-    if (q1 != std::string::npos) {
-      size_t q2 = line.find('\'', q1 + 1);
-      if (q2 != std::string::npos && q2 > q1 + 1) {
-        m_anaName = line.substr(q1 + 1, q2 - q1 - 1);
-        break;
-      }
-    }
-  }
-  file.close();
-  return kTRUE;
+std::string ConfigManager::GetHistConfigPath() {
+  return m_context.GetHistConfigPath();
 }
 
-std::string ConfigManager::GetAnaName() const {
-  return m_anaName;
+std::string ConfigManager::GetHistConfigPath(const std::string& key) {
+  return m_context.GetHistConfigPath(key);
 }
 
-std::string ConfigManager::GetHistConfigPath() {
-  const std::string key("hist");
-  std::map<std::string, std::string>::const_iterator it = m_mainConfigValues.find(key);
-  if (it == m_mainConfigValues.end()) {
-    std::cerr << "WARNING: GetHistConfigPath: key '" << key << "' not found in main config" << std::endl;
-    return "";
-  }
-  std::string value = trimWhitespace(it->second);
-  if (value.empty()) {
-    std::cerr << "WARNING: GetHistConfigPath: key '" << key << "' has empty value" << std::endl;
-    return "";
-  }
-  if (m_configBasePath.empty()) {
-    return std::string("config/") + value;
-  }
-  return m_configBasePath + "config/" + value;
+Bool_t ConfigManager::HasMainConfigKey(const std::string& key) const {
+  return m_context.HasMainConfigKey(key);
 }
 
-Bool_t ConfigManager::LoadConfigFile(const Char_t* basePath, const Char_t* relativePath, const Char_t* configType) {
-  // fullPath = basePath (project root with trailing /) + "config/" + relativePath
-  std::string fullPath = basePath;
-  if (!fullPath.empty() && fullPath[fullPath.length() - 1] != '/') {
-    fullPath += "/";
-  }
-  fullPath += "config/";
-  fullPath += relativePath;
-  
-  // Load based on config type
-  if (strcmp(configType, "event") == 0) {
-    return eventCuts->LoadFromFile(fullPath.c_str());
-  } else if (strcmp(configType, "track") == 0) {
-    return trackCuts->LoadFromFile(fullPath.c_str());
-  } else if (strcmp(configType, "pid") == 0) {
-    return pidCuts->LoadFromFile(fullPath.c_str());
-  } else if (strcmp(configType, "v0") == 0) {
-    return v0Cuts->LoadFromFile(fullPath.c_str());
-  } else if (strcmp(configType, "phi") == 0) {
-    return phiCuts->LoadFromFile(fullPath.c_str());
-  } else if (strcmp(configType, "lambda") == 0) {
-    return lambdaCuts->LoadFromFile(fullPath.c_str());
-  } else if (strcmp(configType, "lambda1520") == 0) {
-    return lambda1520Cuts->LoadFromFile(fullPath.c_str());
-  } else if (strcmp(configType, "sigma1385") == 0) {
-    return sigma1385Cuts->LoadFromFile(fullPath.c_str());
-  } else if (strcmp(configType, "mixing") == 0) {
-    return mixingConfig->LoadFromFile(fullPath.c_str());
-  } else {
-    std::cerr << "ERROR: Unknown config type: " << configType << std::endl;
-    return kFALSE;
-  }
+std::string ConfigManager::GetMainConfigValue(const std::string& key) const {
+  return m_context.GetMainConfigValue(key);
 }
 
-EventCutConfig& ConfigManager::GetEventCuts() {
-  return *eventCuts;
+const EventCutConfig& ConfigManager::GetEventCuts() const {
+  return *m_context.eventCuts;
 }
 
-TrackCutConfig& ConfigManager::GetTrackCuts() {
-  return *trackCuts;
+const TrackCutConfig& ConfigManager::GetTrackCuts() const {
+  return *m_context.trackCuts;
 }
 
-PIDCutConfig& ConfigManager::GetPIDCuts() {
-  return *pidCuts;
+const PIDCutConfig& ConfigManager::GetPIDCuts() const {
+  return *m_context.pidCuts;
 }
 
-V0CutConfig& ConfigManager::GetV0Cuts() {
-  return *v0Cuts;
+const V0CutConfig& ConfigManager::GetV0Cuts() const {
+  return *m_context.v0Cuts;
 }
 
-PhiCutConfig& ConfigManager::GetPhiCuts() {
-  return *phiCuts;
+const PhiCutConfig& ConfigManager::GetPhiCuts() const {
+  return *m_context.phiCuts;
 }
 
-LambdaCutConfig& ConfigManager::GetLambdaCuts() {
-  return *lambdaCuts;
+const LambdaCutConfig& ConfigManager::GetLambdaCuts() const {
+  return *m_context.lambdaCuts;
 }
 
-Lambda1520CutConfig& ConfigManager::GetLambda1520Cuts() {
-  return *lambda1520Cuts;
+const Lambda1520CutConfig& ConfigManager::GetLambda1520Cuts() const {
+  return *m_context.lambda1520Cuts;
 }
 
-Sigma1385CutConfig& ConfigManager::GetSigma1385Cuts() {
-  return *sigma1385Cuts;
+const Sigma1385CutConfig& ConfigManager::GetSigma1385Cuts() const {
+  return *m_context.sigma1385Cuts;
 }
 
-MixingConfig& ConfigManager::GetMixingConfig() {
-  return *mixingConfig;
+const MixingConfig& ConfigManager::GetMixingConfig() const {
+  return *m_context.mixingConfig;
 }
-
@@ -0,0 +1,638 @@
+#include "CutExpression.h"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+  Bool_t isBinary(Int_t op) { return op >= CutExpression::kAdd; }
+
+  // Operator with its operands swapped (a op b == b op' a), -1 if none
+  Int_t mirrored(Int_t op) {
+    switch (op) {
+      case CutExpression::kLt: return CutExpression::kGt;
+      case CutExpression::kLe: return CutExpression::kGe;
+      case CutExpression::kGt: return CutExpression::kLt;
+      case CutExpression::kGe: return CutExpression::kLe;
+      case CutExpression::kAdd: case CutExpression::kMul:
+      case CutExpression::kMin: case CutExpression::kMax:
+      case CutExpression::kEq: case CutExpression::kNe:
+      case CutExpression::kAnd: case CutExpression::kOr:
+        return op;
+    }
+    return -1;
+  }
+
+  const char* opName(Int_t op) {
+    static const char* names[] = {
+      "load", "const", "neg", "not", "abs", "sqrt",
+      "add", "sub", "mul", "div", "min", "max",
+      "lt", "le", "gt", "ge", "eq", "ne", "and", "or"
+    };
+    return names[op];
+  }
+
+  struct Neg { Float_t operator()(Float_t a) const { return -a; } };
+  struct Not { Float_t operator()(Float_t a) const { return (Float_t)(a == 0); } };
+  struct Abs { Float_t operator()(Float_t a) const { return std::fabs(a); } };
+  struct Sqrt { Float_t operator()(Float_t a) const { return std::sqrt(a); } };
+  struct Add { Float_t operator()(Float_t a, Float_t b) const { return a + b; } };
+  struct Sub { Float_t operator()(Float_t a, Float_t b) const { return a - b; } };
+  struct Mul { Float_t operator()(Float_t a, Float_t b) const { return a * b; } };
+  struct Div { Float_t operator()(Float_t a, Float_t b) const { return a / b; } };
+  struct Min { Float_t operator()(Float_t a, Float_t b) const { return (b < a) ? b : a; } };
+  struct Max { Float_t operator()(Float_t a, Float_t b) const { return (a < b) ? b : a; } };
+  struct Lt { Float_t operator()(Float_t a, Float_t b) const { return (Float_t)(a < b); } };
+  struct Le { Float_t operator()(Float_t a, Float_t b) const { return (Float_t)(a <= b); } };
+  struct Gt { Float_t operator()(Float_t a, Float_t b) const { return (Float_t)(a > b); } };
+  struct Ge { Float_t operator()(Float_t a, Float_t b) const { return (Float_t)(a >= b); } };
+  struct Eq { Float_t operator()(Float_t a, Float_t b) const { return (Float_t)(a == b); } };
+  struct Ne { Float_t operator()(Float_t a, Float_t b) const { return (Float_t)(a != b); } };
+  // Logical ops on 0/1 floats without '&'/'|' of bools (which gcc branches on)
+  struct And { Float_t operator()(Float_t a, Float_t b) const { return (Float_t)(a != 0) * (Float_t)(b != 0); } };
+  struct Or { Float_t operator()(Float_t a, Float_t b) const { return 1.f - (Float_t)(a == 0) * (Float_t)(b == 0); } };
+
+  Float_t applyUnary(Int_t op, Float_t a) {
+    switch (op) {
+      case CutExpression::kNeg: return Neg()(a);
+      case CutExpression::kNot: return Not()(a);
+      case CutExpression::kAbs: return Abs()(a);
+      case CutExpression::kSqrt: return Sqrt()(a);
+    }
+    return a;
+  }
+
+  Float_t applyBinary(Int_t op, Float_t a, Float_t b) {
+    switch (op) {
+      case CutExpression::kAdd: return Add()(a, b);
+      case CutExpression::kSub: return Sub()(a, b);
+      case CutExpression::kMul: return Mul()(a, b);
+      case CutExpression::kDiv: return Div()(a, b);
+      case CutExpression::kMin: return Min()(a, b);
+      case CutExpression::kMax: return Max()(a, b);
+      case CutExpression::kLt: return Lt()(a, b);
+      case CutExpression::kLe: return Le()(a, b);
+      case CutExpression::kGt: return Gt()(a, b);
+      case CutExpression::kGe: return Ge()(a, b);
+      case CutExpression::kEq: return Eq()(a, b);
+      case CutExpression::kNe: return Ne()(a, b);
+      case CutExpression::kAnd: return And()(a, b);
+      case CutExpression::kOr: return Or()(a, b);
+    }
+    return a;
+  }
+
+  // Row loops, one per operand layout. Every pointer is __restrict__ (an
+  // in-place op gets its own loop) so gcc vectorizes without alias checks.
+  template <class T>
+  void convertRows(Float_t* __restrict__ dst, const T* __restrict__ src, Int_t n) {
+    for (Int_t k = 0; k < n; k++) dst[k] = (Float_t)src[k];
+  }
+
+  template <class F>
+  void unaryInPlace(Float_t* __restrict__ a, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) a[k] = f(a[k]);
+  }
+
+  template <class F>
+  void unaryRows(Float_t* __restrict__ d, const Float_t* __restrict__ a, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) d[k] = f(a[k]);
+  }
+
+  template <class F>
+  void binaryInPlace(Float_t* __restrict__ a, const Float_t* __restrict__ b, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) a[k] = f(a[k], b[k]);
+  }
+
+  template <class F>
+  void binaryInPlaceImm(Float_t* __restrict__ a, Float_t c, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) a[k] = f(a[k], c);
+  }
+
+  template <class F>
+  void binaryRows(Float_t* __restrict__ d, const Float_t* __restrict__ a,
+                  const Float_t* __restrict__ b, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) d[k] = f(a[k], b[k]);
+  }
+
+  template <class F>
+  void binaryRowsImm(Float_t* __restrict__ d, const Float_t* __restrict__ a, Float_t c, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) d[k] = f(a[k], c);
+  }
+
+  // out[k] = out[k] && f(...), for Instr::andInto
+  template <class F>
+  void unaryAnd(Float_t* __restrict__ out, const Float_t* __restrict__ a, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) out[k] = (Float_t)(out[k] != 0) * (Float_t)(f(a[k]) != 0);
+  }
+
+  template <class F>
+  void binaryAnd(Float_t* __restrict__ out, const Float_t* __restrict__ a,
+                 const Float_t* __restrict__ b, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) out[k] = (Float_t)(out[k] != 0) * (Float_t)(f(a[k], b[k]) != 0);
+  }
+
+  template <class F>
+  void binaryAndImm(Float_t* __restrict__ out, const Float_t* __restrict__ a, Float_t c, Int_t n, F f) {
+    for (Int_t k = 0; k < n; k++) out[k] = (Float_t)(out[k] != 0) * (Float_t)(f(a[k], c) != 0);
+  }
+
+  // Operands resolved for one instruction over one chunk
+  struct Args {
+    Float_t* dst;        // stack slot written
+    const Float_t* lhs;  // 0: in place on dst
+    const Float_t* rhs;  // 0: immediate
+    Float_t* andOut;     // andInto: slot and-ed with the result (dst is then only read)
+    Float_t imm;
+    Int_t n;
+  };
+
+  template <class F>
+  void unary(const Args& x, F f) {
+    if (x.andOut) unaryAnd(x.andOut, x.lhs ? x.lhs : x.dst, x.n, f);
+    else if (x.lhs) unaryRows(x.dst, x.lhs, x.n, f);
+    else unaryInPlace(x.dst, x.n, f);
+  }
+
+  template <class F>
+  void binary(const Args& x, F f) {
+    if (x.andOut) {
+      const Float_t* a = x.lhs ? x.lhs : x.dst;
+      if (x.rhs) binaryAnd(x.andOut, a, x.rhs, x.n, f);
+      else binaryAndImm(x.andOut, a, x.imm, x.n, f);
+    } else if (x.lhs) {
+      if (x.rhs) binaryRows(x.dst, x.lhs, x.rhs, x.n, f);
+      else binaryRowsImm(x.dst, x.lhs, x.imm, x.n, f);
+    } else {
+      if (x.rhs) binaryInPlace(x.dst, x.rhs, x.n, f);
+      else binaryInPlaceImm(x.dst, x.imm, x.n, f);
+    }
+  }
+
+  Int_t storeResult(const Float_t* __restrict__ top, Int_t n, UChar_t* __restrict__ out) {
+    Int_t nPass = 0;
+    for (Int_t k = 0; k < n; k++) {
+      const UChar_t pass = (top[k] != 0);
+      out[k] = pass;
+      nPass += pass;
+    }
+    return nPass;
+  }
+}
+
+//-----------------------------------------------------------------------------
+CutExpression::CutExpression() : fMaxDepth(0), fPos(0), fBegin(0) {}
+
+void CutExpression::Reset() {
+  fSource.clear();
+  fError.clear();
+  fCode.clear();
+  fVars.clear();
+  fMaxDepth = 0;
+  fStack.clear();
+  fConvert.clear();
+  fColumn.clear();
+}
+
+Bool_t CutExpression::Compile(const std::string& expr) {
+  Reset();
+  fSource = expr;
+  fBegin = fPos = fSource.c_str();
+  SkipSpace();
+  if (*fPos == '\0') return kTRUE;  // empty: no cut
+
+  Bool_t ok = ParseOr();
+  SkipSpace();
+  if (ok && *fPos != '\0') ok = Fail("unexpected '" + std::string(fPos, 1) + "'");
+  if (!ok) {
+    const std::string err = fError;
+    Reset();
+    fSource = expr;
+    fError = err;
+    return kFALSE;
+  }
+
+  // Stack depth: an op reading a column (or a constant) pushes, a binary op
+  // taking its right operand from the stack pops, an andInto op pops its result
+  Int_t depth = 0;
+  for (size_t i = 0; i < fCode.size(); i++) {
+    const Instr& in = fCode[i];
+    if (isBinary(in.op) && in.rhs == kStack) depth--;
+    if (in.op == kConst || in.lhs != kStack) depth++;
+    if (depth > fMaxDepth) fMaxDepth = depth;
+    if (in.andInto) depth--;
+  }
+  fStack.resize(fMaxDepth * kChunk);
+  fConvert.resize(fVars.size() * kChunk);
+  fColumn.resize(fVars.size());
+  return kTRUE;
+}
+
+Int_t CutExpression::FindVariable(const std::string& name) const {
+  for (size_t i = 0; i < fVars.size(); i++) {
+    if (fVars[i].name == name) return (Int_t)i;
+  }
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+Bool_t CutExpression::BindColumn(const std::string& name, Int_t type, const void* data) {
+  Int_t slot = FindVariable(name);
+  if (slot < 0) return kFALSE;
+  fVars[slot].type = type;
+  fVars[slot].data = data;
+  fVars[slot].bound = kTRUE;
+  return kTRUE;
+}
+
+Bool_t CutExpression::Bind(const std::string& name, const Float_t* column) { return BindColumn(name, kFloat, column); }
+Bool_t CutExpression::Bind(const std::string& name, const Int_t* column) { return BindColumn(name, kInt, column); }
+Bool_t CutExpression::Bind(const std::string& name, const Short_t* column) { return BindColumn(name, kShort, column); }
+Bool_t CutExpression::Bind(const std::string& name, const Char_t* column) { return BindColumn(name, kChar, column); }
+Bool_t CutExpression::Bind(const std::string& name, const UChar_t* column) { return BindColumn(name, kUChar, column); }
+
+Bool_t CutExpression::CheckBindings() {
+  for (size_t i = 0; i < fVars.size(); i++) {
+    if (!fVars[i].bound) {
+      fError = "unknown variable '" + fVars[i].name + "'";
+      return kFALSE;
+    }
+  }
+  return kTRUE;
+}
+
+//-----------------------------------------------------------------------------
+Int_t CutExpression::Evaluate(Int_t n, UChar_t* out) {
+  if (fCode.empty()) {
+    if (n > 0) std::memset(out, 1, n);
+    return n;
+  }
+  Int_t nPass = 0;
+  for (Int_t first = 0; first < n; first += kChunk) {
+    const Int_t m = (n - first < kChunk) ? n - first : (Int_t)kChunk;
+    Run(first, m);
+    nPass += storeResult(&fStack[0], m, out + first);
+  }
+  return nPass;
+}
+
+Int_t CutExpression::Evaluate(Int_t n, std::vector<UChar_t>& out) {
+  out.resize(n);
+  if (n == 0) return 0;
+  return Evaluate(n, &out[0]);
+}
+
+void CutExpression::Run(Int_t first, Int_t n) {
+  // Float_t columns are read in place; the others are converted once per chunk
+  for (size_t v = 0; v < fVars.size(); v++) {
+    Float_t* buf = &fConvert[v * kChunk];
+    const void* data = fVars[v].data;
+    switch (fVars[v].type) {
+      case kFloat: fColumn[v] = (const Float_t*)data + first; continue;
+      case kInt: convertRows(buf, (const Int_t*)data + first, n); break;
+      case kShort: convertRows(buf, (const Short_t*)data + first, n); break;
+      case kChar: convertRows(buf, (const Char_t*)data + first, n); break;
+      case kUChar: convertRows(buf, (const UChar_t*)data + first, n); break;
+    }
+    fColumn[v] = buf;
+  }
+
+  Float_t* stack = &fStack[0];
+  Int_t sp = 0;  // number of live stack slots
+  for (size_t i = 0; i < fCode.size(); i++) {
+    const Instr& in = fCode[i];
+    Args x;
+    x.n = n;
+    x.imm = in.imm;
+    x.rhs = 0;
+    if (isBinary(in.op) && in.rhs != kImm) {
+      if (in.rhs == kStack) x.rhs = stack + (--sp) * kChunk;
+      else x.rhs = fColumn[in.rhs];
+    }
+    if (in.op == kConst || in.lhs != kStack) {
+      x.dst = stack + (sp++) * kChunk;
+      x.lhs = (in.op == kConst) ? 0 : fColumn[in.lhs];
+    } else {
+      x.dst = stack + (sp - 1) * kChunk;
+      x.lhs = 0;
+    }
+    x.andOut = 0;
+    if (in.andInto) {
+      sp--;
+      x.andOut = stack + (sp - 1) * kChunk;
+    }
+
+    switch (in.op) {
+      case kLoad: std::memcpy(x.dst, x.lhs, n * sizeof(Float_t)); break;
+      case kConst: for (Int_t k = 0; k < n; k++) x.dst[k] = in.imm; break;
+      case kNeg: unary(x, Neg()); break;
+      case kNot: unary(x, Not()); break;
+      case kAbs: unary(x, Abs()); break;
+      case kSqrt: unary(x, Sqrt()); break;
+      case kAdd: binary(x, Add()); break;
+      case kSub: binary(x, Sub()); break;
+      case kMul: binary(x, Mul()); break;
+      case kDiv: binary(x, Div()); break;
+      case kMin: binary(x, Min()); break;
+      case kMax: binary(x, Max()); break;
+      case kLt: binary(x, Lt()); break;
+      case kLe: binary(x, Le()); break;
+      case kGt: binary(x, Gt()); break;
+      case kGe: binary(x, Ge()); break;
+      case kEq: binary(x, Eq()); break;
+      case kNe: binary(x, Ne()); break;
+      case kAnd: binary(x, And()); break;
+      case kOr: binary(x, Or()); break;
+    }
+  }
+}
+
+void CutExpression::Print() const {
+  std::cout << "CutExpression \"" << fSource << "\": " << fCode.size()
+            << " instructions, stack depth " << fMaxDepth << std::endl;
+  for (size_t i = 0; i < fCode.size(); i++) {
+    const Instr& in = fCode[i];
+    std::cout << "  " << i << ": " << opName(in.op);
+    if (in.op == kConst) {
+      std::cout << " " << in.imm;
+    } else {
+      std::cout << " " << ((in.lhs == kStack) ? std::string("[top]") : fVars[in.lhs].name);
+      if (isBinary(in.op)) {
+        if (in.rhs == kStack) std::cout << ", [pop]";
+        else if (in.rhs == kImm) std::cout << ", " << in.imm;
+        else std::cout << ", " << fVars[in.rhs].name;
+      }
+    }
+    if (in.andInto) std::cout << "  (and into [pop])";
+    std::cout << std::endl;
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Code emission. A lone constant or column load just before an op is folded
+// into it as an operand, an op on constants only is evaluated here, and '&&'
+// rides on the op before it: 'abs(nSigmaKaon) < 2 && dca < 2' is three
+// instructions (abs, lt, lt-and).
+void CutExpression::EmitConst(Float_t value) {
+  Instr in;
+  in.op = kConst;
+  in.lhs = kStack;
+  in.rhs = kStack;
+  in.imm = value;
+  in.andInto = kFALSE;
+  fCode.push_back(in);
+}
+
+void CutExpression::EmitLoad(const std::string& name) {
+  Int_t slot = FindVariable(name);
+  if (slot < 0) {
+    Variable v;
+    v.name = name;
+    v.type = kFloat;
+    v.data = 0;
+    v.bound = kFALSE;
+    fVars.push_back(v);
+    slot = (Int_t)fVars.size() - 1;
+  }
+  Instr in;
+  in.op = kLoad;
+  in.lhs = slot;
+  in.rhs = kStack;
+  in.imm = 0;
+  in.andInto = kFALSE;
+  fCode.push_back(in);
+}
+
+void CutExpression::EmitUnary(Int_t op) {
+  Instr& last = fCode.back();
+  if (last.op == kConst) {
+    last.imm = applyUnary(op, last.imm);
+    return;
+  }
+  if (last.op == kLoad) {  // op reads the column directly
+    last.op = op;
+    return;
+  }
+  Instr in;
+  in.op = op;
+  in.lhs = kStack;
+  in.rhs = kStack;
+  in.imm = 0;
+  in.andInto = kFALSE;
+  fCode.push_back(in);
+}
+
+void CutExpression::EmitBinary(Int_t op) {
+  // 'a && b' with b computed by its own op: and b's result straight into a
+  Instr& last = fCode.back();
+  if (op == kAnd && last.op != kConst && last.op != kLoad && !last.andInto) {
+    last.andInto = kTRUE;
+    return;
+  }
+
+  Instr in;
+  in.op = op;
+  in.lhs = kStack;
+  in.rhs = kStack;
+  in.imm = 0;
+  in.andInto = kFALSE;
+
+  // Right operand: a constant or a column load emitted just before
+  const Instr& right = fCode.back();
+  if (right.op == kConst) {
+    in.rhs = kImm;
+    in.imm = right.imm;
+    fCode.pop_back();
+  } else if (right.op == kLoad) {
+    in.rhs = right.lhs;
+    fCode.pop_back();
+  }
+
+  // Left operand: with the right one folded, the previous instruction ends it
+  if (in.rhs != kStack) {
+    Instr& left = fCode.back();
+    if (left.op == kConst && in.rhs == kImm) {
+      left.imm = applyBinary(op, left.imm, in.imm);
+      return;
+    }
+    if (left.op == kLoad) {
+      left.op = op;
+      left.rhs = in.rhs;
+      left.imm = in.imm;
+      return;
+    }
+    // constant op column -> column op' constant (e.g. '0.2 < pT')
+    if (left.op == kConst && in.rhs >= 0 && mirrored(op) >= 0) {
+      const Float_t c = left.imm;
+      left.op = mirrored(op);
+      left.lhs = in.rhs;
+      left.rhs = kImm;
+      left.imm = c;
+      return;
+    }
+  }
+  fCode.push_back(in);
+}
+
+//-----------------------------------------------------------------------------
+// Parser (recursive descent, lowest precedence first):
+//   or      := and ('||' and)*
+//   and     := compare ('&&' compare)*
+//   compare := add [('<' | '<=' | '>' | '>=' | '==' | '!=') add]
+//   add     := mul (('+' | '-') mul)*
+//   mul     := unary (('*' | '/') unary)*
+//   unary   := ('-' | '+' | '!') unary | primary
+//   primary := number | name | func '(' or [',' or] ')' | '(' or ')'
+void CutExpression::SkipSpace() {
+  while (*fPos && std::isspace((unsigned char)*fPos)) fPos++;
+}
+
+Bool_t CutExpression::Accept(const char* token) {
+  SkipSpace();
+  const size_t len = std::strlen(token);
+  if (std::strncmp(fPos, token, len) != 0) return kFALSE;
+  fPos += len;
+  return kTRUE;
+}
+
+Bool_t CutExpression::Fail(const std::string& what) {
+  char col[32];
+  std::snprintf(col, sizeof(col), "%d", (Int_t)(fPos - fBegin) + 1);
+  fError = what + " at column " + col + " in \"" + fSource + "\"";
+  return kFALSE;
+}
+
+Bool_t CutExpression::ParseOr() {
+  if (!ParseAnd()) return kFALSE;
+  while (Accept("||")) {
+    if (!ParseAnd()) return kFALSE;
+    EmitBinary(kOr);
+  }
+  return kTRUE;
+}
+
+Bool_t CutExpression::ParseAnd() {
+  if (!ParseCompare()) return kFALSE;
+  while (Accept("&&")) {
+    if (!ParseCompare()) return kFALSE;
+    EmitBinary(kAnd);
+  }
+  return kTRUE;
+}
+
+Bool_t CutExpression::ParseCompare() {
+  if (!ParseAdd()) return kFALSE;
+  Int_t op = -1;
+  // Two-character operators first
+  if (Accept("<=")) op = kLe;
+  else if (Accept(">=")) op = kGe;
+  else if (Accept("==")) op = kEq;
+  else if (Accept("!=")) op = kNe;
+  else if (Accept("<")) op = kLt;
+  else if (Accept(">")) op = kGt;
+  if (op < 0) return kTRUE;
+  if (!ParseAdd()) return kFALSE;
+  EmitBinary(op);
+  return kTRUE;
+}
+
+Bool_t CutExpression::ParseAdd() {
+  if (!ParseMul()) return kFALSE;
+  for (;;) {
+    Int_t op;
+    if (Accept("+")) op = kAdd;
+    else if (Accept("-")) op = kSub;
+    else return kTRUE;
+    if (!ParseMul()) return kFALSE;
+    EmitBinary(op);
+  }
+}
+
+Bool_t CutExpression::ParseMul() {
+  if (!ParseUnary()) return kFALSE;
+  for (;;) {
+    Int_t op;
+    if (Accept("*")) op = kMul;
+    else if (Accept("/")) op = kDiv;
+    else return kTRUE;
+    if (!ParseUnary()) return kFALSE;
+    EmitBinary(op);
+  }
+}
+
+Bool_t CutExpression::ParseUnary() {
+  SkipSpace();
+  if (Accept("-")) {
+    if (!ParseUnary()) return kFALSE;
+    EmitUnary(kNeg);
+    return kTRUE;
+  }
+  if (Accept("+")) return ParseUnary();
+  // '!' but not '!='
+  if (fPos[0] == '!' && fPos[1] != '=') {
+    fPos++;
+    if (!ParseUnary()) return kFALSE;
+    EmitUnary(kNot);
+    return kTRUE;
+  }
+  return ParsePrimary();
+}
+
+Bool_t CutExpression::ParsePrimary() {
+  SkipSpace();
+  const char c = *fPos;
+
+  if (c == '(') {
+    fPos++;
+    if (!ParseOr()) return kFALSE;
+    if (!Accept(")")) return Fail("expected ')'");
+    return kTRUE;
+  }
+
+  if (std::isdigit((unsigned char)c) || c == '.') {
+    char* end = 0;
+    const Double_t value = std::strtod(fPos, &end);
+    if (end == fPos) return Fail("bad number");
+    fPos = end;
+    EmitConst((Float_t)value);
+    return kTRUE;
+  }
+
+  if (std::isalpha((unsigned char)c) || c == '_') {
+    const char* start = fPos;
+    while (std::isalnum((unsigned char)*fPos) || *fPos == '_') fPos++;
+    const std::string name(start, fPos - start);
+    SkipSpace();
+    if (*fPos != '(') {
+      EmitLoad(name);
+      return kTRUE;
+    }
+
+    // Function call
+    Int_t op = -1, nArgs = 1;
+    if (name == "abs" || name == "fabs") op = kAbs;
+    else if (name == "sqrt") op = kSqrt;
+    else if (name == "min") { op = kMin; nArgs = 2; }
+    else if (name == "max") { op = kMax; nArgs = 2; }
+    if (op < 0) {
+      fPos = start;
+      return Fail("unknown function '" + name + "'");
+    }
+    fPos++;
+    if (!ParseOr()) return kFALSE;
+    if (nArgs == 2) {
+      if (!Accept(",")) return Fail("expected ',' in " + name + "()");
+      if (!ParseOr()) return kFALSE;
+      EmitBinary(op);
+    } else {
+      EmitUnary(op);
+    }
+    if (!Accept(")")) return Fail("expected ')' after " + name + "() argument");
+    return kTRUE;
+  }
+
+  if (c == '\0') return Fail("unexpected end of expression");
+  return Fail("unexpected '" + std::string(1, c) + "'");
+}
@@ -1,9 +1,17 @@
 #include "EventMixer.h"
 #include <TMath.h>
 #include <TRandom.h>
+#include <algorithm>
 
 EventMixer::EventMixer() {
-  const auto& mixingConfig = CutConfig::Mixing::Get();
+  Configure(CutConfig::Mixing::Get());
+}
+
+EventMixer::EventMixer(const ConfigContext& config) {
+  Configure(config.GetMixingConfig());
+}
+
+void EventMixer::Configure(const MixingConfig& mixingConfig) {
   nVzBins = mixingConfig.nVzBins;
   nCentralityBins = mixingConfig.nCentralityBins;
   nEventPlaneBins = mixingConfig.nEventPlaneBins;
@@ -55,19 +63,24 @@ Int_t EventMixer::GetMixingBinIndex(const EventCandidate& evt) const {
   return CalculateBinIndex(evt.Vz, evt.centrality, evt.psi2);
 }
 
-void EventMixer::AddEvent(const EventCandidate& evt, const std::vector<TrackCandidate>& tracks) {
+void EventMixer::AddEvent(const EventCandidate& evt, const TrackBlock& tracks) {
   Int_t binIndex = GetMixingBinIndex(evt);
   
-  MixingEvent mixEvt;
-  mixEvt.event = evt;
-  mixEvt.tracks = tracks;
-  
-  mixingPool[binIndex].push_back(mixEvt);
-  
-  // Keep only the last bufferSize events in each bin
-  if ((Int_t)mixingPool[binIndex].size() > bufferSize) {
-    mixingPool[binIndex].erase(mixingPool[binIndex].begin());
+  std::vector<MixingEvent>& pool = mixingPool[binIndex];
+
+  // Keep only the last bufferSize events in each bin; the oldest entry is
+  // overwritten column by column, so its capacity is reused
+  if ((Int_t)pool.size() >= bufferSize && !pool.empty()) {
+    std::rotate(pool.begin(), pool.begin() + 1, pool.end());
+    MixingEvent& mixEvt = pool.back();
+    mixEvt.event = evt;
+    mixEvt.tracks = tracks;
+    return;
   }
+
+  pool.push_back(MixingEvent());
+  pool.back().event = evt;
+  pool.back().tracks = tracks;
 }
 
 const MixingEvent* EventMixer::GetRandomEvent(Int_t binIndex) const {
@@ -81,21 +94,21 @@ const MixingEvent* EventMixer::GetRandomEvent(Int_t binIndex) const {
   return &(it->second[randomIndex]);
 }
 
-std::vector<Double_t> EventMixer::GenerateMixedPairs(const std::vector<TrackCandidate>& tracks1,
-                                                      const std::vector<TrackCandidate>& tracks2,
+std::vector<Double_t> EventMixer::GenerateMixedPairs(const TrackBlock& tracks1,
+                                                      const TrackBlock& tracks2,
                                                       Int_t nPairs) const {
   std::vector<Double_t> masses;
   masses.reserve(nPairs);
   
-  if (tracks1.empty() || tracks2.empty()) return masses;
+  if (tracks1.Empty() || tracks2.Empty()) return masses;
   
   // Simple mixing: randomly select from tracks1 and tracks2
   for (Int_t i = 0; i < nPairs; i++) {
-    Int_t idx1 = (Int_t)(gRandom->Uniform(0, tracks1.size()));
-    Int_t idx2 = (Int_t)(gRandom->Uniform(0, tracks2.size()));
+    Int_t idx1 = (Int_t)(gRandom->Uniform(0, tracks1.Size()));
+    Int_t idx2 = (Int_t)(gRandom->Uniform(0, tracks2.Size()));
     
     // Calculate invariant mass (assuming massless for default)
-    Double_t mass = TreeReader::CalculateInvariantMassMassless(tracks1[idx1], tracks2[idx2]);
+    Double_t mass = TreeReader::CalculateInvariantMassMassless(tracks1, idx1, tracks2, idx2);
     masses.push_back(mass);
   }
   
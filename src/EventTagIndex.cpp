@@ -0,0 +1,105 @@
+#include "EventTagIndex.h"
+#include <TFile.h>
+#include <TTree.h>
+#include <TDirectory.h>
+#include <iostream>
+
+EventTagIndex::EventTagIndex()
+  : fFile(0), fTree(0), fWriting(kFALSE) {
+  fTag.entry = 0;
+  fTag.file = 0;
+  fTag.runId = fTag.eventId = 0;
+  fTag.vz = fTag.vr = fTag.vzVpd = 0;
+  fTag.refMult = 0;
+  fTag.nTriggerIds = 0;
+}
+
+EventTagIndex::~EventTagIndex() {
+  Close();
+}
+
+Bool_t EventTagIndex::Create(const Char_t* filename, const Char_t* inputList) {
+  Close();
+  TDirectory* saveDir = gDirectory;
+  fFile = TFile::Open(filename, "RECREATE");
+  if (!fFile || fFile->IsZombie()) {
+    std::cerr << "ERROR: [EventTagIndex] Cannot create " << filename << std::endl;
+    delete fFile;
+    fFile = 0;
+    if (saveDir) saveDir->cd();
+    return kFALSE;
+  }
+  fTree = new TTree("EventTags", inputList);  // owned by fFile
+  fWriting = kTRUE;
+  fTree->Branch("entry", &fTag.entry, "entry/L");
+  fTree->Branch("file", &fTag.file, "file/I");
+  fTree->Branch("runId", &fTag.runId, "runId/I");
+  fTree->Branch("eventId", &fTag.eventId, "eventId/I");
+  fTree->Branch("vz", &fTag.vz, "vz/F");
+  fTree->Branch("vr", &fTag.vr, "vr/F");
+  fTree->Branch("vzVpd", &fTag.vzVpd, "vzVpd/F");
+  fTree->Branch("refMult", &fTag.refMult, "refMult/I");
+  fTree->Branch("nTriggerIds", &fTag.nTriggerIds, "nTriggerIds/I");
+  fTree->Branch("triggerIds", fTag.triggerIds, "triggerIds[nTriggerIds]/i");
+  if (saveDir) saveDir->cd();
+  return kTRUE;
+}
+
+void EventTagIndex::Fill() {
+  if (!fTree || !fWriting) return;
+  if (fTag.nTriggerIds > kMaxTriggerIds) fTag.nTriggerIds = kMaxTriggerIds;
+  fTree->Fill();
+}
+
+Bool_t EventTagIndex::Close() {
+  if (!fFile) return kTRUE;
+  TDirectory* saveDir = gDirectory;
+  fFile->cd();
+  if (fWriting) fTree->Write();
+  const Bool_t ok = !fWriting || !fFile->TestBit(TFile::kWriteError);
+  fFile->Close();
+  delete fFile;
+  fFile = 0;
+  fTree = 0;
+  if (saveDir) saveDir->cd();
+  if (!ok) std::cerr << "ERROR: [EventTagIndex] Write error, index is incomplete" << std::endl;
+  fWriting = kFALSE;
+  return ok;
+}
+
+Bool_t EventTagIndex::Open(const Char_t* filename, Long64_t nEntries) {
+  Close();
+  TDirectory* saveDir = gDirectory;
+  fFile = TFile::Open(filename, "READ");
+  if (saveDir) saveDir->cd();
+  if (!fFile || fFile->IsZombie()) {
+    std::cerr << "ERROR: [EventTagIndex] Cannot open " << filename << std::endl;
+    delete fFile;
+    fFile = 0;
+    return kFALSE;
+  }
+  fTree = dynamic_cast<TTree*>(fFile->Get("EventTags"));
+  if (!fTree || fTree->GetEntries() != nEntries) {
+    std::cerr << "ERROR: [EventTagIndex] " << filename << " has "
+              << (fTree ? fTree->GetEntries() : 0) << " tags for " << nEntries
+              << " entries; rebuild it from the same file list" << std::endl;
+    Close();
+    return kFALSE;
+  }
+  fTree->SetBranchAddress("entry", &fTag.entry);
+  fTree->SetBranchAddress("file", &fTag.file);
+  fTree->SetBranchAddress("runId", &fTag.runId);
+  fTree->SetBranchAddress("eventId", &fTag.eventId);
+  fTree->SetBranchAddress("vz", &fTag.vz);
+  fTree->SetBranchAddress("vr", &fTag.vr);
+  fTree->SetBranchAddress("vzVpd", &fTag.vzVpd);
+  fTree->SetBranchAddress("refMult", &fTag.refMult);
+  fTree->SetBranchAddress("nTriggerIds", &fTag.nTriggerIds);
+  fTree->SetBranchAddress("triggerIds", fTag.triggerIds);
+  return kTRUE;
+}
+
+Bool_t EventTagIndex::Read(Long64_t entry) {
+  if (!fTree || fWriting) return kFALSE;
+  return fTree->GetEntry(entry) > 0 && fTag.entry == entry;
+}
@@ -1,20 +1,34 @@
 #include "HistManager.h"
+#include "RunQA.h"
 #include "TH1.h"
 #include "TH1F.h"
 #include "TH1I.h"
 #include "TH2F.h"
+#include "THnSparse.h"
+#include "TArrayD.h"
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TParameter.h"
+#include "TTree.h"
+#include "TMath.h"
 #include "yaml-cpp/yaml.h"
+#include <climits>
+#include <cstdio>
 #include <iostream>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 #include <cstring>
+#include <ctime>
+#include <fstream>
 
 namespace {
   struct AxisSpec {
     Int_t nBins;
     Double_t min;
     Double_t max;
+    std::string title;  // optional; used for THnSparse axes
   };
 
   std::string trim(const std::string& s) {
@@ -34,24 +48,568 @@ namespace {
       out.nBins = node["nBins"].as<Int_t>();
       out.min = node["min"].as<Double_t>();
       out.max = node["max"].as<Double_t>();
+      if (node["title"]) out.title = trim(node["title"].as<std::string>());
       return true;
     } catch (const YAML::Exception& e) {
       std::cerr << "[HistManager] parseAxisSpec error: " << e.what() << std::endl;
       return false;
     }
   }
+
+  // True if tags (a name or a list of names) contains one of names
+  bool hasAnyTag(const YAML::Node& tags, const std::set<std::string>& names) {
+    if (!tags || names.empty()) return false;
+    if (tags.IsScalar()) return names.count(trim(tags.as<std::string>())) > 0;
+    if (!tags.IsSequence()) return false;
+    for (YAML::const_iterator it = tags.begin(); it != tags.end(); ++it) {
+      if (names.count(trim(it->as<std::string>()))) return true;
+    }
+    return false;
+  }
+
+  // x axis from axis / xAxis / nBins,min,max, y axis from yAxis; logs and
+  // returns false if there is no valid x axis
+  bool parseHistAxes(const std::string& name, const YAML::Node& node, AxisSpec& x, AxisSpec& y, Bool_t& hasY) {
+    Bool_t hasX = kFALSE;
+    hasY = kFALSE;
+    if (node["axis"]) {
+      hasX = parseAxisSpec(node["axis"], x);
+    } else if (node["xAxis"]) {
+      hasX = parseAxisSpec(node["xAxis"], x);
+    }
+    if (node["yAxis"]) {
+      hasY = parseAxisSpec(node["yAxis"], y);
+    }
+    if (!hasX && node["nBins"] && node["min"] && node["max"]) {
+      try {
+        x.nBins = node["nBins"].as<Int_t>();
+        x.min = node["min"].as<Double_t>();
+        x.max = node["max"].as<Double_t>();
+        hasX = kTRUE;
+      } catch (const YAML::Exception& e) {
+        std::cerr << "[HistManager] Skipped histogram '" << name << "': invalid nBins/min/max." << std::endl;
+        return false;
+      }
+    }
+    if (!hasX) {
+      std::cerr << "[HistManager] Skipped histogram '" << name << "': missing axis (axis, xAxis, or nBins/min/max)." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Family index axis: a preset, or a count N (indices 0..N-1)
+  bool parseIndexAxis(const YAML::Node& node, AxisSpec& out) {
+    if (node.IsScalar()) {
+      try {
+        out.nBins = node.as<Int_t>();
+      } catch (const YAML::Exception& e) {
+        return false;
+      }
+      out.min = 0;
+      out.max = out.nBins;
+    } else if (!parseAxisSpec(node, out)) {
+      return false;
+    }
+    return out.nBins > 0 && out.max > out.min;
+  }
+
+  // Per-histogram "bufferSize: N", else the default (always, if SetBufferSize() fixed it)
+  Int_t bufferSizeOf(const std::string& name, const YAML::Node& node, Int_t defaultSize, Bool_t fixed) {
+    if (!node["bufferSize"] || fixed) return defaultSize;
+    try {
+      return TMath::Max(node["bufferSize"].as<Int_t>(), 0);
+    } catch (const YAML::Exception& e) {
+      std::cerr << "[HistManager] Histogram '" << name << "': invalid 'bufferSize', using " << defaultSize << "." << std::endl;
+      return defaultSize;
+    }
+  }
+
+  // Root backend: TH2F with a y axis, else TH1I or TH1F
+  TH1* createHist(const std::string& name, const std::string& title, Bool_t isInt,
+                  const AxisSpec& x, Bool_t hasY, const AxisSpec& y, const std::string& yTitle) {
+    if (hasY) {
+      TH2F* h = new TH2F(name.c_str(), title.c_str(), x.nBins, x.min, x.max, y.nBins, y.min, y.max);
+      if (!yTitle.empty()) h->GetYaxis()->SetTitle(yTitle.c_str());
+      return h;
+    }
+    if (isInt) return new TH1I(name.c_str(), title.c_str(), x.nBins, x.min, x.max);
+    return new TH1F(name.c_str(), title.c_str(), x.nBins, x.min, x.max);
+  }
+
+  // Bin as TAxis::FindBin for uniform bins: 0 below min, n+1 at/above max (and
+  // NaN), else 1 + int(n*(x-min)/(max-min)). The multiply by the precomputed
+  // scale can differ from ROOT's division only by rounding, so when it lands
+  // within that of a bin edge (integer-valued fills do) ROOT's formula decides.
+  inline Int_t findBin(Double_t x, Int_t n, Double_t min, Double_t max, Double_t scale) {
+    if (x < min) return 0;
+    if (!(x < max)) return n + 1;
+    const Double_t t = (x - min) * scale;
+    Int_t bin = (Int_t)t;
+    const Double_t frac = t - bin;
+    if (frac < 1e-6 || frac > 1 - 1e-6) bin = (Int_t)(n * (x - min) / (max - min));
+    return bin + 1;
+  }
+
+  // SplitMix64 finalizer: the hash behind the counter-based bootstrap weights
+  inline ULong64_t mix64(ULong64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // Poisson(1) by inversion of the CDF, from the top 53 bits of a hash
+  inline Float_t poisson1(ULong64_t h) {
+    const Double_t u = (h >> 11) * (1.0 / 9007199254740992.0);
+    Double_t p = 0.36787944117144233;  // e^-1
+    Double_t cdf = p;
+    Int_t k = 0;
+    while (u >= cdf && k < 20) {
+      k++;
+      p /= k;
+      cdf += p;
+    }
+    return (Float_t)k;
+  }
+
+  // "title;x title;y title" -> parts (at least one)
+  std::vector<std::string> splitTitle(const std::string& title) {
+    std::vector<std::string> parts(1);
+    for (size_t i = 0; i < title.size(); i++) {
+      if (title[i] == ';') parts.push_back("");
+      else parts.back() += title[i];
+    }
+    return parts;
+  }
+
+  // type: THnSparse, axes: [*Preset, ...]; axis titles from the presets
+  THnSparse* createSparse(const std::string& name, const std::string& title, const YAML::Node& axes) {
+    if (!axes || !axes.IsSequence() || axes.size() == 0) {
+      std::cerr << "[HistManager] Skipped histogram '" << name << "': THnSparse needs 'axes: [*Preset, ...]'." << std::endl;
+      return 0;
+    }
+    std::vector<Int_t> nBins;
+    std::vector<Double_t> mins, maxs;
+    std::vector<std::string> titles;
+    for (YAML::const_iterator it = axes.begin(); it != axes.end(); ++it) {
+      AxisSpec spec;
+      if (!parseAxisSpec(*it, spec)) {
+        std::cerr << "[HistManager] Skipped histogram '" << name << "': invalid axis " << nBins.size() << "." << std::endl;
+        return 0;
+      }
+      nBins.push_back(spec.nBins);
+      mins.push_back(spec.min);
+      maxs.push_back(spec.max);
+      titles.push_back(spec.title);
+    }
+    THnSparseF* h = new THnSparseF(name.c_str(), title.c_str(), (Int_t)nBins.size(), &nBins[0], &mins[0], &maxs[0]);
+    for (size_t i = 0; i < titles.size(); i++) {
+      if (!titles[i].empty()) h->GetAxis((Int_t)i)->SetTitle(titles[i].c_str());
+    }
+    return h;
+  }
 }
 
-HistManager::HistManager() {}
+// Flat backend: one histogram as contiguous cells in TH1 order (under/overflow
+// included, bin = binx + (nx+2)*biny) plus the TH1 stat sums. Cells are
+// Float_t for TH1F/TH2F and Int_t for TH1I, incremented as TH1F/TH1I do, so
+// the contents come out the same; they are allocated on the first fill.
+struct HistManager::FlatHist {
+  std::string name;
+  std::string title;
+  std::string yTitle;
+  Bool_t isInt;
+  Bool_t is2D;
+  Int_t nx, ny;
+  Double_t xMin, xMax, xScale;
+  Double_t yMin, yMax, yScale;
+  std::vector<Float_t> floatCells;
+  std::vector<Int_t> intCells;
+  // Unit weights, so sumw2 == sumw. Only in-range fills enter the sums
+  // (TH1 default, no StatOverflows); entries counts every fill.
+  Double_t entries, sumw, sumwx, sumwx2, sumwy, sumwy2, sumwxy;
 
-HistManager::~HistManager() {
-  for (std::map<std::string, TH1*>::iterator it = m_histograms.begin(); it != m_histograms.end(); ++it) {
-    if (it->second) {
-      delete it->second;
-      it->second = 0;
+  FlatHist(const std::string& nm, const std::string& t, Bool_t integer, const AxisSpec& x)
+    : name(nm), title(t), isInt(integer), is2D(kFALSE), nx(x.nBins), ny(0),
+      xMin(x.min), xMax(x.max), xScale(x.nBins / (x.max - x.min)),
+      yMin(0), yMax(0), yScale(0) {
+    ResetSums();
+  }
+
+  FlatHist(const std::string& nm, const std::string& t, const AxisSpec& x, const AxisSpec& y,
+           const std::string& yt)
+    : name(nm), title(t), yTitle(yt), isInt(kFALSE), is2D(kTRUE), nx(x.nBins), ny(y.nBins),
+      xMin(x.min), xMax(x.max), xScale(x.nBins / (x.max - x.min)),
+      yMin(y.min), yMax(y.max), yScale(y.nBins / (y.max - y.min)) {
+    ResetSums();
+  }
+
+  Int_t NCells() const { return is2D ? (nx + 2) * (ny + 2) : nx + 2; }
+
+  void ResetSums() { entries = sumw = sumwx = sumwx2 = sumwy = sumwy2 = sumwxy = 0; }
+
+  void Count(Int_t bin) {
+    if (isInt) {
+      if (intCells.empty()) intCells.assign(NCells(), 0);
+      if (intCells[bin] < INT_MAX) intCells[bin]++;
+    } else {
+      if (floatCells.empty()) floatCells.assign(NCells(), 0);
+      ++floatCells[bin];
+    }
+  }
+
+  void Fill(Double_t x) {
+    entries++;
+    const Int_t bin = findBin(x, nx, xMin, xMax, xScale);
+    Count(bin);
+    if (bin == 0 || bin > nx) return;
+    sumw += 1;
+    sumwx += x;
+    sumwx2 += x * x;
+  }
+
+  void Fill(Double_t x, Double_t y) {
+    entries++;
+    const Int_t binx = findBin(x, nx, xMin, xMax, xScale);
+    const Int_t biny = findBin(y, ny, yMin, yMax, yScale);
+    Count(binx + (nx + 2) * biny);
+    if (binx == 0 || binx > nx || biny == 0 || biny > ny) return;
+    sumw += 1;
+    sumwx += x;
+    sumwx2 += x * x;
+    sumwy += y;
+    sumwy2 += y * y;
+    sumwxy += x * y;
+  }
+
+  TH1* Create() const {
+    TH1* h = 0;
+    if (is2D) {
+      h = new TH2F(name.c_str(), title.c_str(), nx, xMin, xMax, ny, yMin, yMax);
+      if (!yTitle.empty()) h->GetYaxis()->SetTitle(yTitle.c_str());
+    } else if (isInt) {
+      h = new TH1I(name.c_str(), title.c_str(), nx, xMin, xMax);
+    } else {
+      h = new TH1F(name.c_str(), title.c_str(), nx, xMin, xMax);
+    }
+    // Made at Write time, usually with the output file as gDirectory:
+    // keep it owned by HistManager only
+    h->SetDirectory(0);
+    return h;
+  }
+
+  // Add counts, entries and stats into h (which may hold direct fills), then
+  // start over with empty arrays
+  void MoveInto(TH1* h) {
+    if (entries == 0) return;
+    Double_t stats[13] = {0};  // TH1::kNstat
+    h->GetStats(stats);
+    const Double_t hEntries = h->GetEntries();
+    TArrayD* sumw2 = h->GetSumw2N() ? h->GetSumw2() : 0;
+    const Int_t n = isInt ? (Int_t)intCells.size() : (Int_t)floatCells.size();
+    for (Int_t bin = 0; bin < n; bin++) {
+      const Double_t c = isInt ? (Double_t)intCells[bin] : (Double_t)floatCells[bin];
+      if (c == 0) continue;
+      h->AddBinContent(bin, c);
+      if (sumw2) sumw2->fArray[bin] += c;
+    }
+    stats[0] += sumw;
+    stats[1] += sumw;
+    stats[2] += sumwx;
+    stats[3] += sumwx2;
+    if (is2D) {
+      stats[4] += sumwy;
+      stats[5] += sumwy2;
+      stats[6] += sumwxy;
+    }
+    h->PutStats(stats);
+    h->SetEntries(hEntries + entries);
+    std::vector<Float_t>().swap(floatCells);
+    std::vector<Int_t>().swap(intCells);
+    ResetSums();
+  }
+};
+
+// Root backend with bufferSize > 0: the pending values of one histogram, in
+// fill order. TH1::FillN with no weights does per value what Fill does.
+struct HistManager::FillBuffer {
+  Bool_t is2D;
+  Int_t n;
+  std::vector<Double_t> x;
+  std::vector<Double_t> y;
+
+  FillBuffer(Int_t size, Bool_t twoD) : is2D(twoD), n(0), x(size), y(twoD ? size : 0) {}
+
+  Bool_t Full() const { return n == (Int_t)x.size(); }
+
+  void Drain(TH1* h) {
+    if (n == 0) return;
+    if (is2D) {
+      h->FillN(n, &x[0], &y[0], (const Double_t*)0, 1);
+    } else {
+      h->FillN(n, &x[0], (const Double_t*)0);
+    }
+    n = 0;
+  }
+};
+
+// type: RunIndexed - a 2D histogram over (run ID, y) with one x bin per run
+// ID. Rows (y bins with under/overflow) are allocated only for runs seen, in
+// the order seen; Write() puts the filled cells into a THnSparseF with the
+// full run axis, which hadd merges bin by bin across jobs.
+struct HistManager::RunHist {
+  std::string name;
+  std::string title;
+  Int_t nRuns;              // run-axis bins, one per ID in [runMin, runMax)
+  Double_t runMin, runMax;
+  Int_t ny;
+  Double_t yMin, yMax, yScale;
+  std::map<Int_t, Int_t> rowOf;  // run-axis bin -> row
+  std::vector<Int_t> binOfRow;
+  std::vector<Float_t> cells;    // row * (ny + 2) + ybin
+  Int_t lastBin, lastRow;        // the run of the previous fill (same all event)
+  Double_t entries;
+
+  RunHist(const std::string& nm, const std::string& t, const AxisSpec& run, const AxisSpec& y)
+    : name(nm), title(t), nRuns((Int_t)(run.max - run.min)), runMin(run.min), runMax(run.max),
+      ny(y.nBins), yMin(y.min), yMax(y.max), yScale(y.nBins / (y.max - y.min)),
+      lastBin(-1), lastRow(-1), entries(0) {}
+
+  // Row of run-axis bin, allocated if new
+  Int_t Row(Int_t bin) {
+    if (bin != lastBin) {
+      std::map<Int_t, Int_t>::const_iterator it = rowOf.find(bin);
+      if (it != rowOf.end()) {
+        lastRow = it->second;
+      } else {
+        lastRow = (Int_t)binOfRow.size();
+        rowOf[bin] = lastRow;
+        binOfRow.push_back(bin);
+        cells.resize(cells.size() + ny + 2, 0);
+      }
+      lastBin = bin;
+    }
+    return lastRow;
+  }
+
+  void Fill(Double_t run, Double_t y) {
+    entries++;
+    const Int_t bin = (run < runMin) ? 0 : !(run < runMax) ? nRuns + 1 : (Int_t)(run - runMin) + 1;
+    ++cells[Row(bin) * (ny + 2) + findBin(y, ny, yMin, yMax, yScale)];
+  }
+
+  // Cells of a THnSparseF written by Write() (checkpoint restore)
+  void Add(const THnSparse& h) {
+    Int_t idx[2];
+    for (Long64_t i = 0; i < h.GetNbins(); i++) {
+      const Double_t c = h.GetBinContent(i, idx);
+      if (c == 0 || idx[0] < 0 || idx[0] > nRuns + 1 || idx[1] < 0 || idx[1] > ny + 1) continue;
+      cells[Row(idx[0]) * (ny + 2) + idx[1]] += (Float_t)c;
+    }
+    entries += h.GetEntries();
+  }
+
+  void Write() const {
+    const Int_t nBins[2] = {nRuns, ny};
+    const Double_t mins[2] = {runMin, yMin};
+    const Double_t maxs[2] = {runMax, yMax};
+    // "title;x title;y title" as for TH2
+    const std::vector<std::string> parts = splitTitle(title);
+    THnSparseF h(name.c_str(), parts[0].c_str(), 2, nBins, mins, maxs);
+    if (parts.size() > 1) h.GetAxis(0)->SetTitle(parts[1].c_str());
+    if (parts.size() > 2) h.GetAxis(1)->SetTitle(parts[2].c_str());
+    for (size_t row = 0; row < binOfRow.size(); row++) {
+      for (Int_t ybin = 0; ybin < ny + 2; ybin++) {
+        const Float_t c = cells[row * (ny + 2) + ybin];
+        if (c == 0) continue;
+        const Int_t idx[2] = {binOfRow[row], ybin};
+        h.SetBinContent(idx, c);
+      }
+    }
+    h.SetEntries(entries);
+    h.Write();
+  }
+};
+
+// bootstrap: true - N replicas of a 1D histogram, each fill added with the
+// event's Poisson(1) weight for that replica. Cells are bin-major
+// (bin * N + replica, under/overflow included), so one fill adds N contiguous
+// floats; they are allocated on the first fill.
+struct HistManager::Bootstrap {
+  std::string name;
+  std::string title;
+  Int_t nx;
+  Double_t xMin, xMax, xScale;
+  const std::vector<Float_t>* weights;  // HistManager::m_bootWeights
+  std::vector<Float_t> cells;
+  Double_t entries;
+
+  Bootstrap(const std::string& nm, const std::string& t, const AxisSpec& x, const std::vector<Float_t>* w)
+    : name(nm), title(t), nx(x.nBins), xMin(x.min), xMax(x.max), xScale(x.nBins / (x.max - x.min)),
+      weights(w), entries(0) {}
+
+  void Fill(Double_t x, Double_t w) {
+    const Int_t n = (Int_t)weights->size();
+    if (cells.empty()) cells.assign((size_t)(nx + 2) * n, 0);
+    Float_t* c = &cells[(size_t)findBin(x, nx, xMin, xMax, xScale) * n];
+    const Float_t* wr = &(*weights)[0];
+    const Float_t fw = (Float_t)w;
+    for (Int_t r = 0; r < n; r++) c[r] += fw * wr[r];
+    entries++;
+  }
+
+  // name_bootstrap as written by Write() (checkpoint restore)
+  void Add(const TH1& h) {
+    const Int_t n = (Int_t)weights->size();
+    if (h.GetNbinsX() != nx || h.GetNbinsY() != n) {
+      std::cerr << "[HistManager] " << name << "_bootstrap: bins or replicas differ; not restored." << std::endl;
+      return;
+    }
+    if (cells.empty()) cells.assign((size_t)(nx + 2) * n, 0);
+    for (Int_t bin = 0; bin < nx + 2; bin++) {
+      for (Int_t r = 0; r < n; r++) cells[(size_t)bin * n + r] += (Float_t)h.GetBinContent(bin + (nx + 2) * (r + 1));
+    }
+    entries += h.GetEntries();
+  }
+
+  // One TH2F name_bootstrap, y bin r+1 = replica r
+  void Write() const {
+    const Int_t n = (Int_t)weights->size();
+    const std::vector<std::string> parts = splitTitle(title);
+    const std::string t = parts[0] + " (bootstrap replicas);" + (parts.size() > 1 ? parts[1] : "") + ";replica";
+    TH2F h((name + "_bootstrap").c_str(), t.c_str(), nx, xMin, xMax, n, 0, n);
+    h.SetDirectory(0);
+    for (Int_t bin = 0; bin < nx + 2 && !cells.empty(); bin++) {
+      for (Int_t r = 0; r < n; r++) {
+        const Float_t c = cells[(size_t)bin * n + r];
+        if (c != 0) h.AddBinContent(bin + (nx + 2) * (r + 1), c);
+      }
+    }
+    h.SetEntries(entries);
+    h.Write();
+  }
+};
+
+// families: section - one histogram definition instantiated per (i, j) of
+// one or two index axes. The slots exist from load (a few pointers each) so
+// handles are an index away; the histogram behind one is made on its first
+// fill, named name_i or name_i_j, with the index ranges in the title.
+struct HistManager::Family {
+  std::string name;
+  std::string title;
+  std::string yTitle;
+  Bool_t isInt;
+  Bool_t hasY;
+  AxisSpec x, y;
+  Bool_t flat;                  // flat backend; else root with bufferSize
+  Int_t bufferSize;
+  std::vector<AxisSpec> index;  // one or two
+  std::vector<Slot> slots;      // i * nJ + j
+
+  Int_t NJ() const { return index.size() > 1 ? index[1].nBins : 1; }
+
+  // name_i or name_i_j of slot k
+  std::string InstanceName(Int_t k) const {
+    const Int_t ij[2] = {k / NJ(), k % NJ()};
+    std::string instName = name;
+    char buf[32];
+    for (size_t a = 0; a < index.size(); a++) {
+      snprintf(buf, sizeof(buf), "_%d", ij[a]);
+      instName += buf;
+    }
+    return instName;
+  }
+
+  // "title;x;y" -> "title (index ranges);x;y"
+  std::string InstanceTitle(Int_t k) const {
+    const Int_t ij[2] = {k / NJ(), k % NJ()};
+    std::string range;
+    char buf[256];
+    for (size_t a = 0; a < index.size(); a++) {
+      const AxisSpec& ax = index[a];
+      if (ax.title.empty()) {
+        snprintf(buf, sizeof(buf), "%d", ij[a]);
+      } else {
+        const Double_t width = (ax.max - ax.min) / ax.nBins;
+        snprintf(buf, sizeof(buf), "%s %g-%g", ax.title.c_str(), ax.min + ij[a] * width, ax.min + (ij[a] + 1) * width);
+      }
+      range += (a ? ", " : "") + std::string(buf);
+    }
+    const size_t semi = title.find(';');
+    std::string instTitle = title.substr(0, semi) + " (" + range + ")";
+    if (semi != std::string::npos) instTitle += title.substr(semi);
+    return instTitle;
+  }
+
+  void Instantiate(Slot& slot) {
+    const Int_t k = (Int_t)(&slot - &slots[0]);
+    const std::string instName = InstanceName(k);
+    const std::string instTitle = InstanceTitle(k);
+
+    if (flat) {
+      slot.flat = hasY ? new FlatHist(instName, instTitle, x, y, yTitle) : new FlatHist(instName, instTitle, isInt, x);
+      return;
     }
+    slot.hist = createHist(instName, instTitle, isInt, x, hasY, y, yTitle);
+    // Made mid-run, when gDirectory may be an input file
+    slot.hist->SetDirectory(0);
+    if (bufferSize > 0) slot.buffer = new FillBuffer(bufferSize, hasY);
+  }
+};
+
+HistManager::HistManager()
+  : m_backend(kRootBackend), m_backendFixed(kFALSE), m_bufferSize(0), m_bufferSizeFixed(kFALSE),
+    m_runQA(0), m_ckptEvery(0), m_ckptSeconds(0), m_ckptEntry(0), m_ckptTime(0) {}
+
+HistManager::~HistManager() {
+  for (std::map<std::string, Slot>::iterator it = m_histograms.begin(); it != m_histograms.end(); ++it) {
+    FreeSlot(it->second);
   }
   m_histograms.clear();
+  for (std::map<std::string, Family*>::iterator it = m_families.begin(); it != m_families.end(); ++it) {
+    for (size_t k = 0; k < it->second->slots.size(); k++) FreeSlot(it->second->slots[k]);
+    delete it->second;
+  }
+  m_families.clear();
+  delete m_runQA;
+  for (size_t k = 0; k < m_ckptCounts.size(); k++) delete m_ckptCounts[k].second;
+}
+
+void HistManager::FreeSlot(Slot& slot) {
+  delete slot.hist;
+  delete slot.flat;
+  delete slot.buffer;
+  delete slot.run;
+  delete slot.sparse;
+  delete slot.boot;
+}
+
+void HistManager::SetBackend(Backend backend) {
+  m_backend = backend;
+  m_backendFixed = kTRUE;
+}
+
+void HistManager::DisableTags(const std::string& tags) {
+  const char* sep = ", \t[]";
+  size_t start = tags.find_first_not_of(sep);
+  while (start != std::string::npos) {
+    size_t end = tags.find_first_of(sep, start);
+    m_disabledTags.insert(tags.substr(start, end == std::string::npos ? std::string::npos : end - start));
+    start = tags.find_first_not_of(sep, end);
+  }
+}
+
+void HistManager::SetBufferSize(Int_t size) {
+  m_bufferSize = size > 0 ? size : 0;
+  m_bufferSizeFixed = kTRUE;
+}
+
+void HistManager::BeginEvent(Int_t runId, Int_t eventId) {
+  if (m_bootWeights.empty()) return;
+  const ULong64_t key = mix64(((ULong64_t)(UInt_t)runId << 32) | (UInt_t)eventId);
+  for (size_t r = 0; r < m_bootWeights.size(); r++) {
+    m_bootWeights[r] = poisson1(mix64(key + (r + 1) * 0x9E3779B97F4A7C15ULL));
+  }
 }
 
 Bool_t HistManager::LoadFromFile(const Char_t* yamlPath) {
@@ -62,6 +620,50 @@ Bool_t HistManager::LoadFromFile(const Char_t* yamlPath) {
       return kFALSE;
     }
 
+    if (root["backend"] && !m_backendFixed) {
+      const std::string backend = trim(root["backend"].as<std::string>());
+      if (backend == "flat") {
+        m_backend = kFlatBackend;
+      } else if (backend == "root") {
+        m_backend = kRootBackend;
+      } else {
+        std::cerr << "[HistManager] Unknown backend '" << backend << "' (root, flat); using root." << std::endl;
+        m_backend = kRootBackend;
+      }
+    }
+
+    if (root["bufferSize"] && !m_bufferSizeFixed) {
+      try {
+        m_bufferSize = TMath::Max(root["bufferSize"].as<Int_t>(), 0);
+      } catch (const YAML::Exception& e) {
+        std::cerr << "[HistManager] Invalid 'bufferSize'; filling unbuffered." << std::endl;
+        m_bufferSize = 0;
+      }
+    }
+
+    if (root["bootstrapReplicas"] && m_bootWeights.empty()) {
+      try {
+        const Int_t n = root["bootstrapReplicas"].as<Int_t>();
+        if (n > 0) m_bootWeights.assign(n, 1);
+      } catch (const YAML::Exception& e) {
+        std::cerr << "[HistManager] Invalid 'bootstrapReplicas'; no bootstrap." << std::endl;
+      }
+    }
+    if (root["runQA"] && !m_runQA) {
+      const YAML::Node& qa = root["runQA"];
+      if (!qa.IsMap() || !qa["observables"] || !qa["observables"].IsSequence()) {
+        std::cerr << "[HistManager] 'runQA' needs 'observables: [name, ...]'; no run QA." << std::endl;
+      } else if (!hasAnyTag(qa["tags"], m_disabledTags)) {
+        std::vector<std::string> names;
+        for (YAML::const_iterator it = qa["observables"].begin(); it != qa["observables"].end(); ++it) {
+          names.push_back(trim(it->as<std::string>()));
+        }
+        m_runQA = new RunQA(names);
+      }
+    }
+
+    Int_t nBootstrap = 0;
+
     std::map<std::string, AxisSpec> axesMap;
     if (root["axes"] && root["axes"].IsMap()) {
       for (YAML::const_iterator it = root["axes"].begin(); it != root["axes"].end(); ++it) {
@@ -95,59 +697,148 @@ Bool_t HistManager::LoadFromFile(const Char_t* yamlPath) {
       }
       std::string title = trim(histNode["title"].as<std::string>());
 
+      if (hasAnyTag(histNode["tags"], m_disabledTags)) {
+        m_disabled.insert(name);
+        continue;
+      }
+
       std::string typeStr = "TH1F";
       if (histNode["type"]) {
         typeStr = trim(histNode["type"].as<std::string>());
       }
 
+      if (typeStr == "THnSparse") {
+        THnSparse* h = createSparse(name, title, histNode["axes"]);
+        if (!h) continue;
+        if (m_histograms.count(name)) {
+          std::cerr << "[HistManager] Skipped histogram '" << name << "': already defined." << std::endl;
+          delete h;
+          continue;
+        }
+        Slot slot;
+        slot.sparse = h;
+        m_histograms[name] = slot;
+        continue;
+      }
+
       AxisSpec xSpec, ySpec;
-      Bool_t hasX = kFALSE;
       Bool_t hasY = kFALSE;
+      if (!parseHistAxes(name, histNode, xSpec, ySpec, hasY)) continue;
+
+      if (m_histograms.count(name)) {
+        std::cerr << "[HistManager] Skipped histogram '" << name << "': already defined." << std::endl;
+        continue;
+      }
+      Slot slot;
 
-      if (histNode["axis"]) {
-        hasX = parseAxisSpec(histNode["axis"], xSpec);
-      } else if (histNode["xAxis"]) {
-        hasX = parseAxisSpec(histNode["xAxis"], xSpec);
-      }
-      if (histNode["yAxis"]) {
-        hasY = parseAxisSpec(histNode["yAxis"], ySpec);
-      }
-      if (!hasX && histNode["nBins"] && histNode["min"] && histNode["max"]) {
-        try {
-          xSpec.nBins = histNode["nBins"].as<Int_t>();
-          xSpec.min = histNode["min"].as<Double_t>();
-          xSpec.max = histNode["max"].as<Double_t>();
-          hasX = kTRUE;
-        } catch (const YAML::Exception& e) {
-          std::cerr << "[HistManager] Skipped histogram '" << name << "': invalid nBins/min/max." << std::endl;
+      if (typeStr == "RunIndexed") {
+        if (!hasY) {
+          std::cerr << "[HistManager] Skipped histogram '" << name << "': RunIndexed needs xAxis (run IDs) and yAxis." << std::endl;
           continue;
         }
+        // One bin per run ID: the x range fixes the bins
+        const Double_t nRunIds = xSpec.max - xSpec.min;
+        if (xSpec.nBins != (Int_t)nRunIds) {
+          std::cerr << "[HistManager] Histogram '" << name << "': RunIndexed has one bin per run ID; xAxis nBins "
+                    << xSpec.nBins << " ignored, " << (Long64_t)nRunIds << " bins for [" << xSpec.min << ", "
+                    << xSpec.max << ")." << std::endl;
+        }
+        slot.run = new RunHist(name, title, xSpec, ySpec);
+        m_histograms[name] = slot;
+        continue;
       }
 
-      if (!hasX) {
-        std::cerr << "[HistManager] Skipped histogram '" << name << "': missing axis (axis, xAxis, or nBins/min/max)." << std::endl;
-        continue;
+      if (histNode["bootstrap"] && histNode["bootstrap"].as<bool>() && !m_bootWeights.empty()) {
+        if (hasY) {
+          std::cerr << "[HistManager] Histogram '" << name << "': bootstrap is for 1D histograms; ignored." << std::endl;
+        } else {
+          slot.boot = new Bootstrap(name, title, xSpec, &m_bootWeights);
+          nBootstrap++;
+        }
       }
 
-      if (hasY) {
-        TH2F* h = new TH2F(name.c_str(), title.c_str(),
-                           xSpec.nBins, xSpec.min, xSpec.max,
-                           ySpec.nBins, ySpec.min, ySpec.max);
-        if (histNode["yTitle"]) {
-          h->GetYaxis()->SetTitle(trim(histNode["yTitle"].as<std::string>()).c_str());
+      Int_t bufferSize = bufferSizeOf(name, histNode, m_bufferSize, m_bufferSizeFixed);
+      if (bufferSize > 0 && m_backend == kRootBackend) slot.buffer = new FillBuffer(bufferSize, hasY);
+
+      std::string yTitle;
+      if (histNode["yTitle"]) yTitle = trim(histNode["yTitle"].as<std::string>());
+      if (m_backend == kFlatBackend) {
+        if (hasY) {
+          slot.flat = new FlatHist(name, title, xSpec, ySpec, yTitle);
+        } else {
+          slot.flat = new FlatHist(name, title, typeStr == "TH1I", xSpec);
         }
-        m_histograms[name] = h;
       } else {
-        TH1* h = 0;
-        if (typeStr == "TH1I") {
-          h = new TH1I(name.c_str(), title.c_str(), xSpec.nBins, xSpec.min, xSpec.max);
-        } else {
-          h = new TH1F(name.c_str(), title.c_str(), xSpec.nBins, xSpec.min, xSpec.max);
+        slot.hist = createHist(name, title, typeStr == "TH1I", xSpec, hasY, ySpec, yTitle);
+      }
+      m_histograms[name] = slot;
+    }
+
+    if (root["families"] && root["families"].IsMap()) {
+      for (YAML::const_iterator it = root["families"].begin(); it != root["families"].end(); ++it) {
+        const std::string& name = it->first.as<std::string>();
+        const YAML::Node& famNode = it->second;
+        if (!famNode.IsMap() || !famNode["title"]) {
+          std::cerr << "[HistManager] Skipped family '" << name << "': not a map or missing 'title'." << std::endl;
+          continue;
+        }
+        if (hasAnyTag(famNode["tags"], m_disabledTags)) {
+          m_disabled.insert(name);
+          continue;
+        }
+        const std::string typeStr = famNode["type"] ? trim(famNode["type"].as<std::string>()) : "TH1F";
+        if (typeStr == "RunIndexed" || typeStr == "THnSparse") {
+          std::cerr << "[HistManager] Skipped family '" << name << "': type " << typeStr << " cannot be a family." << std::endl;
+          continue;
+        }
+        const YAML::Node& indexNode = famNode["index"];
+        if (!indexNode || !indexNode.IsSequence() || indexNode.size() < 1 || indexNode.size() > 2) {
+          std::cerr << "[HistManager] Skipped family '" << name << "': needs 'index: [*Preset]' or '[*Preset, *Preset]'." << std::endl;
+          continue;
+        }
+        std::vector<AxisSpec> index(indexNode.size());
+        Bool_t indexOk = kTRUE;
+        for (size_t a = 0; a < index.size() && indexOk; a++) indexOk = parseIndexAxis(indexNode[a], index[a]);
+        if (!indexOk) {
+          std::cerr << "[HistManager] Skipped family '" << name << "': invalid index axis." << std::endl;
+          continue;
+        }
+        AxisSpec xSpec, ySpec;
+        Bool_t hasY = kFALSE;
+        if (!parseHistAxes(name, famNode, xSpec, ySpec, hasY)) continue;
+        if (m_histograms.count(name) || m_families.count(name)) {
+          std::cerr << "[HistManager] Skipped family '" << name << "': already defined." << std::endl;
+          continue;
         }
-        if (h) m_histograms[name] = h;
+
+        Family* f = new Family();
+        f->name = name;
+        f->title = trim(famNode["title"].as<std::string>());
+        if (famNode["yTitle"]) f->yTitle = trim(famNode["yTitle"].as<std::string>());
+        f->isInt = (typeStr == "TH1I");
+        f->hasY = hasY;
+        f->x = xSpec;
+        f->y = ySpec;
+        f->flat = (m_backend == kFlatBackend);
+        f->bufferSize = bufferSizeOf(name, famNode, m_bufferSize, m_bufferSizeFixed);
+        f->index = index;
+        f->slots.resize(index.size() > 1 ? index[0].nBins * index[1].nBins : index[0].nBins);
+        for (size_t k = 0; k < f->slots.size(); k++) f->slots[k].family = f;
+        m_families[name] = f;
       }
     }
 
+    if (nBootstrap > 0) {
+      std::cout << "[HistManager] Bootstrap: " << m_bootWeights.size() << " replicas for "
+                << nBootstrap << " histogram(s)." << std::endl;
+    }
+    if (!m_disabled.empty()) {
+      std::cout << "[HistManager] " << m_disabled.size() << " histogram(s) disabled by tags:";
+      for (std::set<std::string>::const_iterator it = m_disabledTags.begin(); it != m_disabledTags.end(); ++it) {
+        std::cout << " " << *it;
+      }
+      std::cout << std::endl;
+    }
     return kTRUE;
   } catch (const YAML::BadFile& e) {
     std::cerr << "[HistManager] Failed to open file: " << yamlPath << " (" << e.what() << ")" << std::endl;
@@ -158,41 +849,288 @@ Bool_t HistManager::LoadFromFile(const Char_t* yamlPath) {
   }
 }
 
+TH1* HistManager::Materialize(Slot& slot) const {
+  if (!slot.hist && slot.flat) slot.hist = slot.flat->Create();
+  if (slot.buffer) slot.buffer->Drain(slot.hist);
+  return slot.hist;
+}
+
 TH1* HistManager::Get(const char* name) const {
   if (!name) return 0;
-  std::map<std::string, TH1*>::const_iterator it = m_histograms.find(name);
+  std::map<std::string, Slot>::iterator it = m_histograms.find(name);
   if (it == m_histograms.end()) return 0;
-  return it->second;
+  return Materialize(it->second);
 }
 
-void HistManager::Fill(const char* name, Double_t x) {
-  if (!name) return;
-  TH1* h = Get(name);
-  if (!h) {
+HistManager::Slot* HistManager::Find(const char* name) {
+  if (!name) return 0;
+  std::map<std::string, Slot>::iterator it = m_histograms.find(name);
+  if (it == m_histograms.end()) {
+    if (m_disabled.count(name)) return 0;
     if (m_missingKeyWarned.find(name) == m_missingKeyWarned.end()) {
       std::cerr << "[HistManager] Fill failed: histogram '" << name << "' not found (not defined in YAML)." << std::endl;
       m_missingKeyWarned.insert(name);
     }
-    return;
+    return 0;
   }
-  h->Fill(x);
+  return &it->second;
+}
+
+HistManager::Handle HistManager::GetHandle(const char* name) {
+  return Find(name);
+}
+
+HistManager::FamilyHandle HistManager::GetFamily(const char* name) {
+  if (!name) return 0;
+  std::map<std::string, Family*>::iterator it = m_families.find(name);
+  if (it != m_families.end()) return it->second;
+  if (!m_disabled.count(name) && m_missingKeyWarned.insert(name).second) {
+    std::cerr << "[HistManager] Family '" << name << "' not found (not defined in YAML)." << std::endl;
+  }
+  return 0;
+}
+
+HistManager::Handle HistManager::GetHandle(FamilyHandle f, Int_t i, Int_t j) const {
+  if (!f) return 0;
+  const Int_t nJ = f->NJ();
+  if (i < 0 || i >= f->index[0].nBins || j < 0 || j >= nJ) return 0;
+  return &f->slots[i * nJ + j];
+}
+
+Int_t HistManager::FindIndex(FamilyHandle f, Int_t axis, Double_t value) const {
+  if (!f || axis < 0 || axis >= (Int_t)f->index.size()) return -1;
+  const AxisSpec& a = f->index[axis];
+  const Int_t bin = findBin(value, a.nBins, a.min, a.max, a.nBins / (a.max - a.min));
+  return (bin == 0 || bin > a.nBins) ? -1 : bin - 1;
+}
+
+void HistManager::Fill(const char* name, Double_t x) {
+  Fill(Find(name), x);
 }
 
 void HistManager::Fill(const char* name, Double_t x, Double_t y) {
-  if (!name) return;
-  TH1* h = Get(name);
-  if (!h) {
-    if (m_missingKeyWarned.find(name) == m_missingKeyWarned.end()) {
-      std::cerr << "[HistManager] Fill failed: histogram '" << name << "' not found (not defined in YAML)." << std::endl;
-      m_missingKeyWarned.insert(name);
-    }
-    return;
+  Fill(Find(name), x, y);
+}
+
+void HistManager::Fill(Handle slot, Double_t x) {
+  if (!slot) return;
+  if (slot->family && !slot->hist && !slot->flat) slot->family->Instantiate(*slot);
+  if (slot->boot) slot->boot->Fill(x, 1);
+  if (slot->flat && !slot->flat->is2D) {
+    slot->flat->Fill(x);
+  } else if (slot->buffer && !slot->buffer->is2D) {
+    FillBuffer& b = *slot->buffer;
+    b.x[b.n++] = x;
+    if (b.Full()) b.Drain(slot->hist);
+  } else if (TH1* h = Materialize(*slot)) {
+    h->Fill(x);
+  }
+}
+
+void HistManager::Fill(Handle slot, Double_t x, Double_t y) {
+  if (!slot) return;
+  if (slot->family && !slot->hist && !slot->flat) slot->family->Instantiate(*slot);
+  if (slot->boot) slot->boot->Fill(x, y);  // 1D: y is the weight
+  if (slot->run) {
+    slot->run->Fill(x, y);
+  } else if (slot->flat && slot->flat->is2D) {
+    slot->flat->Fill(x, y);
+  } else if (slot->buffer && slot->buffer->is2D) {
+    FillBuffer& b = *slot->buffer;
+    b.x[b.n] = x;
+    b.y[b.n++] = y;
+    if (b.Full()) b.Drain(slot->hist);
+  } else {
+    // Also a 1D flat or buffered histogram: TH1::Fill(x, w) is a weighted
+    // fill (after the buffered values, which Materialize fills first)
+    if (TH1* h = Materialize(*slot)) h->Fill(x, y);
+  }
+}
+
+THnSparse* HistManager::GetSparse(const char* name) const {
+  if (!name) return 0;
+  std::map<std::string, Slot>::const_iterator it = m_histograms.find(name);
+  return it == m_histograms.end() ? 0 : it->second.sparse;
+}
+
+void HistManager::FillND(const char* name, const Double_t* x) {
+  FillND(Find(name), x);
+}
+
+void HistManager::FillND(Handle slot, const Double_t* x) {
+  if (slot && slot->sparse) slot->sparse->Fill(x);
+}
+
+void HistManager::FlushSlot(Slot& slot) {
+  if (slot.buffer) slot.buffer->Drain(slot.hist);
+  if (slot.flat && slot.flat->entries > 0) slot.flat->MoveInto(Materialize(slot));
+}
+
+void HistManager::WriteSlot(Slot& slot) {
+  if (TH1* h = Materialize(slot)) h->Write();
+  if (slot.run) slot.run->Write();
+  if (slot.sparse) slot.sparse->Write();
+  if (slot.boot) slot.boot->Write();
+}
+
+void HistManager::Flush() {
+  for (std::map<std::string, Slot>::iterator it = m_histograms.begin(); it != m_histograms.end(); ++it) {
+    FlushSlot(it->second);
+  }
+  for (std::map<std::string, Family*>::iterator it = m_families.begin(); it != m_families.end(); ++it) {
+    for (size_t k = 0; k < it->second->slots.size(); k++) FlushSlot(it->second->slots[k]);
   }
-  h->Fill(x, y);
 }
 
 void HistManager::Write() {
-  for (std::map<std::string, TH1*>::iterator it = m_histograms.begin(); it != m_histograms.end(); ++it) {
-    if (it->second) it->second->Write();
+  Flush();
+  for (std::map<std::string, Slot>::iterator it = m_histograms.begin(); it != m_histograms.end(); ++it) {
+    WriteSlot(it->second);
+  }
+  // Family instances never filled were never made
+  for (std::map<std::string, Family*>::iterator it = m_families.begin(); it != m_families.end(); ++it) {
+    std::vector<Slot>& slots = it->second->slots;
+    for (size_t k = 0; k < slots.size(); k++) {
+      if (slots[k].hist || slots[k].flat) WriteSlot(slots[k]);
+    }
   }
+  if (m_runQA) m_runQA->Write("RunQA");
+}
+
+void HistManager::SetCheckpoint(const std::string& path, Long64_t everyEvents, Double_t everySeconds) {
+  m_ckptPath = path;
+  m_ckptEvery = everyEvents > 0 ? everyEvents : 0;
+  m_ckptSeconds = everySeconds > 0 ? everySeconds : 0;
+  m_ckptTime = (Double_t)std::time(0);
+}
+
+void HistManager::Checkpoint(Long64_t nextEntry) {
+  if (m_ckptPath.empty() || nextEntry == m_ckptEntry) return;
+  if ((m_ckptEvery > 0 && nextEntry - m_ckptEntry >= m_ckptEvery) ||
+      (m_ckptSeconds > 0 && std::time(0) - m_ckptTime >= m_ckptSeconds)) {
+    WriteCheckpoint(nextEntry);
+  }
+}
+
+Bool_t HistManager::WriteCheckpoint(Long64_t nextEntry) {
+  if (m_ckptPath.empty()) return kFALSE;
+  m_ckptEntry = nextEntry;
+  m_ckptTime = (Double_t)std::time(0);
+  const std::string tmp = m_ckptPath + ".tmp";
+  TDirectory* prev = gDirectory;
+  TFile* f = TFile::Open(tmp.c_str(), "RECREATE");
+  Bool_t ok = f && !f->IsZombie();
+  if (ok) {
+    f->cd();
+    Write();
+    TParameter<Long64_t> entry("checkpointNextEntry", nextEntry);
+    entry.Write();
+    // One tree per AddCheckpointCounts(), one Long64_t per entry
+    for (size_t k = 0; k < m_ckptCounts.size(); k++) {
+      std::vector<Long64_t> values;
+      m_ckptCounts[k].second->Save(values);
+      Long64_t value = 0;
+      TTree* tree = new TTree(m_ckptCounts[k].first.c_str(), "checkpoint counts");
+      tree->Branch("value", &value, "value/L");
+      for (size_t i = 0; i < values.size(); i++) {
+        value = values[i];
+        tree->Fill();
+      }
+      tree->Write();
+      delete tree;
+    }
+    ok = !f->TestBit(TFile::kWriteError);
+    f->Close();
+  }
+  delete f;
+  if (prev) prev->cd();
+  // Same directory, so rename() replaces the old checkpoint in one step
+  if (ok) ok = (std::rename(tmp.c_str(), m_ckptPath.c_str()) == 0);
+  if (!ok) {
+    std::cerr << "[HistManager] Checkpoint to " << m_ckptPath << " failed; the previous one is kept." << std::endl;
+    std::remove(tmp.c_str());
+    return kFALSE;
+  }
+  std::cout << "[HistManager] Checkpoint at entry " << nextEntry << ": " << m_ckptPath << std::endl;
+  return kTRUE;
+}
+
+Bool_t HistManager::RestoreSlot(Slot& slot, const std::string& name, TDirectory* dir) {
+  Bool_t found = kFALSE;
+  if (slot.run || slot.sparse) {
+    // Not a TH1: read objects are ours to delete
+    THnSparse* saved = dynamic_cast<THnSparse*>(dir->Get(name.c_str()));
+    if (saved) {
+      if (slot.sparse) slot.sparse->Add(saved);
+      else slot.run->Add(*saved);
+      found = kTRUE;
+    }
+    delete saved;
+  } else if (TH1* saved = dynamic_cast<TH1*>(dir->Get(name.c_str()))) {
+    Materialize(slot)->Add(saved);
+    found = kTRUE;
+  }
+  if (slot.boot) {
+    if (TH1* saved = dynamic_cast<TH1*>(dir->Get((name + "_bootstrap").c_str()))) slot.boot->Add(*saved);
+  }
+  return found;
+}
+
+Long64_t HistManager::RestoreCheckpoint() {
+  if (m_ckptPath.empty() || !std::ifstream(m_ckptPath.c_str()).good()) return 0;
+  TDirectory* prev = gDirectory;
+  TFile f(m_ckptPath.c_str(), "READ");
+  TParameter<Long64_t>* entry = f.IsZombie() ? 0 : dynamic_cast<TParameter<Long64_t>*>(f.Get("checkpointNextEntry"));
+  if (!entry) {
+    std::cerr << "[HistManager] " << m_ckptPath << " is not a readable checkpoint; starting from entry 0." << std::endl;
+    if (prev) prev->cd();
+    return 0;
+  }
+  const Long64_t nextEntry = entry->GetVal();
+  delete entry;
+
+  Int_t nRestored = 0;
+  for (std::map<std::string, Slot>::iterator it = m_histograms.begin(); it != m_histograms.end(); ++it) {
+    if (RestoreSlot(it->second, it->first, &f)) nRestored++;
+  }
+  // Only the family instances that had been filled were written
+  for (std::map<std::string, Family*>::iterator it = m_families.begin(); it != m_families.end(); ++it) {
+    Family& fam = *it->second;
+    for (size_t k = 0; k < fam.slots.size(); k++) {
+      TH1* saved = dynamic_cast<TH1*>(f.Get(fam.InstanceName((Int_t)k).c_str()));
+      if (!saved) continue;
+      if (!fam.slots[k].hist && !fam.slots[k].flat) fam.Instantiate(fam.slots[k]);
+      Materialize(fam.slots[k])->Add(saved);
+      nRestored++;
+    }
+  }
+  if (m_runQA && m_runQA->Add(dynamic_cast<TTree*>(f.Get("RunQA")))) nRestored++;
+  for (size_t k = 0; k < m_ckptCounts.size(); k++) {
+    TTree* tree = dynamic_cast<TTree*>(f.Get(m_ckptCounts[k].first.c_str()));
+    if (!tree) {
+      std::cerr << "[HistManager] No " << m_ckptCounts[k].first << " in " << m_ckptPath
+                << "; those counts cover only the entries from " << nextEntry << " on." << std::endl;
+      continue;
+    }
+    Long64_t value = 0;
+    tree->SetBranchAddress("value", &value);
+    std::vector<Long64_t> values((size_t)tree->GetEntries());
+    for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+      tree->GetEntry(i);
+      values[(size_t)i] = value;
+    }
+    m_ckptCounts[k].second->Restore(values);
+  }
+  f.Close();
+  if (prev) prev->cd();
+
+  m_ckptEntry = nextEntry;
+  m_ckptTime = (Double_t)std::time(0);
+  std::cout << "[HistManager] Restored " << nRestored << " histogram(s) from " << m_ckptPath
+            << "; resuming at entry " << nextEntry << std::endl;
+  return nextEntry;
+}
+
+void HistManager::RemoveCheckpoint() {
+  if (!m_ckptPath.empty()) std::remove(m_ckptPath.c_str());
 }
@@ -0,0 +1,104 @@
+#include "RunQA.h"
+#include "TTree.h"
+#include <iostream>
+
+void RunQA::Stat::Merge(const Stat& other) {
+  if (other.n == 0) return;
+  if (n == 0) {
+    *this = other;
+    return;
+  }
+  const Long64_t nTotal = n + other.n;
+  const Double_t d = other.mean - mean;
+  mean += d * other.n / nTotal;
+  m2 += other.m2 + d * d * ((Double_t)n * other.n / nTotal);
+  n = nTotal;
+}
+
+RunQA::RunQA(const std::vector<std::string>& observables)
+  : fNames(observables), fRunId(0), fRow(0) {
+}
+
+void RunQA::SelectRun(Int_t runId) {
+  fRunId = runId;
+  std::map<Int_t, Int_t>::const_iterator it = fRowOf.find(runId);
+  Int_t row;
+  if (it != fRowOf.end()) {
+    row = it->second;
+  } else {
+    row = (Int_t)fRuns.size();
+    fRowOf[runId] = row;
+    fRuns.push_back(runId);
+    fStats.resize(fStats.size() + fNames.size());
+  }
+  fRow = row * fNames.size();
+}
+
+std::string RunQA::JoinedNames() const {
+  std::string joined;
+  for (size_t k = 0; k < fNames.size(); k++) {
+    if (k > 0) joined += ", ";
+    joined += fNames[k];
+  }
+  return joined;
+}
+
+void RunQA::Write(const Char_t* name) const {
+  const Int_t nObs = (Int_t)fNames.size();
+  Int_t run = 0, nObsBranch = nObs;
+  std::vector<Long64_t> n(nObs);
+  std::vector<Double_t> mean(nObs), m2(nObs);
+  TTree* tree = new TTree(name, JoinedNames().c_str());
+  tree->Branch("run", &run, "run/I");
+  tree->Branch("nObs", &nObsBranch, "nObs/I");
+  if (nObs > 0) {
+    tree->Branch("n", &n[0], "n[nObs]/L");
+    tree->Branch("mean", &mean[0], "mean[nObs]/D");
+    tree->Branch("m2", &m2[0], "m2[nObs]/D");
+  }
+  for (size_t row = 0; row < fRuns.size(); row++) {
+    run = fRuns[row];
+    for (Int_t k = 0; k < nObs; k++) {
+      const Stat& s = fStats[row * nObs + k];
+      n[k] = s.n;
+      mean[k] = s.mean;
+      m2[k] = s.m2;
+    }
+    tree->Fill();
+  }
+  tree->Write();
+  delete tree;
+}
+
+Bool_t RunQA::Add(TTree* tree) {
+  if (!tree) return kFALSE;
+  if (JoinedNames() != tree->GetTitle()) {
+    std::cerr << "ERROR: [RunQA] Tree '" << tree->GetName() << "' has observables '" << tree->GetTitle()
+              << "', this table '" << JoinedNames() << "'" << std::endl;
+    return kFALSE;
+  }
+  const Int_t nObs = (Int_t)fNames.size();
+  Int_t run = 0, nObsBranch = 0;
+  std::vector<Long64_t> n(nObs > 0 ? nObs : 1);
+  std::vector<Double_t> mean(n.size()), m2(n.size());
+  tree->SetBranchAddress("run", &run);
+  tree->SetBranchAddress("nObs", &nObsBranch);
+  if (nObs > 0) {
+    tree->SetBranchAddress("n", &n[0]);
+    tree->SetBranchAddress("mean", &mean[0]);
+    tree->SetBranchAddress("m2", &m2[0]);
+  }
+  for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+    tree->GetEntry(i);
+    SelectRun(run);
+    for (Int_t k = 0; k < nObs; k++) {
+      Stat s;
+      s.n = n[k];
+      s.mean = mean[k];
+      s.m2 = m2[k];
+      fStats[fRow + k].Merge(s);
+    }
+  }
+  tree->ResetBranchAddresses();
+  return kTRUE;
+}
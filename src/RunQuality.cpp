@@ -0,0 +1,154 @@
+#include "RunQuality.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <sstream>
+
+namespace {
+  ULong64_t eventKey(Int_t runId, Int_t eventId) {
+    return ((ULong64_t)(UInt_t)runId << 32) | (UInt_t)eventId;
+  }
+}
+
+RunQuality::RunQuality() {
+  Clear();
+}
+
+void RunQuality::Clear() {
+  fActive = kFALSE;
+  fBitIsGood = kFALSE;
+  fDense = kFALSE;
+  fMin = 0;
+  fSpan = 0;
+  fBits.clear();
+  fRuns.clear();
+  fBadEvents.clear();
+}
+
+Bool_t RunQuality::ReadList(const std::string& path, std::vector<Int_t>& runs,
+                            std::vector<ULong64_t>* events) {
+  std::ifstream file(path.c_str());
+  if (!file.is_open()) {
+    std::cerr << "ERROR: [RunQuality] Cannot open run list: " << path << std::endl;
+    return kFALSE;
+  }
+  std::string line;
+  Int_t lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    const size_t commentPos = line.find('#');
+    if (commentPos != std::string::npos) line.erase(commentPos);
+    std::istringstream in(line);
+    Int_t runId = 0, eventId = 0;
+    if (!(in >> runId)) {
+      if (line.find_first_not_of(" \t\r") != std::string::npos) {
+        std::cerr << "ERROR: [RunQuality] " << path << ":" << lineNumber << ": not a run number" << std::endl;
+        return kFALSE;
+      }
+      continue;
+    }
+    if (in >> eventId) {
+      if (!events) {
+        std::cerr << "ERROR: [RunQuality] " << path << ":" << lineNumber
+                  << ": single events can only be listed in the bad-run list" << std::endl;
+        return kFALSE;
+      }
+      events->push_back(eventKey(runId, eventId));
+    } else {
+      runs.push_back(runId);
+    }
+  }
+  return kTRUE;
+}
+
+Bool_t RunQuality::Load(const std::string& goodRunList, const std::string& badRunList) {
+  Clear();
+  if (goodRunList.empty() && badRunList.empty()) return kTRUE;
+
+  std::vector<Int_t> good, bad;
+  if (!goodRunList.empty() && !ReadList(goodRunList, good, 0)) return kFALSE;
+  if (!badRunList.empty() && !ReadList(badRunList, bad, &fBadEvents)) {
+    fBadEvents.clear();
+    return kFALSE;
+  }
+  std::sort(fBadEvents.begin(), fBadEvents.end());
+
+  // Runs whose bit is set: the good runs minus the bad ones, or the bad runs
+  fBitIsGood = !goodRunList.empty();
+  std::sort(bad.begin(), bad.end());
+  if (fBitIsGood) {
+    std::sort(good.begin(), good.end());
+    std::set_difference(good.begin(), good.end(), bad.begin(), bad.end(), std::back_inserter(fRuns));
+  } else {
+    fRuns = bad;
+  }
+  fRuns.erase(std::unique(fRuns.begin(), fRuns.end()), fRuns.end());
+  fActive = kTRUE;
+
+  const Long64_t span = fRuns.empty() ? 0 : (Long64_t)fRuns.back() - fRuns.front() + 1;
+  fDense = span <= kMaxDenseSpan;
+  if (fDense && span > 0) {
+    fMin = fRuns.front();
+    fSpan = (UInt_t)span;
+    fBits.assign((fSpan + 7) / 8, 0);
+    for (size_t i = 0; i < fRuns.size(); i++) {
+      const UInt_t d = (UInt_t)(fRuns[i] - fMin);
+      fBits[d >> 3] |= (UChar_t)(1 << (d & 7));
+    }
+    fRuns.clear();
+  }
+
+  std::cout << "[RunQuality] " << (fBitIsGood ? good.size() : 0) << " good runs, " << bad.size()
+            << " bad runs, " << fBadEvents.size() << " bad events";
+  if (fDense && span > 0) std::cout << " (bitmap over runs " << fMin << "-" << fMin + (Int_t)fSpan - 1 << ")";
+  std::cout << std::endl;
+  return kTRUE;
+}
+
+Bool_t RunQuality::IsListedSparse(Int_t runId) const {
+  return std::binary_search(fRuns.begin(), fRuns.end(), runId);
+}
+
+Bool_t RunQuality::IsBadEvent(Int_t runId, Int_t eventId) const {
+  return std::binary_search(fBadEvents.begin(), fBadEvents.end(), eventKey(runId, eventId));
+}
+
+RunCounts::RunCounts()
+  : fCurrent(0), fRunId(-1), fEventId(-1), fPass(kFALSE) {
+}
+
+void RunCounts::Print(const Char_t* prefix) const {
+  Long64_t nAccepted = 0, nRejected = 0;
+  Int_t nRunsRejected = 0;
+  for (std::map<Int_t, Counts>::const_iterator it = fRuns.begin(); it != fRuns.end(); ++it) {
+    nAccepted += it->second.nAccepted;
+    nRejected += it->second.nRejected;
+    if (it->second.nRejected > 0) nRunsRejected++;
+  }
+  if (nRejected == 0) return;
+  std::cout << prefix << "run quality rejected " << nRejected << " of " << nAccepted + nRejected
+            << " events in " << nRunsRejected << " of " << fRuns.size() << " runs" << std::endl;
+  for (std::map<Int_t, Counts>::const_iterator it = fRuns.begin(); it != fRuns.end(); ++it) {
+    if (it->second.nRejected == 0) continue;
+    std::cout << prefix << "  run " << it->first << ": " << it->second.nRejected << " rejected, "
+              << it->second.nAccepted << " accepted" << std::endl;
+  }
+}
+
+void RunCounts::Save(std::vector<Long64_t>& values) const {
+  values.clear();
+  for (std::map<Int_t, Counts>::const_iterator it = fRuns.begin(); it != fRuns.end(); ++it) {
+    values.push_back(it->first);
+    values.push_back(it->second.nAccepted);
+    values.push_back(it->second.nRejected);
+  }
+}
+
+void RunCounts::Restore(const std::vector<Long64_t>& values) {
+  for (size_t i = 0; i + 2 < values.size(); i += 3) {
+    Counts& c = fRuns[(Int_t)values[i]];
+    c.nAccepted += values[i + 1];
+    c.nRejected += values[i + 2];
+  }
+}
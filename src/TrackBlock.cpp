@@ -0,0 +1,123 @@
+#include "TrackBlock.h"
+#include <TMath.h>
+#include <cmath>
+
+void TrackBlock::Clear() {
+  eventIndex.clear();
+  px.clear(); py.clear(); pz.clear();
+  pT.clear(); eta.clear(); phi.clear();
+  charge.clear();
+  nHitsFit.clear(); nHitsMax.clear(); nHitsDedx.clear();
+  DCA.clear(); chi2.clear();
+  nSigmaPion.clear(); nSigmaKaon.clear(); nSigmaProton.clear();
+  beta.clear(); mass2.clear();
+  tofMatch.clear();
+  originX.clear(); originY.clear(); originZ.clear();
+}
+
+void TrackBlock::Reserve(Int_t n) {
+  eventIndex.reserve(n);
+  px.reserve(n); py.reserve(n); pz.reserve(n);
+  pT.reserve(n); eta.reserve(n); phi.reserve(n);
+  charge.reserve(n);
+  nHitsFit.reserve(n); nHitsMax.reserve(n); nHitsDedx.reserve(n);
+  DCA.reserve(n); chi2.reserve(n);
+  nSigmaPion.reserve(n); nSigmaKaon.reserve(n); nSigmaProton.reserve(n);
+  beta.reserve(n); mass2.reserve(n);
+  tofMatch.reserve(n);
+  originX.reserve(n); originY.reserve(n); originZ.reserve(n);
+}
+
+void TrackBlock::Push(const TrackCandidate& trk) {
+  eventIndex.push_back(trk.eventIndex);
+  px.push_back(trk.pT * TMath::Cos(trk.phi));
+  py.push_back(trk.pT * TMath::Sin(trk.phi));
+  pz.push_back(trk.pT * std::sinh(trk.eta));
+  pT.push_back(trk.pT);
+  eta.push_back(trk.eta);
+  phi.push_back(trk.phi);
+  charge.push_back((Char_t)trk.charge);
+  nHitsFit.push_back((UChar_t)trk.nHitsFit);
+  nHitsMax.push_back((UChar_t)trk.nHitsMax);
+  nHitsDedx.push_back((UChar_t)trk.nHitsDedx);
+  DCA.push_back(trk.DCA);
+  chi2.push_back(trk.chi2);
+  nSigmaPion.push_back(trk.nSigmaPion);
+  nSigmaKaon.push_back(trk.nSigmaKaon);
+  nSigmaProton.push_back(trk.nSigmaProton);
+  beta.push_back(trk.beta);
+  mass2.push_back(trk.mass2);
+  tofMatch.push_back(trk.tofMatch ? 1 : 0);
+  originX.push_back(trk.originX);
+  originY.push_back(trk.originY);
+  originZ.push_back(trk.originZ);
+}
+
+void TrackBlock::PushRow(const TrackBlock& src, Int_t i) {
+  eventIndex.push_back(src.eventIndex[i]);
+  px.push_back(src.px[i]); py.push_back(src.py[i]); pz.push_back(src.pz[i]);
+  pT.push_back(src.pT[i]); eta.push_back(src.eta[i]); phi.push_back(src.phi[i]);
+  charge.push_back(src.charge[i]);
+  nHitsFit.push_back(src.nHitsFit[i]);
+  nHitsMax.push_back(src.nHitsMax[i]);
+  nHitsDedx.push_back(src.nHitsDedx[i]);
+  DCA.push_back(src.DCA[i]);
+  chi2.push_back(src.chi2[i]);
+  nSigmaPion.push_back(src.nSigmaPion[i]);
+  nSigmaKaon.push_back(src.nSigmaKaon[i]);
+  nSigmaProton.push_back(src.nSigmaProton[i]);
+  beta.push_back(src.beta[i]);
+  mass2.push_back(src.mass2[i]);
+  tofMatch.push_back(src.tofMatch[i]);
+  originX.push_back(src.originX[i]);
+  originY.push_back(src.originY[i]);
+  originZ.push_back(src.originZ[i]);
+}
+
+TrackCandidate TrackBlock::Get(Int_t i) const {
+  TrackCandidate trk;
+  trk.eventIndex = eventIndex[i];
+  trk.pT = pT[i];
+  trk.eta = eta[i];
+  trk.phi = phi[i];
+  trk.charge = charge[i];
+  trk.nHitsFit = nHitsFit[i];
+  trk.nHitsMax = nHitsMax[i];
+  trk.nHitsDedx = nHitsDedx[i];
+  trk.DCA = DCA[i];
+  trk.chi2 = chi2[i];
+  trk.nSigmaPion = nSigmaPion[i];
+  trk.nSigmaKaon = nSigmaKaon[i];
+  trk.nSigmaProton = nSigmaProton[i];
+  trk.beta = beta[i];
+  trk.mass2 = mass2[i];
+  trk.tofMatch = tofMatch[i] != 0;
+  trk.originX = originX[i];
+  trk.originY = originY[i];
+  trk.originZ = originZ[i];
+  return trk;
+}
+
+void TrackBlock::PairMasses(const TrackBlock& a, Int_t i, const TrackBlock& b,
+                            const std::vector<Int_t>& idx, Double_t m1, Double_t m2,
+                            std::vector<Double_t>& mass) {
+  const Int_t n = (Int_t)idx.size();
+  mass.resize(n);
+  const Double_t p1x = a.px[i], p1y = a.py[i], p1z = a.pz[i];
+  const Double_t e1 = std::sqrt(m1 * m1 + p1x * p1x + p1y * p1y + p1z * p1z);
+  const Double_t m2sq = m2 * m2;
+  if (n == 0) return;
+  const Float_t* bx = &b.px[0];
+  const Float_t* by = &b.py[0];
+  const Float_t* bz = &b.pz[0];
+  const Int_t* j = &idx[0];
+  Double_t* out = &mass[0];
+  // No branches in the body: gather + sqrt, vectorizable by the compiler
+  for (Int_t k = 0; k < n; k++) {
+    Double_t p2x = bx[j[k]], p2y = by[j[k]], p2z = bz[j[k]];
+    Double_t e = e1 + std::sqrt(m2sq + p2x * p2x + p2y * p2y + p2z * p2z);
+    Double_t sx = p1x + p2x, sy = p1y + p2y, sz = p1z + p2z;
+    Double_t msq = e * e - (sx * sx + sy * sy + sz * sz);
+    out[k] = std::sqrt(msq > 0 ? msq : 0.0);
+  }
+}
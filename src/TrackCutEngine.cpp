@@ -0,0 +1,188 @@
+#include "TrackCutEngine.h"
+#include "CutConfig.h"
+#include <cmath>
+#include <iostream>
+
+TrackCutEngine::TrackCutEngine()
+  : fConfig(&ConfigManager::GetInstance().GetContext()), fAutoLoad(kTRUE),
+    fMinNHitsFit(0), fMinNHitsRatio(0), fMinNHitsDedx(0),
+    fMaxDCA(0), fMaxEta(0), fMinPt(0), fMaxPt(0), fMaxChi2(0),
+    fNSigmaPion(0), fNSigmaKaon(0), fNSigmaProton(0),
+    fMinMass2Pion(0), fMaxMass2Pion(0),
+    fMinMass2Kaon(0), fMaxMass2Kaon(0),
+    fMinMass2Proton(0), fMaxMass2Proton(0) {
+}
+
+namespace {
+  // Float_t bounds for the Double_t cuts: for a Float_t x, x >= roundUp(d) and
+  // x <= roundDown(d) give the same result as comparing x with d itself, as
+  // TreeReader and the makers do
+  Float_t roundUp(Double_t d) {
+    Float_t f = (Float_t)d;
+    if (f < d) f = std::nextafter(f, HUGE_VALF);
+    return f;
+  }
+  Float_t roundDown(Double_t d) {
+    Float_t f = (Float_t)d;
+    if (f > d) f = std::nextafter(f, -HUGE_VALF);
+    return f;
+  }
+}
+
+void TrackCutEngine::LoadCuts() {
+  const auto& trackCuts = fConfig->GetTrackCuts();
+  fMinNHitsFit = roundUp(trackCuts.minNHitsFit);
+  fMinNHitsRatio = roundUp(trackCuts.minNHitsRatio);
+  fMinNHitsDedx = roundUp(trackCuts.minNHitsDedx);
+  fMaxDCA = roundDown(trackCuts.maxDCA);
+  fMaxEta = roundDown(trackCuts.maxEta);
+  fMinPt = roundUp(trackCuts.minPt);
+  fMaxPt = roundDown(trackCuts.maxPt);
+  fMaxChi2 = roundDown(trackCuts.maxChi2);
+
+  const auto& pidCuts = fConfig->GetPIDCuts();
+  fNSigmaPion = roundDown(pidCuts.nSigmaPion);
+  fNSigmaKaon = roundDown(pidCuts.nSigmaKaon);
+  fNSigmaProton = roundDown(pidCuts.nSigmaProton);
+  fMinMass2Pion = roundUp(pidCuts.minMass2Pion);
+  fMaxMass2Pion = roundDown(pidCuts.maxMass2Pion);
+  fMinMass2Kaon = roundUp(pidCuts.minMass2Kaon);
+  fMaxMass2Kaon = roundDown(pidCuts.maxMass2Kaon);
+  fMinMass2Proton = roundUp(pidCuts.minMass2Proton);
+  fMaxMass2Proton = roundDown(pidCuts.maxMass2Proton);
+
+  SetExpression(trackCuts.expression);
+}
+
+void TrackCutEngine::SetExpression(const std::string& expr) {
+  if (expr == fExpressionSource) return;
+  fExpressionSource = expr;
+  if (!fExpression.Compile(expr)) {
+    std::cerr << "WARNING: [TrackCutEngine] track expression ignored: " << fExpression.GetError() << std::endl;
+    return;
+  }
+  // Names are checked once here, against an empty block
+  BindExpression(TrackBlock());
+  if (!fExpression.CheckBindings()) {
+    std::cerr << "WARNING: [TrackCutEngine] track expression ignored: " << fExpression.GetError()
+              << " in \"" << expr << "\"" << std::endl;
+    fExpression.Reset();
+  }
+}
+
+namespace {
+  template <class T>
+  const T* column(const std::vector<T>& v) { return v.empty() ? 0 : &v[0]; }
+}
+
+void TrackCutEngine::BindExpression(const TrackBlock& tracks) {
+  CutExpression& e = fExpression;
+  e.Bind("pT", column(tracks.pT));
+  e.Bind("eta", column(tracks.eta));
+  e.Bind("phi", column(tracks.phi));
+  e.Bind("px", column(tracks.px));
+  e.Bind("py", column(tracks.py));
+  e.Bind("pz", column(tracks.pz));
+  e.Bind("charge", column(tracks.charge));
+  e.Bind("nHitsFit", column(tracks.nHitsFit));
+  e.Bind("nHitsMax", column(tracks.nHitsMax));
+  e.Bind("nHitsDedx", column(tracks.nHitsDedx));
+  e.Bind("dca", column(tracks.DCA));
+  e.Bind("chi2", column(tracks.chi2));
+  e.Bind("nSigmaPion", column(tracks.nSigmaPion));
+  e.Bind("nSigmaKaon", column(tracks.nSigmaKaon));
+  e.Bind("nSigmaProton", column(tracks.nSigmaProton));
+  e.Bind("beta", column(tracks.beta));
+  e.Bind("mass2", column(tracks.mass2));
+  e.Bind("tofMatch", column(tracks.tofMatch));
+}
+
+namespace {
+  // Row loop. 'out' is a parameter marked __restrict__ so gcc knows the byte
+  // stores do not alias the columns (without it the loop is not vectorized).
+  Int_t evaluateRows(Int_t n, const TrackBlock& tracks, const Float_t* cut,
+                     UChar_t* __restrict__ out) {
+    const Float_t minNHitsFit = cut[0], minNHitsRatio = cut[1], minNHitsDedx = cut[2];
+    const Float_t maxDCA = cut[3], maxEta = cut[4], minPt = cut[5], maxPt = cut[6], maxChi2 = cut[7];
+    const Float_t nsPi = cut[8], nsK = cut[9], nsP = cut[10];
+    const Float_t m2PiLo = cut[11], m2PiHi = cut[12];
+    const Float_t m2KLo = cut[13], m2KHi = cut[14];
+    const Float_t m2PLo = cut[15], m2PHi = cut[16];
+
+    const UChar_t* fit = &tracks.nHitsFit[0];
+    const UChar_t* max = &tracks.nHitsMax[0];
+    const UChar_t* dedx = &tracks.nHitsDedx[0];
+    const Float_t* dca = &tracks.DCA[0];
+    const Float_t* eta = &tracks.eta[0];
+    const Float_t* pt = &tracks.pT[0];
+    const Float_t* chi2 = &tracks.chi2[0];
+    const Float_t* nsigPi = &tracks.nSigmaPion[0];
+    const Float_t* nsigK = &tracks.nSigmaKaon[0];
+    const Float_t* nsigP = &tracks.nSigmaProton[0];
+    const Float_t* mass2 = &tracks.mass2[0];
+    const UChar_t* tof = &tracks.tofMatch[0];
+
+    Int_t nPass = 0;
+    for (Int_t i = 0; i < n; i++) {
+      const Float_t nFit = fit[i];
+      // nHitsFit / nHitsMax divided in Float_t as in TreeReader: the product
+      // nHitsFit >= ratio * nHitsMax rounds differently (13 of 25 hits at 0.52)
+      const UChar_t trk = (nFit >= minNHitsFit) &
+                          (nFit / (Float_t)max[i] >= minNHitsRatio) &
+                          ((Float_t)dedx[i] >= minNHitsDedx) &
+                          (dca[i] <= maxDCA) &
+                          (std::fabs(eta[i]) <= maxEta) &
+                          (pt[i] >= minPt) & (pt[i] <= maxPt) &
+                          (chi2[i] <= maxChi2);
+      const UChar_t pi = trk & (std::fabs(nsigPi[i]) <= nsPi);
+      const UChar_t k = trk & (std::fabs(nsigK[i]) <= nsK);
+      const UChar_t p = trk & (std::fabs(nsigP[i]) <= nsP);
+      const UChar_t noTof = (tof[i] == 0);
+      const Float_t m2 = mass2[i];
+      const UChar_t piTof = pi & (noTof | ((m2 >= m2PiLo) & (m2 <= m2PiHi)));
+      const UChar_t kTof = k & (noTof | ((m2 >= m2KLo) & (m2 <= m2KHi)));
+      const UChar_t pTof = p & (noTof | ((m2 >= m2PLo) & (m2 <= m2PHi)));
+      out[i] = (UChar_t)(trk | (pi << 1) | (k << 2) | (p << 3) | (piTof << 4) | (kTof << 5) | (pTof << 6));
+      nPass += trk;
+    }
+    return nPass;
+  }
+}
+
+Int_t TrackCutEngine::Evaluate(const TrackBlock& tracks, std::vector<UChar_t>& mask) {
+  if (fAutoLoad) LoadCuts();
+  const Int_t n = tracks.Size();
+  mask.resize(n);
+  if (n == 0) return 0;
+
+  const Float_t cut[17] = {
+    fMinNHitsFit, fMinNHitsRatio, fMinNHitsDedx,
+    fMaxDCA, fMaxEta, fMinPt, fMaxPt, fMaxChi2,
+    fNSigmaPion, fNSigmaKaon, fNSigmaProton,
+    fMinMass2Pion, fMaxMass2Pion,
+    fMinMass2Kaon, fMaxMass2Kaon,
+    fMinMass2Proton, fMaxMass2Proton
+  };
+  Int_t nPass = evaluateRows(n, tracks, cut, &mask[0]);
+  if (fExpression.IsEmpty()) return nPass;
+
+  // Rows failing the expression lose every bit (all of them imply kTrack)
+  BindExpression(tracks);
+  fExpression.Evaluate(n, fExpressionMask);
+  const UChar_t* pass = &fExpressionMask[0];
+  UChar_t* m = &mask[0];
+  nPass = 0;
+  for (Int_t i = 0; i < n; i++) {
+    m[i] = (UChar_t)(m[i] * pass[i]);
+    nPass += m[i] & kTrack;
+  }
+  return nPass;
+}
+
+void TrackCutEngine::Indices(const std::vector<UChar_t>& mask, UChar_t bits, std::vector<Int_t>& idx) {
+  idx.clear();
+  const Int_t n = (Int_t)mask.size();
+  for (Int_t i = 0; i < n; i++) {
+    if ((mask[i] & bits) == bits) idx.push_back(i);
+  }
+}
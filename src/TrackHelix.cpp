@@ -0,0 +1,209 @@
+#include "TrackHelix.h"
+#include <TMath.h>
+#include <cmath>
+
+namespace {
+  // c [cm / ns] * 1e-9 -> curvature [1/cm] = kC * |q * B[kG]| / pT[GeV/c]
+  const Double_t kC = 2.99792458e-4;
+  const Int_t kMaxIter = 30;
+  const Double_t kTolerance = 1e-6;  // cm
+  const Double_t kMaxStep = 20.0;    // cm, damping for a single Newton step
+
+  Double_t wrapPi(Double_t a) {
+    while (a > TMath::Pi()) a -= 2.0 * TMath::Pi();
+    while (a <= -TMath::Pi()) a += 2.0 * TMath::Pi();
+    return a;
+  }
+
+  Double_t clampStep(Double_t dt) {
+    if (dt > kMaxStep) return kMaxStep;
+    if (dt < -kMaxStep) return -kMaxStep;
+    return dt;
+  }
+
+  Double_t dist2(const TrackHelix& h1, Double_t t1, const TrackHelix& h2, Double_t t2) {
+    Double_t x1, y1, z1, x2, y2, z2;
+    h1.At(t1, x1, y1, z1);
+    h2.At(t2, x2, y2, z2);
+    return (x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2) + (z1 - z2) * (z1 - z2);
+  }
+}
+
+TrackHelix::TrackHelix()
+  : fX0(0), fY0(0), fZ0(0), fPsi0(0), fPt(0), fPz(0), fTanDip(0), fInvCosDip(1),
+    fW(0), fXc(0), fYc(0), fStraight(kTRUE) {
+}
+
+TrackHelix::TrackHelix(Double_t px, Double_t py, Double_t pz,
+                       Double_t ox, Double_t oy, Double_t oz,
+                       Int_t charge, Double_t bFieldKGauss) {
+  Set(px, py, pz, ox, oy, oz, charge, bFieldKGauss);
+}
+
+void TrackHelix::Set(Double_t px, Double_t py, Double_t pz,
+                     Double_t ox, Double_t oy, Double_t oz,
+                     Int_t charge, Double_t bFieldKGauss) {
+  fX0 = ox;
+  fY0 = oy;
+  fZ0 = oz;
+  fPz = pz;
+  fPt = std::sqrt(px * px + py * py);
+  fPsi0 = (fPt > 0) ? std::atan2(py, px) : 0.0;
+  fTanDip = (fPt > 1e-9) ? pz / fPt : 0.0;
+  fInvCosDip = std::sqrt(1.0 + fTanDip * fTanDip);
+
+  Double_t qB = charge * bFieldKGauss;
+  Double_t curvature = (fPt > 1e-9) ? kC * TMath::Abs(qB) / fPt : 0.0;
+  fStraight = (curvature < 1e-12);
+  // Positive charge in +Bz bends clockwise (psi decreases)
+  fW = fStraight ? 0.0 : (qB > 0 ? -curvature : curvature);
+  if (fStraight) {
+    fXc = 0;
+    fYc = 0;
+  } else {
+    fXc = fX0 - std::sin(fPsi0) / fW;
+    fYc = fY0 + std::cos(fPsi0) / fW;
+  }
+}
+
+void TrackHelix::At(Double_t t, Double_t& x, Double_t& y, Double_t& z) const {
+  if (fStraight) {
+    x = fX0 + std::cos(fPsi0) * t;
+    y = fY0 + std::sin(fPsi0) * t;
+  } else {
+    Double_t psi = fPsi0 + fW * t;
+    x = fXc + std::sin(psi) / fW;
+    y = fYc - std::cos(psi) / fW;
+  }
+  z = fZ0 + fTanDip * t;
+}
+
+void TrackHelix::MomentumAt(Double_t t, Double_t& px, Double_t& py, Double_t& pz) const {
+  Double_t psi = fPsi0 + fW * t;
+  px = fPt * std::cos(psi);
+  py = fPt * std::sin(psi);
+  pz = fPz;
+}
+
+void TrackHelix::Derivatives(Double_t t, Double_t* d1, Double_t* d2) const {
+  Double_t psi = fPsi0 + fW * t;
+  Double_t c = std::cos(psi);
+  Double_t s = std::sin(psi);
+  d1[0] = c;
+  d1[1] = s;
+  d1[2] = fTanDip;
+  d2[0] = -fW * s;
+  d2[1] = fW * c;
+  d2[2] = 0.0;
+}
+
+Double_t TrackHelix::CirclePathLength(Double_t x, Double_t y) const {
+  if (fStraight) {
+    return (x - fX0) * std::cos(fPsi0) + (y - fY0) * std::sin(fPsi0);
+  }
+  Double_t psi = std::atan2(fW * (x - fXc), -fW * (y - fYc));
+  return wrapPi(psi - fPsi0) / fW;
+}
+
+Double_t TrackHelix::PathLength(Double_t x, Double_t y, Double_t z) const {
+  Double_t t = CirclePathLength(x, y);
+  Double_t d1[3], d2[3];
+  for (Int_t iter = 0; iter < kMaxIter; iter++) {
+    Double_t px, py, pz;
+    At(t, px, py, pz);
+    Derivatives(t, d1, d2);
+    Double_t dx = px - x, dy = py - y, dz = pz - z;
+    Double_t g = dx * d1[0] + dy * d1[1] + dz * d1[2];
+    Double_t h = d1[0] * d1[0] + d1[1] * d1[1] + d1[2] * d1[2]
+               + dx * d2[0] + dy * d2[1] + dz * d2[2];
+    if (h <= 0) h = d1[0] * d1[0] + d1[1] * d1[1] + d1[2] * d1[2];
+    Double_t dt = clampStep(-g / h);
+    t += dt;
+    if (TMath::Abs(dt) < kTolerance) break;
+  }
+  return t;
+}
+
+Double_t TrackHelix::PathLengths(const TrackHelix& h1, const TrackHelix& h2,
+                                 Double_t& t1, Double_t& t2) {
+  t1 = 0.0;
+  t2 = 0.0;
+
+  // Starting point from the transverse projection: circle intersections, or the
+  // closest points along the line of centres when the circles do not touch.
+  if (!h1.fStraight && !h2.fStraight) {
+    Double_t r1 = 1.0 / TMath::Abs(h1.fW);
+    Double_t r2 = 1.0 / TMath::Abs(h2.fW);
+    Double_t ux = h2.fXc - h1.fXc;
+    Double_t uy = h2.fYc - h1.fYc;
+    Double_t d = std::sqrt(ux * ux + uy * uy);
+    if (d > 1e-9) {
+      ux /= d;
+      uy /= d;
+      if (d < r1 + r2 && d > TMath::Abs(r1 - r2)) {
+        Double_t a = (d * d + r1 * r1 - r2 * r2) / (2.0 * d);
+        Double_t h = std::sqrt(TMath::Max(r1 * r1 - a * a, 0.0));
+        Double_t bx = h1.fXc + a * ux;
+        Double_t by = h1.fYc + a * uy;
+        Double_t best = -1;
+        for (Int_t sign = -1; sign <= 1; sign += 2) {
+          Double_t x = bx - sign * h * uy;
+          Double_t y = by + sign * h * ux;
+          Double_t s1 = h1.CirclePathLength(x, y);
+          Double_t s2 = h2.CirclePathLength(x, y);
+          Double_t d2 = dist2(h1, s1, h2, s2);
+          if (best < 0 || d2 < best) {
+            best = d2;
+            t1 = s1;
+            t2 = s2;
+          }
+        }
+      } else {
+        Double_t s1 = (d >= r1 + r2 || r1 > r2) ? r1 : -r1;
+        Double_t s2 = (d >= r1 + r2) ? -r2 : (r1 > r2 ? r2 : -r2);
+        t1 = h1.CirclePathLength(h1.fXc + s1 * ux, h1.fYc + s1 * uy);
+        t2 = h2.CirclePathLength(h2.fXc + s2 * ux, h2.fYc + s2 * uy);
+      }
+    }
+  } else if (!h2.fStraight || !h1.fStraight) {
+    t1 = h1.CirclePathLength(h2.fX0, h2.fY0);
+    t2 = h2.CirclePathLength(h1.fX0, h1.fY0);
+  }
+
+  // Newton minimisation of |r1(t1) - r2(t2)|^2 in 3D; falls back to the
+  // Gauss-Newton (straight-line) Hessian where the full one is not positive.
+  Double_t a1[3], b1[3], a2[3], b2[3];
+  for (Int_t iter = 0; iter < kMaxIter; iter++) {
+    Double_t x1, y1, z1, x2, y2, z2;
+    h1.At(t1, x1, y1, z1);
+    h2.At(t2, x2, y2, z2);
+    h1.Derivatives(t1, a1, b1);
+    h2.Derivatives(t2, a2, b2);
+    Double_t d[3] = { x1 - x2, y1 - y2, z1 - z2 };
+
+    Double_t g1 = d[0] * a1[0] + d[1] * a1[1] + d[2] * a1[2];
+    Double_t g2 = -(d[0] * a2[0] + d[1] * a2[1] + d[2] * a2[2]);
+    Double_t a11 = a1[0] * a1[0] + a1[1] * a1[1] + a1[2] * a1[2];
+    Double_t a22 = a2[0] * a2[0] + a2[1] * a2[1] + a2[2] * a2[2];
+    Double_t h12 = -(a1[0] * a2[0] + a1[1] * a2[1] + a1[2] * a2[2]);
+    Double_t h11 = a11 + d[0] * b1[0] + d[1] * b1[1] + d[2] * b1[2];
+    Double_t h22 = a22 - (d[0] * b2[0] + d[1] * b2[1] + d[2] * b2[2]);
+    Double_t det = h11 * h22 - h12 * h12;
+    if (h11 <= 0 || det <= 1e-12) {
+      h11 = a11;
+      h22 = a22;
+      det = h11 * h22 - h12 * h12;
+      if (det <= 1e-12) break;  // parallel straight lines
+    }
+
+    Double_t dt1 = clampStep(-(h22 * g1 - h12 * g2) / det);
+    Double_t dt2 = clampStep(-(h11 * g2 - h12 * g1) / det);
+    t1 += dt1;
+    t2 += dt2;
+    if (TMath::Abs(dt1) + TMath::Abs(dt2) < kTolerance) break;
+  }
+
+  Double_t d2 = dist2(h1, t1, h2, t2);
+  if (!(d2 >= 0)) return -1.0;  // NaN guard
+  return std::sqrt(d2);
+}
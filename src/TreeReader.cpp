@@ -1,9 +1,21 @@
 #include "TreeReader.h"
 #include <TMath.h>
 #include <iostream>
+#include <cmath>
 
 TreeReader::TreeReader() 
-  : inputFile(0), eventTree(0), trackTree(0), currentEventIndex(-1) {
+  : fConfig(&ConfigManager::GetInstance().GetContext()),
+    inputFile(0), eventTree(0), trackTree(0),
+    ev_bField(0), tr_originX(0), tr_originY(0), tr_originZ(0), hasHelixInfo(kFALSE),
+    currentEventIndex(-1), fMaskEvent(-1) {
+}
+
+TreeReader::TreeReader(const ConfigContext& config)
+  : fConfig(&config),
+    inputFile(0), eventTree(0), trackTree(0),
+    ev_bField(0), tr_originX(0), tr_originY(0), tr_originZ(0), hasHelixInfo(kFALSE),
+    currentEventIndex(-1), fMaskEvent(-1) {
+  fCutEngine.SetConfigContext(config);
 }
 
 TreeReader::~TreeReader() {
@@ -57,6 +69,22 @@ Bool_t TreeReader::OpenFile(const Char_t *filename) {
   trackTree->SetBranchAddress("beta", &tr_beta);
   trackTree->SetBranchAddress("mass2", &tr_mass2);
   trackTree->SetBranchAddress("tofMatch", &tr_tofMatch);
+
+  // Optional helix information (origin + field) for V0 topology
+  hasHelixInfo = (eventTree->GetBranch("bField") && trackTree->GetBranch("originX") &&
+                  trackTree->GetBranch("originY") && trackTree->GetBranch("originZ"));
+  ev_bField = 0;
+  tr_originX = tr_originY = tr_originZ = 0;
+  if (hasHelixInfo) {
+    eventTree->SetBranchAddress("bField", &ev_bField);
+    trackTree->SetBranchAddress("originX", &tr_originX);
+    trackTree->SetBranchAddress("originY", &tr_originY);
+    trackTree->SetBranchAddress("originZ", &tr_originZ);
+  } else {
+    std::cerr << "WARNING: No bField/origin branches in " << filename
+              << "; V0Reconstructor falls back to the approximate topology from the daughters'"
+              << " DCA to the primary vertex (no decay vertex fit)" << std::endl;
+  }
   
   return kTRUE;
 }
@@ -69,8 +97,9 @@ void TreeReader::CloseFile() {
   }
   eventTree = 0;
   trackTree = 0;
-  currentTracks.clear();
+  currentTracks.Clear();
   currentEventIndex = -1;
+  fMaskEvent = -1;
 }
 
 Bool_t TreeReader::LoadEvent(Long64_t eventIndex) {
@@ -94,16 +123,19 @@ Bool_t TreeReader::LoadEvent(Long64_t eventIndex) {
   currentEvent.psi2 = ev_psi2;
   currentEvent.nTracks = ev_nTracks;
   currentEvent.vzVpd = ev_vzVpd;
+  currentEvent.bField = ev_bField;
+  currentEvent.hasHelix = hasHelixInfo;
   
   // Load tracks for this event
   LoadTracksForEvent(eventIndex);
   
   currentEventIndex = eventIndex;
+  fMaskEvent = -1;  // species bits are evaluated on first use
   return kTRUE;
 }
 
 void TreeReader::LoadTracksForEvent(Long64_t eventIndex) {
-  currentTracks.clear();
+  currentTracks.Clear();
   
   if (!trackTree) return;
   
@@ -128,14 +160,17 @@ void TreeReader::LoadTracksForEvent(Long64_t eventIndex) {
       trk.beta = tr_beta;
       trk.mass2 = tr_mass2;
       trk.tofMatch = tr_tofMatch;
+      trk.originX = tr_originX;
+      trk.originY = tr_originY;
+      trk.originZ = tr_originZ;
       
-      currentTracks.push_back(trk);
+      currentTracks.Push(trk);
     }
   }
 }
 
 Bool_t TreeReader::PassEventCuts(const EventCandidate& evt) const {
-  const auto& eventCuts = CutConfig::Event::Get();
+  const auto& eventCuts = fConfig->GetEventCuts();
   if (TMath::Abs(evt.Vz) > eventCuts.maxVz) return kFALSE;
   if (evt.Vr > eventCuts.maxVr) return kFALSE;
   if (evt.refMult < eventCuts.minRefMult) return kFALSE;
@@ -145,114 +180,109 @@ Bool_t TreeReader::PassEventCuts(const EventCandidate& evt) const {
   return kTRUE;
 }
 
-Bool_t TreeReader::PassTrackCuts(const TrackCandidate& trk) const {
-  const auto& trackCuts = CutConfig::Track::Get();
-  if (trk.nHitsFit < trackCuts.minNHitsFit) return kFALSE;
-  if ((Float_t)trk.nHitsFit / (Float_t)trk.nHitsMax < trackCuts.minNHitsRatio) return kFALSE;
-  if (trk.nHitsDedx < trackCuts.minNHitsDedx) return kFALSE;
-  if (trk.DCA > trackCuts.maxDCA) return kFALSE;
-  if (TMath::Abs(trk.eta) > trackCuts.maxEta) return kFALSE;
-  if (trk.pT < trackCuts.minPt) return kFALSE;
-  if (trk.pT > trackCuts.maxPt) return kFALSE;
-  if (trk.chi2 > trackCuts.maxChi2) return kFALSE;
+Bool_t TreeReader::PassTrackCuts(const TrackBlock& tracks, Int_t i) const {
+  const auto& trackCuts = fConfig->GetTrackCuts();
+  if (tracks.nHitsFit[i] < trackCuts.minNHitsFit) return kFALSE;
+  if ((Float_t)tracks.nHitsFit[i] / (Float_t)tracks.nHitsMax[i] < trackCuts.minNHitsRatio) return kFALSE;
+  if (tracks.nHitsDedx[i] < trackCuts.minNHitsDedx) return kFALSE;
+  if (tracks.DCA[i] > trackCuts.maxDCA) return kFALSE;
+  if (TMath::Abs(tracks.eta[i]) > trackCuts.maxEta) return kFALSE;
+  if (tracks.pT[i] < trackCuts.minPt) return kFALSE;
+  if (tracks.pT[i] > trackCuts.maxPt) return kFALSE;
+  if (tracks.chi2[i] > trackCuts.maxChi2) return kFALSE;
   return kTRUE;
 }
 
-Bool_t TreeReader::IsPion(const TrackCandidate& trk, Bool_t useTOF) const {
-  if (!PassTrackCuts(trk)) return kFALSE;
-  const auto& pidCuts = CutConfig::PID::Get();
-  if (TMath::Abs(trk.nSigmaPion) > pidCuts.nSigmaPion) return kFALSE;
+const std::vector<UChar_t>& TreeReader::GetSpeciesMask() const {
+  if (fMaskEvent != currentEventIndex) {
+    fCutEngine.Evaluate(currentTracks, fMask);
+    fMaskEvent = currentEventIndex;
+  }
+  return fMask;
+}
+
+Bool_t TreeReader::IsPion(const TrackBlock& tracks, Int_t i, Bool_t useTOF) const {
+  if (!PassTrackCuts(tracks, i)) return kFALSE;
+  const auto& pidCuts = fConfig->GetPIDCuts();
+  if (TMath::Abs(tracks.nSigmaPion[i]) > pidCuts.nSigmaPion) return kFALSE;
   
-  if (useTOF && trk.tofMatch) {
-    if (trk.mass2 < pidCuts.minMass2Pion || 
-        trk.mass2 > pidCuts.maxMass2Pion) return kFALSE;
+  if (useTOF && tracks.tofMatch[i]) {
+    if (tracks.mass2[i] < pidCuts.minMass2Pion || 
+        tracks.mass2[i] > pidCuts.maxMass2Pion) return kFALSE;
   }
   
   return kTRUE;
 }
 
-Bool_t TreeReader::IsKaon(const TrackCandidate& trk, Bool_t useTOF) const {
-  if (!PassTrackCuts(trk)) return kFALSE;
-  const auto& pidCuts = CutConfig::PID::Get();
-  if (TMath::Abs(trk.nSigmaKaon) > pidCuts.nSigmaKaon) return kFALSE;
+Bool_t TreeReader::IsKaon(const TrackBlock& tracks, Int_t i, Bool_t useTOF) const {
+  if (!PassTrackCuts(tracks, i)) return kFALSE;
+  const auto& pidCuts = fConfig->GetPIDCuts();
+  if (TMath::Abs(tracks.nSigmaKaon[i]) > pidCuts.nSigmaKaon) return kFALSE;
   
-  if (useTOF && trk.tofMatch) {
-    if (trk.mass2 < pidCuts.minMass2Kaon || 
-        trk.mass2 > pidCuts.maxMass2Kaon) return kFALSE;
+  if (useTOF && tracks.tofMatch[i]) {
+    if (tracks.mass2[i] < pidCuts.minMass2Kaon || 
+        tracks.mass2[i] > pidCuts.maxMass2Kaon) return kFALSE;
   }
   
   return kTRUE;
 }
 
-Bool_t TreeReader::IsProton(const TrackCandidate& trk, Bool_t useTOF) const {
-  if (!PassTrackCuts(trk)) return kFALSE;
-  const auto& pidCuts = CutConfig::PID::Get();
-  if (TMath::Abs(trk.nSigmaProton) > pidCuts.nSigmaProton) return kFALSE;
+Bool_t TreeReader::IsProton(const TrackBlock& tracks, Int_t i, Bool_t useTOF) const {
+  if (!PassTrackCuts(tracks, i)) return kFALSE;
+  const auto& pidCuts = fConfig->GetPIDCuts();
+  if (TMath::Abs(tracks.nSigmaProton[i]) > pidCuts.nSigmaProton) return kFALSE;
   
-  if (useTOF && trk.tofMatch) {
-    if (trk.mass2 < pidCuts.minMass2Proton || 
-        trk.mass2 > pidCuts.maxMass2Proton) return kFALSE;
+  if (useTOF && tracks.tofMatch[i]) {
+    if (tracks.mass2[i] < pidCuts.minMass2Proton || 
+        tracks.mass2[i] > pidCuts.maxMass2Proton) return kFALSE;
   }
   
   return kTRUE;
 }
 
-std::vector<TrackCandidate> TreeReader::GetPionCandidates(Bool_t useTOF) const {
-  std::vector<TrackCandidate> candidates;
-  for (const auto& trk : currentTracks) {
-    if (IsPion(trk, useTOF)) {
-      candidates.push_back(trk);
-    }
-  }
-  return candidates;
+void TreeReader::GetPionCandidates(TrackBlock& out, Bool_t useTOF) const {
+  GetPionIndices(fIdx, useTOF);
+  out.Clear();
+  for (size_t k = 0; k < fIdx.size(); k++) out.PushRow(currentTracks, fIdx[k]);
 }
 
-std::vector<TrackCandidate> TreeReader::GetKaonCandidates(Bool_t useTOF) const {
-  std::vector<TrackCandidate> candidates;
-  for (const auto& trk : currentTracks) {
-    if (IsKaon(trk, useTOF)) {
-      candidates.push_back(trk);
-    }
-  }
-  return candidates;
+void TreeReader::GetKaonCandidates(TrackBlock& out, Bool_t useTOF) const {
+  GetKaonIndices(fIdx, useTOF);
+  out.Clear();
+  for (size_t k = 0; k < fIdx.size(); k++) out.PushRow(currentTracks, fIdx[k]);
 }
 
-std::vector<TrackCandidate> TreeReader::GetProtonCandidates(Bool_t useTOF) const {
-  std::vector<TrackCandidate> candidates;
-  for (const auto& trk : currentTracks) {
-    if (IsProton(trk, useTOF)) {
-      candidates.push_back(trk);
-    }
-  }
-  return candidates;
+void TreeReader::GetProtonCandidates(TrackBlock& out, Bool_t useTOF) const {
+  GetProtonIndices(fIdx, useTOF);
+  out.Clear();
+  for (size_t k = 0; k < fIdx.size(); k++) out.PushRow(currentTracks, fIdx[k]);
 }
 
-Double_t TreeReader::CalculateInvariantMass(const TrackCandidate& trk1,
-                                            const TrackCandidate& trk2,
-                                            Double_t mass1, Double_t mass2) {
-  TVector3 p1 = trk1.GetMomentum();
-  TVector3 p2 = trk2.GetMomentum();
-  
-  Double_t E1 = TMath::Sqrt(mass1*mass1 + p1.Mag2());
-  Double_t E2 = TMath::Sqrt(mass2*mass2 + p2.Mag2());
-  
-  Double_t E = E1 + E2;
-  TVector3 p = p1 + p2;
-  
-  return TMath::Sqrt(E*E - p.Mag2());
+void TreeReader::GetPionIndices(std::vector<Int_t>& idx, Bool_t useTOF) const {
+  TrackCutEngine::Indices(GetSpeciesMask(), TrackCutEngine::PionBit(useTOF), idx);
 }
 
-Double_t TreeReader::CalculateInvariantMassMassless(const TrackCandidate& trk1,
-                                                     const TrackCandidate& trk2) {
-  TVector3 p1 = trk1.GetMomentum();
-  TVector3 p2 = trk2.GetMomentum();
-  
-  TVector3 p = p1 + p2;
-  Double_t p1Mag = p1.Mag();
-  Double_t p2Mag = p2.Mag();
-  
-  // For massless particles: m^2 = 2*p1*p2*(1 - cos(theta))
-  Double_t cosTheta = (p1 * p2) / (p1Mag * p2Mag);
-  return TMath::Sqrt(2.0 * p1Mag * p2Mag * (1.0 - cosTheta));
+void TreeReader::GetKaonIndices(std::vector<Int_t>& idx, Bool_t useTOF) const {
+  TrackCutEngine::Indices(GetSpeciesMask(), TrackCutEngine::KaonBit(useTOF), idx);
 }
 
+void TreeReader::GetProtonIndices(std::vector<Int_t>& idx, Bool_t useTOF) const {
+  TrackCutEngine::Indices(GetSpeciesMask(), TrackCutEngine::ProtonBit(useTOF), idx);
+}
+
+Double_t TreeReader::CalculateInvariantMass(const TrackBlock& b1, Int_t i1,
+                                            const TrackBlock& b2, Int_t i2,
+                                            Double_t mass1, Double_t mass2) {
+  return TrackBlock::PairMass(b1, i1, b2, i2, mass1, mass2);
+}
+
+Double_t TreeReader::CalculateInvariantMassMassless(const TrackBlock& b1, Int_t i1,
+                                                     const TrackBlock& b2, Int_t i2) {
+  // For massless particles: m^2 = 2*(|p1||p2| - p1.p2)
+  Double_t p1x = b1.px[i1], p1y = b1.py[i1], p1z = b1.pz[i1];
+  Double_t p2x = b2.px[i2], p2y = b2.py[i2], p2z = b2.pz[i2];
+  Double_t p1Mag = TMath::Sqrt(p1x * p1x + p1y * p1y + p1z * p1z);
+  Double_t p2Mag = TMath::Sqrt(p2x * p2x + p2y * p2y + p2z * p2z);
+  Double_t m2 = 2.0 * (p1Mag * p2Mag - (p1x * p2x + p1y * p2y + p1z * p2z));
+  return (m2 > 0) ? TMath::Sqrt(m2) : 0.0;
+}
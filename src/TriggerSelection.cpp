@@ -0,0 +1,75 @@
+#include "TriggerSelection.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+TriggerSelection::TriggerSelection()
+  : fN(0) {
+}
+
+Bool_t TriggerSelection::Parse(const std::string& list) {
+  fN = 0;
+  const char* p = list.c_str();
+  while (*p) {
+    if (std::strchr(" \t,[]\"'", *p)) {
+      p++;
+      continue;
+    }
+    char* end = 0;
+    const unsigned long id = std::strtoul(p, &end, 10);
+    if (end == p) {
+      std::cerr << "ERROR: [TriggerSelection] Bad trigger ID list: " << list << std::endl;
+      fN = 0;
+      return kFALSE;
+    }
+    p = end;
+    if (std::find(fIds, fIds + fN, (UInt_t)id) != fIds + fN) continue;
+    if (fN == kMaxIds) {
+      std::cerr << "ERROR: [TriggerSelection] More than " << kMaxIds << " trigger IDs: " << list << std::endl;
+      fN = 0;
+      return kFALSE;
+    }
+    fIds[fN++] = (UInt_t)id;
+  }
+  std::sort(fIds, fIds + fN);
+  return kTRUE;
+}
+
+Int_t TriggerSelection::Find(UInt_t id) const {
+  const UInt_t* it = std::lower_bound(fIds, fIds + fN, id);
+  return (it != fIds + fN && *it == id) ? (Int_t)(it - fIds) : -1;
+}
+
+ULong64_t TriggerSelection::Match(const UInt_t* ids, Int_t n) const {
+  ULong64_t mask = 0;
+  for (Int_t i = 0; i < n; i++) {
+    const Int_t k = Find(ids[i]);
+    if (k >= 0) mask |= (ULong64_t)1 << k;
+  }
+  return mask;
+}
+
+TriggerCounts::TriggerCounts()
+  : fRunId(-1), fEventId(-1), fFired(0), fPass(kFALSE), fNRejected(0) {
+  for (Int_t k = 0; k < TriggerSelection::kMaxIds; k++) fCounts[k] = 0;
+}
+
+void TriggerCounts::Print(const TriggerSelection& sel, const Char_t* prefix) const {
+  if (!sel.IsActive()) return;
+  for (Int_t k = 0; k < sel.GetN(); k++) {
+    std::cout << prefix << "trigger " << sel.GetId(k) << ": " << fCounts[k] << " events" << std::endl;
+  }
+  std::cout << prefix << "rejected by the trigger selection: " << fNRejected << " events" << std::endl;
+}
+
+void TriggerCounts::Save(std::vector<Long64_t>& values) const {
+  values.assign(1, fNRejected);
+  values.insert(values.end(), fCounts, fCounts + TriggerSelection::kMaxIds);
+}
+
+void TriggerCounts::Restore(const std::vector<Long64_t>& values) {
+  if (values.empty()) return;
+  fNRejected += values[0];
+  for (size_t k = 1; k < values.size() && k <= (size_t)TriggerSelection::kMaxIds; k++) fCounts[k - 1] += values[k];
+}
@@ -1,158 +1,239 @@
 #include "V0Reconstructor.h"
 #include <TMath.h>
+#include <cmath>
 
-V0Reconstructor::V0Reconstructor() {
+namespace {
+  Bool_t passV0Cuts(const V0CutConfig& v0Cuts, Double_t daughterDCA, Double_t decayLength,
+                    Double_t pointingAngle, Double_t dcaToPV, Double_t mass) {
+    if (daughterDCA < v0Cuts.minDaughterDCA) return kFALSE;
+    if (daughterDCA > v0Cuts.maxDaughterDCA) return kFALSE;
+    if (decayLength < v0Cuts.minDecayLength) return kFALSE;
+    if (decayLength > v0Cuts.maxDecayLength) return kFALSE;
+    if (pointingAngle < v0Cuts.minPointingAngle) return kFALSE;
+    if (pointingAngle > v0Cuts.maxPointingAngle) return kFALSE;
+    if (dcaToPV > v0Cuts.maxDCAtoPV) return kFALSE;
+
+    // Mass window cut
+    if (TMath::Abs(mass - v0Cuts.lambdaMass) > v0Cuts.lambdaMassWindow) {
+      return kFALSE;
+    }
+
+    return kTRUE;
+  }
 }
 
-V0Reconstructor::~V0Reconstructor() {
+V0Reconstructor::V0Reconstructor()
+  : fConfig(&ConfigManager::GetInstance().GetContext()) {
 }
 
-std::vector<V0Candidate> V0Reconstructor::ReconstructLambda(
-    const std::vector<TrackCandidate>& protons,
-    const std::vector<TrackCandidate>& pions,
-    const EventCandidate& event,
-    Bool_t useTOF) const {
-  
-  std::vector<V0Candidate> candidates;
-  
-  // Loop over all p-π⁻ combinations
-  for (const auto& p : protons) {
-    // Lambda: p + π⁻, so proton should be positive charge
-    if (p.charge <= 0) continue;
-    
-    for (const auto& pi : pions) {
-      // Pion should be negative charge for Lambda
-      if (pi.charge >= 0) continue;
-      
-      // Calculate invariant mass assuming p + π⁻ → Λ
-      Double_t invMass = TreeReader::CalculateInvariantMass(p, pi, kProtonMass, kPionMass);
-      
-      // Create V0 candidate
-      V0Candidate v0;
-      v0.proton = p;
-      v0.pion = pi;
-      v0.mass = invMass;
-      v0.eventIndex = p.eventIndex;
-      
-      // Calculate momentum
-      TVector3 pMom = p.GetMomentum();
-      TVector3 piMom = pi.GetMomentum();
-      v0.momentum = pMom + piMom;
-      v0.pt = v0.momentum.Perp();
-      v0.eta = v0.momentum.PseudoRapidity();
-      v0.phi = v0.momentum.Phi();
-      
-      // Calculate topology variables
-      CalculateTopology(v0, event);
-      
-      candidates.push_back(v0);
-    }
-  }
-  
-  return candidates;
+V0Reconstructor::V0Reconstructor(const ConfigContext& config)
+  : fConfig(&config) {
 }
 
-void V0Reconstructor::CalculateTopology(V0Candidate& v0, const EventCandidate& event) const {
-  // Calculate DCA between daughters
-  v0.daughterDCA = CalculateDCA(v0.proton, v0.pion);
-  
-  // Calculate decay length (simplified)
-  v0.decayLength = CalculateDecayLength(v0, event);
-  
-  // Calculate pointing angle
-  v0.pointingAngle = CalculatePointingAngle(v0, event);
-  
-  // Calculate DCA to PV
-  v0.dcaToPV = CalculateDCAToPV(v0, event);
+V0Reconstructor::~V0Reconstructor() {
 }
 
-Double_t V0Reconstructor::CalculateDCA(const TrackCandidate& trk1, const TrackCandidate& trk2) const {
-  // Simplified DCA calculation
-  // In reality, this requires track helix parameters and proper calculation
-  // For now, use a simplified approximation based on track positions
-  
-  TVector3 p1 = trk1.GetMomentum();
-  TVector3 p2 = trk2.GetMomentum();
-  
-  // Approximate DCA as distance between track positions at their DCA points
-  // This is a simplified version - full implementation requires helix calculations
-  Double_t dca = TMath::Sqrt(trk1.DCA * trk1.DCA + trk2.DCA * trk2.DCA);
-  
-  return dca;
+TrackHelix V0Reconstructor::MakeHelix(const TrackBlock& tracks, Int_t i, Double_t bField) {
+  return TrackHelix(tracks.px[i], tracks.py[i], tracks.pz[i],
+                    tracks.originX[i], tracks.originY[i], tracks.originZ[i],
+                    tracks.charge[i], bField);
 }
 
-Double_t V0Reconstructor::CalculateDecayLength(const V0Candidate& v0, const EventCandidate& event) const {
-  // Simplified decay length calculation
-  // In reality, this requires the V0 decay vertex position
-  // For now, use an approximation based on track DCAs
-  
-  // Approximate decay length as average of daughter DCAs
-  Double_t decayLength = (v0.proton.DCA + v0.pion.DCA) / 2.0;
-  
-  // Apply a scaling factor (this is a rough approximation)
-  decayLength *= 2.0;
-  
-  return decayLength;
+Bool_t V0Reconstructor::SolveTopology(const TrackHelix& hPos, const TrackHelix& hNeg,
+                                      Double_t massPos, Double_t massNeg,
+                                      const EventCandidate& event, V0Topology& topo) {
+  Double_t tPos, tNeg;
+  Double_t dca = TrackHelix::PathLengths(hPos, hNeg, tPos, tNeg);
+  if (dca < 0) return kFALSE;
+
+  Double_t x1, y1, z1, x2, y2, z2;
+  hPos.At(tPos, x1, y1, z1);
+  hNeg.At(tNeg, x2, y2, z2);
+  topo.decayX = 0.5 * (x1 + x2);
+  topo.decayY = 0.5 * (y1 + y2);
+  topo.decayZ = 0.5 * (z1 + z2);
+  topo.daughterDCA = dca;
+
+  Double_t p1x, p1y, p1z, p2x, p2y, p2z;
+  hPos.MomentumAt(tPos, p1x, p1y, p1z);
+  hNeg.MomentumAt(tNeg, p2x, p2y, p2z);
+  topo.px = p1x + p2x;
+  topo.py = p1y + p2y;
+  topo.pz = p1z + p2z;
+
+  Double_t e1 = TMath::Sqrt(massPos * massPos + p1x * p1x + p1y * p1y + p1z * p1z);
+  Double_t e2 = TMath::Sqrt(massNeg * massNeg + p2x * p2x + p2y * p2y + p2z * p2z);
+  Double_t p2 = topo.px * topo.px + topo.py * topo.py + topo.pz * topo.pz;
+  Double_t m2 = (e1 + e2) * (e1 + e2) - p2;
+  topo.mass = (m2 > 0) ? TMath::Sqrt(m2) : 0.0;
+
+  // Flight vector from the primary vertex to the decay vertex
+  Double_t fx = topo.decayX - event.Vx;
+  Double_t fy = topo.decayY - event.Vy;
+  Double_t fz = topo.decayZ - event.Vz;
+  topo.decayLength = TMath::Sqrt(fx * fx + fy * fy + fz * fz);
+
+  Double_t pMag = TMath::Sqrt(p2);
+  if (pMag < 1e-9 || topo.decayLength < 1e-9) {
+    topo.pointingAngle = TMath::Pi();
+    topo.dcaToPV = topo.decayLength;
+    return kTRUE;
+  }
+
+  Double_t cosAngle = (fx * topo.px + fy * topo.py + fz * topo.pz) / (topo.decayLength * pMag);
+  if (cosAngle > 1.0) cosAngle = 1.0;
+  if (cosAngle < -1.0) cosAngle = -1.0;
+  topo.pointingAngle = TMath::ACos(cosAngle);
+
+  // DCA of the straight V0 line to the primary vertex: |flight x p| / |p|
+  Double_t cx = fy * topo.pz - fz * topo.py;
+  Double_t cy = fz * topo.px - fx * topo.pz;
+  Double_t cz = fx * topo.py - fy * topo.px;
+  topo.dcaToPV = TMath::Sqrt(cx * cx + cy * cy + cz * cz) / pMag;
+
+  return kTRUE;
 }
 
-Double_t V0Reconstructor::CalculatePointingAngle(const V0Candidate& v0, const EventCandidate& event) const {
-  // Pointing angle: angle between V0 momentum and vector from PV to V0 decay point
-  // Simplified calculation
-  
-  TVector3 pVtx(event.Vx, event.Vy, event.Vz);
-  TVector3 v0Pos = pVtx;  // Simplified: assume decay point is at PV + some offset
-  
-  // Calculate vector from PV to V0 (simplified)
-  TVector3 toV0 = v0.momentum.Unit() * v0.decayLength;
-  
-  // Pointing angle (cosine of angle between momentum and PV-V0 vector)
-  Double_t cosAngle = v0.momentum.Unit() * toV0.Unit();
-  
-  // Return the angle in radians
-  return TMath::ACos(TMath::Abs(cosAngle));
+void V0Reconstructor::ApproximateTopology(const TrackBlock& tracks, Int_t iPos, Int_t iNeg,
+                                          Double_t massPos, Double_t massNeg,
+                                          const EventCandidate& event, V0Topology& topo) {
+  topo.px = tracks.px[iPos] + tracks.px[iNeg];
+  topo.py = tracks.py[iPos] + tracks.py[iNeg];
+  topo.pz = tracks.pz[iPos] + tracks.pz[iNeg];
+  topo.mass = TrackBlock::PairMass(tracks, iPos, tracks, iNeg, massPos, massNeg);
+
+  const Double_t dcaPos = tracks.DCA[iPos], dcaNeg = tracks.DCA[iNeg];
+  topo.daughterDCA = TMath::Sqrt(dcaPos * dcaPos + dcaNeg * dcaNeg);
+  topo.decayLength = dcaPos + dcaNeg;
+  topo.dcaToPV = 0.5 * (dcaPos + dcaNeg);
+  topo.pointingAngle = 0;
+
+  const Double_t pMag = TMath::Sqrt(topo.px * topo.px + topo.py * topo.py + topo.pz * topo.pz);
+  const Double_t scale = (pMag > 1e-9) ? topo.decayLength / pMag : 0.0;
+  topo.decayX = event.Vx + scale * topo.px;
+  topo.decayY = event.Vy + scale * topo.py;
+  topo.decayZ = event.Vz + scale * topo.pz;
 }
 
-Double_t V0Reconstructor::CalculateDCAToPV(const V0Candidate& v0, const EventCandidate& event) const {
-  // DCA of V0 to primary vertex
-  // Simplified: use average of daughter DCAs
-  return (v0.proton.DCA + v0.pion.DCA) / 2.0;
+void V0Reconstructor::BuildHelices(const TrackBlock& tracks,
+                                   const std::vector<Int_t>& protonIdx,
+                                   const std::vector<Int_t>& pionIdx,
+                                   Double_t bField) const {
+  // One helix per daughter candidate, built once per event
+  fProtonHelices.resize(protonIdx.size());
+  for (size_t i = 0; i < protonIdx.size(); i++) {
+    fProtonHelices[i] = MakeHelix(tracks, protonIdx[i], bField);
+  }
+  fPionHelices.resize(pionIdx.size());
+  for (size_t i = 0; i < pionIdx.size(); i++) {
+    fPionHelices[i] = MakeHelix(tracks, pionIdx[i], bField);
+  }
 }
 
-Bool_t V0Reconstructor::PassTopologyCuts(const V0Candidate& v0) const {
-  // Apply topology cuts
-  const auto& v0Cuts = CutConfig::V0::Get();
-  if (v0.daughterDCA < v0Cuts.minDaughterDCA) return kFALSE;
-  if (v0.daughterDCA > v0Cuts.maxDaughterDCA) return kFALSE;
-  if (v0.decayLength < v0Cuts.minDecayLength) return kFALSE;
-  if (v0.decayLength > v0Cuts.maxDecayLength) return kFALSE;
-  if (v0.pointingAngle > v0Cuts.maxPointingAngle) return kFALSE;
-  if (v0.dcaToPV > v0Cuts.maxDCAtoPV) return kFALSE;
-  
-  // Mass window cut
-  if (TMath::Abs(v0.mass - v0Cuts.lambdaMass) > v0Cuts.lambdaMassWindow) {
-    return kFALSE;
+Int_t V0Reconstructor::FindLambdas(const TrackBlock& tracks,
+                                   const std::vector<Int_t>& protonIdx,
+                                   const std::vector<Int_t>& pionIdx,
+                                   const EventCandidate& event,
+                                   V0Candidates& out) const {
+  out.Clear();
+  GetLambdaCandidates(tracks, protonIdx, pionIdx, event, fCandidates);
+  out.Reserve((Int_t)fCandidates.size());
+  for (size_t i = 0; i < fCandidates.size(); i++) {
+    out.Push(fCandidates[i]);
   }
-  
-  return kTRUE;
+  return out.Size();
 }
 
-std::vector<V0Candidate> V0Reconstructor::GetLambdaCandidates(
-    const std::vector<TrackCandidate>& protons,
-    const std::vector<TrackCandidate>& pions,
-    const EventCandidate& event,
-    Bool_t useTOF) const {
-  
-  // Reconstruct all Lambda candidates
-  std::vector<V0Candidate> allCandidates = ReconstructLambda(protons, pions, event, useTOF);
-  
-  // Apply topology cuts
-  std::vector<V0Candidate> selectedCandidates;
-  for (const auto& v0 : allCandidates) {
-    if (PassTopologyCuts(v0)) {
-      selectedCandidates.push_back(v0);
+Int_t V0Reconstructor::GetLambdaCandidates(const TrackBlock& tracks,
+                                           const std::vector<Int_t>& protonIdx,
+                                           const std::vector<Int_t>& pionIdx,
+                                           const EventCandidate& event,
+                                           std::vector<V0Candidate>& out) const {
+  out.clear();
+  if (event.hasHelix) BuildHelices(tracks, protonIdx, pionIdx, event.bField);
+
+  V0Topology topo;
+  for (size_t ip = 0; ip < protonIdx.size(); ip++) {
+    // Lambda: p + π⁻, so proton should be positive charge
+    if (tracks.charge[protonIdx[ip]] <= 0) continue;
+
+    for (size_t ii = 0; ii < pionIdx.size(); ii++) {
+      if (pionIdx[ii] == protonIdx[ip]) continue;
+      // Pion should be negative charge for Lambda
+      if (tracks.charge[pionIdx[ii]] >= 0) continue;
+
+      // Cuts on the solved topology; only survivors become candidates
+      if (!event.hasHelix) {
+        ApproximateTopology(tracks, protonIdx[ip], pionIdx[ii], kProtonMass, kPionMass, event, topo);
+      } else if (!SolveTopology(fProtonHelices[ip], fPionHelices[ii], kProtonMass, kPionMass, event, topo)) {
+        continue;
+      }
+      if (!PassTopologyCuts(topo)) continue;
+
+      out.resize(out.size() + 1);
+      FillCandidate(out.back(), protonIdx[ip], pionIdx[ii], topo, tracks.eventIndex[protonIdx[ip]]);
     }
   }
-  
-  return selectedCandidates;
+
+  return (Int_t)out.size();
+}
+
+void V0Reconstructor::FillCandidate(V0Candidate& v0, Int_t iProton, Int_t iPion,
+                                    const V0Topology& topo, Int_t eventIndex) {
+  v0.protonIndex = iProton;
+  v0.pionIndex = iPion;
+  v0.eventIndex = eventIndex;
+  v0.px = topo.px;
+  v0.py = topo.py;
+  v0.pz = topo.pz;
+  v0.mass = topo.mass;
+  v0.pt = TMath::Sqrt(topo.px * topo.px + topo.py * topo.py);
+  v0.eta = (v0.pt > 0) ? TMath::ASinH(topo.pz / v0.pt) : 0.0;
+  v0.phi = TMath::ATan2(topo.py, topo.px);
+  v0.decayX = topo.decayX;
+  v0.decayY = topo.decayY;
+  v0.decayZ = topo.decayZ;
+  v0.daughterDCA = topo.daughterDCA;
+  v0.decayLength = topo.decayLength;
+  v0.pointingAngle = topo.pointingAngle;
+  v0.dcaToPV = topo.dcaToPV;
+}
+
+Bool_t V0Reconstructor::CalculateTopology(V0Candidate& v0, const TrackBlock& tracks,
+                                          const EventCandidate& event) const {
+  const Int_t ip = v0.protonIndex;
+  const Int_t ii = v0.pionIndex;
+  const Int_t eventIndex = tracks.eventIndex[ip];
+  V0Topology topo;
+  if (!event.hasHelix) {
+    ApproximateTopology(tracks, ip, ii, kProtonMass, kPionMass, event, topo);
+    FillCandidate(v0, ip, ii, topo, eventIndex);
+    return kTRUE;
+  }
+  if (SolveTopology(MakeHelix(tracks, ip, event.bField), MakeHelix(tracks, ii, event.bField),
+                    kProtonMass, kPionMass, event, topo)) {
+    FillCandidate(v0, ip, ii, topo, eventIndex);
+    return kTRUE;
+  }
+
+  // No DCA solution: momentum/mass at the reference points, topology failing every cut
+  topo.px = tracks.px[ip] + tracks.px[ii];
+  topo.py = tracks.py[ip] + tracks.py[ii];
+  topo.pz = tracks.pz[ip] + tracks.pz[ii];
+  topo.mass = TrackBlock::PairMass(tracks, ip, tracks, ii, kProtonMass, kPionMass);
+  topo.decayX = topo.decayY = topo.decayZ = 0;
+  topo.daughterDCA = 1e9;
+  topo.decayLength = -1.0;
+  topo.pointingAngle = TMath::Pi();
+  topo.dcaToPV = 1e9;
+  FillCandidate(v0, ip, ii, topo, eventIndex);
+  return kFALSE;
 }
 
+Bool_t V0Reconstructor::PassTopologyCuts(const V0Candidate& v0) const {
+  return passV0Cuts(fConfig->GetV0Cuts(), v0.daughterDCA, v0.decayLength, v0.pointingAngle, v0.dcaToPV, v0.mass);
+}
+
+Bool_t V0Reconstructor::PassTopologyCuts(const V0Topology& topo) const {
+  return passV0Cuts(fConfig->GetV0Cuts(), topo.daughterDCA, topo.decayLength, topo.pointingAngle, topo.dcaToPV, topo.mass);
+}
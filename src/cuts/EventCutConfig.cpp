@@ -1,12 +1,13 @@
 #include "cuts/EventCutConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
+#include <TMath.h>
 #include <map>
 #include <string>
 #include <iostream>
 
-EventCutConfig& EventCutConfig::GetInstance() {
-  static EventCutConfig instance;
-  return instance;
+const EventCutConfig& EventCutConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetEventCuts();
 }
 
 EventCutConfig::EventCutConfig() {
@@ -24,6 +25,16 @@ void EventCutConfig::SetDefaults() {
   maxVzDiff = 3.0;
   maxAbsVzVpd = 200.0;
   maxNTr = 0;  // no limit
+  triggers.Parse("");  // all triggers
+}
+
+Bool_t EventCutConfig::Pass(Float_t vz, Float_t vr, Int_t refMult, Float_t vzVpd) const {
+  if (TMath::Abs(vz) > maxVz) return kFALSE;
+  if (vr > maxVr) return kFALSE;
+  if (refMult < minRefMult) return kFALSE;
+  if (refMult > maxRefMult) return kFALSE;
+  if (TMath::Abs(vz - vzVpd) > maxVzDiff && TMath::Abs(vzVpd) < maxAbsVzVpd) return kFALSE;
+  return kTRUE;
 }
 
 Bool_t EventCutConfig::LoadFromFile(const Char_t* filename) {
@@ -60,6 +71,9 @@ Bool_t EventCutConfig::ParseYamlFile(const Char_t* filename) {
   if (values.find("maxNTr") != values.end()) {
     maxNTr = YamlParser::ToInt(values["maxNTr"], maxNTr);
   }
+  if (values.find("triggerIds") != values.end()) {
+    if (!triggers.Parse(values["triggerIds"])) return kFALSE;
+  }
 
   return kTRUE;
 }
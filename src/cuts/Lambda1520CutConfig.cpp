@@ -1,12 +1,12 @@
 #include "cuts/Lambda1520CutConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
 #include <map>
 #include <string>
 #include <iostream>
 
-Lambda1520CutConfig& Lambda1520CutConfig::GetInstance() {
-  static Lambda1520CutConfig instance;
-  return instance;
+const Lambda1520CutConfig& Lambda1520CutConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetLambda1520Cuts();
 }
 
 Lambda1520CutConfig::Lambda1520CutConfig() {
@@ -21,6 +21,9 @@ void Lambda1520CutConfig::SetDefaults() {
   nSigmaKaon = 2.0;
   minInvMass = 1.45;
   maxInvMass = 1.60;
+  maxDCAProton = 2.0;
+  maxDCAKaon = 2.0;
+  fillLikeSign = kTRUE;
 }
 
 Bool_t Lambda1520CutConfig::LoadFromFile(const Char_t* filename) {
@@ -47,6 +50,15 @@ Bool_t Lambda1520CutConfig::ParseYamlFile(const Char_t* filename) {
   if (values.find("maxInvMass") != values.end()) {
     maxInvMass = YamlParser::ToDouble(values["maxInvMass"], maxInvMass);
   }
+  if (values.find("maxDCAProton") != values.end()) {
+    maxDCAProton = YamlParser::ToDouble(values["maxDCAProton"], maxDCAProton);
+  }
+  if (values.find("maxDCAKaon") != values.end()) {
+    maxDCAKaon = YamlParser::ToDouble(values["maxDCAKaon"], maxDCAKaon);
+  }
+  if (values.find("fillLikeSign") != values.end()) {
+    fillLikeSign = YamlParser::ToBool(values["fillLikeSign"], fillLikeSign);
+  }
   
   return kTRUE;
 }
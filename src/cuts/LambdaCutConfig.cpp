@@ -1,12 +1,12 @@
 #include "cuts/LambdaCutConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
 #include <map>
 #include <string>
 #include <iostream>
 
-LambdaCutConfig& LambdaCutConfig::GetInstance() {
-  static LambdaCutConfig instance;
-  return instance;
+const LambdaCutConfig& LambdaCutConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetLambdaCuts();
 }
 
 LambdaCutConfig::LambdaCutConfig() {
@@ -25,6 +25,20 @@ void LambdaCutConfig::SetDefaults() {
   maxDCAV0 = 1.0;
   minCosPointing = 0.995;
   maxPathLength = 100.0;
+  lambdaMassMin = 1.05;
+  lambdaMassMax = 1.25;
+
+  enableLambda = kTRUE;
+  enableAntiLambda = kTRUE;
+  enableK0s = kTRUE;
+
+  nSigmaPionK0s = 2.0;
+  minDCAPionK0s = 0.7;
+  maxDaughterDCAK0s = 1.0;
+  maxDCAV0K0s = 1.0;
+  minCosPointingK0s = 0.995;
+  k0sMassMin = 0.40;
+  k0sMassMax = 0.60;
 }
 
 Bool_t LambdaCutConfig::LoadFromFile(const Char_t* filename) {
@@ -63,6 +77,42 @@ Bool_t LambdaCutConfig::ParseYamlFile(const Char_t* filename) {
   if (values.find("maxPathLength") != values.end()) {
     maxPathLength = YamlParser::ToDouble(values["maxPathLength"], maxPathLength);
   }
+  if (values.find("lambdaMassMin") != values.end()) {
+    lambdaMassMin = YamlParser::ToDouble(values["lambdaMassMin"], lambdaMassMin);
+  }
+  if (values.find("lambdaMassMax") != values.end()) {
+    lambdaMassMax = YamlParser::ToDouble(values["lambdaMassMax"], lambdaMassMax);
+  }
+  if (values.find("enableLambda") != values.end()) {
+    enableLambda = YamlParser::ToBool(values["enableLambda"], enableLambda);
+  }
+  if (values.find("enableAntiLambda") != values.end()) {
+    enableAntiLambda = YamlParser::ToBool(values["enableAntiLambda"], enableAntiLambda);
+  }
+  if (values.find("enableK0s") != values.end()) {
+    enableK0s = YamlParser::ToBool(values["enableK0s"], enableK0s);
+  }
+  if (values.find("nSigmaPionK0s") != values.end()) {
+    nSigmaPionK0s = YamlParser::ToDouble(values["nSigmaPionK0s"], nSigmaPionK0s);
+  }
+  if (values.find("minDCAPionK0s") != values.end()) {
+    minDCAPionK0s = YamlParser::ToDouble(values["minDCAPionK0s"], minDCAPionK0s);
+  }
+  if (values.find("maxDaughterDCAK0s") != values.end()) {
+    maxDaughterDCAK0s = YamlParser::ToDouble(values["maxDaughterDCAK0s"], maxDaughterDCAK0s);
+  }
+  if (values.find("maxDCAV0K0s") != values.end()) {
+    maxDCAV0K0s = YamlParser::ToDouble(values["maxDCAV0K0s"], maxDCAV0K0s);
+  }
+  if (values.find("minCosPointingK0s") != values.end()) {
+    minCosPointingK0s = YamlParser::ToDouble(values["minCosPointingK0s"], minCosPointingK0s);
+  }
+  if (values.find("k0sMassMin") != values.end()) {
+    k0sMassMin = YamlParser::ToDouble(values["k0sMassMin"], k0sMassMin);
+  }
+  if (values.find("k0sMassMax") != values.end()) {
+    k0sMassMax = YamlParser::ToDouble(values["k0sMassMax"], k0sMassMax);
+  }
 
   return kTRUE;
 }
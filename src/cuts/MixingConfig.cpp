@@ -1,12 +1,12 @@
 #include "cuts/MixingConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
 #include <map>
 #include <string>
 #include <iostream>
 
-MixingConfig& MixingConfig::GetInstance() {
-  static MixingConfig instance;
-  return instance;
+const MixingConfig& MixingConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetMixingConfig();
 }
 
 MixingConfig::MixingConfig() {
@@ -1,12 +1,12 @@
 #include "cuts/PIDCutConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
 #include <map>
 #include <string>
 #include <iostream>
 
-PIDCutConfig& PIDCutConfig::GetInstance() {
-  static PIDCutConfig instance;
-  return instance;
+const PIDCutConfig& PIDCutConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetPIDCuts();
 }
 
 PIDCutConfig::PIDCutConfig() {
@@ -1,12 +1,12 @@
 #include "cuts/PhiCutConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
 #include <map>
 #include <string>
 #include <iostream>
 
-PhiCutConfig& PhiCutConfig::GetInstance() {
-  static PhiCutConfig instance;
-  return instance;
+const PhiCutConfig& PhiCutConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetPhiCuts();
 }
 
 PhiCutConfig::PhiCutConfig() {
@@ -24,6 +24,8 @@ void PhiCutConfig::SetDefaults() {
   maxDCAKK = 999.0;
   minInvMass = 0.99;
   maxInvMass = 1.05;
+  minInvMassPre = 0.96;  // hMKK axis range +- 20 MeV
+  maxInvMassPre = 1.20;
   minOpeningAngle = 0.0;
   maxOpeningAngle = 0.5;
   minPairRapidity = -0.8;
@@ -67,6 +69,12 @@ Bool_t PhiCutConfig::ParseYamlFile(const Char_t* filename) {
   if (values.find("maxInvMass") != values.end()) {
     maxInvMass = YamlParser::ToDouble(values["maxInvMass"], maxInvMass);
   }
+  if (values.find("minInvMassPre") != values.end()) {
+    minInvMassPre = YamlParser::ToDouble(values["minInvMassPre"], minInvMassPre);
+  }
+  if (values.find("maxInvMassPre") != values.end()) {
+    maxInvMassPre = YamlParser::ToDouble(values["maxInvMassPre"], maxInvMassPre);
+  }
   if (values.find("minOpeningAngle") != values.end()) {
     minOpeningAngle = YamlParser::ToDouble(values["minOpeningAngle"], minOpeningAngle);
   }
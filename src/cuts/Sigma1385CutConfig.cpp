@@ -1,12 +1,12 @@
 #include "cuts/Sigma1385CutConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
 #include <map>
 #include <string>
 #include <iostream>
 
-Sigma1385CutConfig& Sigma1385CutConfig::GetInstance() {
-  static Sigma1385CutConfig instance;
-  return instance;
+const Sigma1385CutConfig& Sigma1385CutConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetSigma1385Cuts();
 }
 
 Sigma1385CutConfig::Sigma1385CutConfig() {
@@ -22,6 +22,9 @@ void Sigma1385CutConfig::SetDefaults() {
   nSigmaPionForSigma = 2.0;
   minInvMass = 1.30;
   maxInvMass = 1.45;
+  lambdaMassWindow = 0.010;
+  maxDCABachelor = 3.0;
+  maxDCABachelorLambda = 2.0;
 }
 
 Bool_t Sigma1385CutConfig::LoadFromFile(const Char_t* filename) {
@@ -51,6 +54,15 @@ Bool_t Sigma1385CutConfig::ParseYamlFile(const Char_t* filename) {
   if (values.find("maxInvMass") != values.end()) {
     maxInvMass = YamlParser::ToDouble(values["maxInvMass"], maxInvMass);
   }
+  if (values.find("lambdaMassWindow") != values.end()) {
+    lambdaMassWindow = YamlParser::ToDouble(values["lambdaMassWindow"], lambdaMassWindow);
+  }
+  if (values.find("maxDCABachelor") != values.end()) {
+    maxDCABachelor = YamlParser::ToDouble(values["maxDCABachelor"], maxDCABachelor);
+  }
+  if (values.find("maxDCABachelorLambda") != values.end()) {
+    maxDCABachelorLambda = YamlParser::ToDouble(values["maxDCABachelorLambda"], maxDCABachelorLambda);
+  }
   
   return kTRUE;
 }
@@ -1,12 +1,12 @@
 #include "cuts/TrackCutConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
 #include <map>
 #include <string>
 #include <iostream>
 
-TrackCutConfig& TrackCutConfig::GetInstance() {
-  static TrackCutConfig instance;
-  return instance;
+const TrackCutConfig& TrackCutConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetTrackCuts();
 }
 
 TrackCutConfig::TrackCutConfig() {
@@ -25,6 +25,7 @@ void TrackCutConfig::SetDefaults() {
   minPt = 0.2;
   maxPt = 10.0;
   maxChi2 = 3.0;
+  expression = "";
 }
 
 Bool_t TrackCutConfig::LoadFromFile(const Char_t* filename) {
@@ -63,6 +64,14 @@ Bool_t TrackCutConfig::ParseYamlFile(const Char_t* filename) {
   if (values.find("maxChi2") != values.end()) {
     maxChi2 = YamlParser::ToDouble(values["maxChi2"], maxChi2);
   }
+  if (values.find("expression") != values.end()) {
+    expression = values["expression"];
+    // Optional quotes around the expression
+    if (expression.size() >= 2 && (expression[0] == '"' || expression[0] == '\'') &&
+        expression[expression.size() - 1] == expression[0]) {
+      expression = expression.substr(1, expression.size() - 2);
+    }
+  }
   
   return kTRUE;
 }
@@ -1,12 +1,12 @@
 #include "cuts/V0CutConfig.h"
+#include "ConfigManager.h"
 #include "YamlParser.h"
 #include <map>
 #include <string>
 #include <iostream>
 
-V0CutConfig& V0CutConfig::GetInstance() {
-  static V0CutConfig instance;
-  return instance;
+const V0CutConfig& V0CutConfig::GetInstance() {
+  return ConfigManager::GetInstance().GetV0Cuts();
 }
 
 V0CutConfig::V0CutConfig() {